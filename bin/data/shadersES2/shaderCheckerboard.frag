@@ -0,0 +1,38 @@
+precision highp float;
+
+varying vec2 texCoordVarying;
+
+uniform sampler2D tex0;          // This frame's half-width mixer output
+uniform sampler2D previousMixed; // Last frame's reconstructed mixer output
+uniform int hasPrevious;
+uniform float checkerboardPhase; // Same as the mixer's
+uniform vec2 fullSize;           // Pixels
+
+//-------------------------
+// A pixel the mixer shaded this frame: column 2i + row parity went to half-width column i
+vec4 shaded(in vec2 pixel) {
+    vec2 halfSize = vec2(ceil(fullSize.x * 0.5), fullSize.y);
+    return texture2D(tex0, vec2(floor(pixel.x * 0.5) + 0.5, pixel.y + 0.5) / halfSize);
+}
+
+//-------------------------
+void main() {
+    vec2 pixel = floor(gl_FragCoord.xy);
+    if(mod(pixel.x + pixel.y + checkerboardPhase, 2.0) < 0.5) {
+        gl_FragColor = shaded(pixel);
+    } else {
+        // All four neighbours were shaded this frame; at the borders the one inside stands in
+        vec4 left = shaded(vec2(pixel.x > 0.5 ? pixel.x - 1.0 : pixel.x + 1.0, pixel.y));
+        vec4 right = shaded(vec2(pixel.x < fullSize.x - 1.5 ? pixel.x + 1.0 : pixel.x - 1.0, pixel.y));
+        vec4 down = shaded(vec2(pixel.x, pixel.y > 0.5 ? pixel.y - 1.0 : pixel.y + 1.0));
+        vec4 up = shaded(vec2(pixel.x, pixel.y < fullSize.y - 1.5 ? pixel.y + 1.0 : pixel.y - 1.0));
+        if(hasPrevious == 1) {
+            // Last frame's pixel, held to the range of its neighbours so motion doesn't comb
+            vec4 lo = min(min(left, right), min(down, up));
+            vec4 hi = max(max(left, right), max(down, up));
+            gl_FragColor = clamp(texture2D(previousMixed, (pixel + 0.5) / fullSize), lo, hi);
+        } else {
+            gl_FragColor = (left + right + down + up) * 0.25;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+// Uniform matrices
+uniform mat4 modelViewProjectionMatrix;
+
+// Input attributes
+attribute vec4 position;
+attribute vec2 texcoord;
+
+// Output varying
+varying vec2 texCoordVarying;
+
+void main()
+{
+    texCoordVarying = texcoord;
+    gl_Position = modelViewProjectionMatrix * position;
+}
\ No newline at end of file
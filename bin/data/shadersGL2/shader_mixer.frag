@@ -1,9 +1,12 @@
 OF_GLSL_SHADER_HEADER
+#extension GL_ARB_shader_texture_lod : enable
 
 //tex0=external input
 uniform sampler2D tex0;
 //fb = feedback framebuffer
 uniform sampler2D fb;
+//fbOlder = the history frame one older than fb, for fractional delay
+uniform sampler2D fbOlder;
 //temporal filter=previous frame
 uniform sampler2D temporalFilter;
 
@@ -22,6 +25,20 @@ uniform float fbHuexMod;
 uniform float fbHuexOff;
 uniform float fbHuexLfo;
 uniform float temporalFilterResonance;
+uniform float fbDelayFraction;
+uniform int fbMipmaps;
+
+// Echo taps: extra reads from the delay ring, added to the feedback signal
+uniform sampler2D echoTap0;
+uniform sampler2D echoTap1;
+uniform sampler2D echoTap2;
+uniform sampler2D echoTap3;
+uniform int echoTapCount;
+uniform float echoGain[4];
+uniform float echoZoom[4];
+uniform float echoRotate[4];
+uniform float echoHue[4];
+uniform vec2 echoOffset[4];
 
 //switches
 uniform int brightInvert;
@@ -49,6 +66,15 @@ uniform float vHuexMod;
 uniform float vHuexOff;
 uniform float vHuexLfo;
 
+// Checkerboard tier: the target is half width and each row shades every other
+// column, alternating per frame; shaderCheckerboard fills in the rest
+uniform int checkerboard;
+uniform float checkerboardPhase; // 0 or 1
+uniform float checkerboardWidth; // Full width in pixels
+
+// This fragment's coordinate in the full frame
+vec2 uv;
+
 //location
 varying vec2 texCoordVarying;
 
@@ -103,22 +129,51 @@ vec3 hsb2rgb(in vec3 c) {
     return c.z * mix(K.xxx, clamp(p - K.xxx, 0.0, 1.0), c.y);
 }
 
+//--------------------------------------------------------------------
+// Hue rotation in YIQ, cheaper than a round trip through HSB
+vec3 hueShift(in vec3 c, in float turns) {
+    const mat3 toYiq = mat3(0.299, 0.596, 0.211, 0.587, -0.274, -0.523, 0.114, -0.322, 0.312);
+    const mat3 toRgb = mat3(1.0, 1.0, 1.0, 0.956, -0.272, -1.106, 0.621, -0.647, 1.703);
+    vec3 yiq = toYiq * c;
+    float angle = turns * 6.2831853;
+    float s = sin(angle);
+    float co = cos(angle);
+    yiq.yz = vec2(yiq.y * co - yiq.z * s, yiq.y * s + yiq.z * co);
+    return toRgb * yiq;
+}
+
+//--------------------------------------------------------------------
+// One echo tap: its own zoom, rotation and offset around the centre, then hue and gain
+vec3 echoSample(in sampler2D tap, in float gain, in float zoom, in float theta, in vec2 offset, in float hue) {
+    vec2 coord = rotate((uv - vec2(0.5)) * zoom + vec2(0.5) + offset, theta);
+    if(coord.x > 1.0 || coord.y > 1.0 || coord.x < 0.0 || coord.y < 0.0) {
+        return vec3(0.0);
+    }
+    return hueShift(texture2D(tap, coord).rgb, hue) * gain;
+}
+
 //---------------------------------------------------------------------
 void main() {
+    uv = texCoordVarying;
+    if(checkerboard == 1) {
+        float column = 2.0 * floor(gl_FragCoord.x) + mod(floor(gl_FragCoord.y) + checkerboardPhase, 2.0);
+        uv.x = (column + 0.5) / checkerboardWidth;
+    }
+    
     // Initialize output color
     vec4 color = vec4(0.0);
     
     // Sample input textures
-    vec4 input1Color = texture2D(tex0, texCoordVarying);
+    vec4 input1Color = texture2D(tex0, uv);
     vec3 input1ColorHsb = rgb2hsb(input1Color.rgb);
     
     // Video reactive attenuator
     float VVV = input1ColorHsb.z;
     
-    vec4 temporalFilterColor = texture2D(temporalFilter, texCoordVarying);
+    vec4 temporalFilterColor = texture2D(temporalFilter, uv);
     
     // Center coordinates
-    vec2 fbCoord = texCoordVarying - vec2(0.5);
+    vec2 fbCoord = uv - vec2(0.5);
     
     // Apply zoom with optimized calculation
     float zoomFactor = fbZDisplace * (1.0 + vZ * VVV);
@@ -154,8 +209,17 @@ void main() {
         fbCoord = mirrorCoord(fbCoord, vec2(1.0));
     }
     
-    // Sample feedback texture
-    vec4 fbColor = texture2D(fb, fbCoord);
+    // Sample feedback texture. A zoomed-out tap comes with mip levels; the level follows the
+    // zoom rather than derivatives so the toroid and mirror wraps don't blur at their seams
+    vec4 fbColor;
+#ifdef GL_ARB_shader_texture_lod
+    if(fbMipmaps == 1) {
+        fbColor = texture2DLod(fb, fbCoord, log2(max(abs(zoomFactor), 1.0)));
+    } else
+#endif
+    {
+        fbColor = mix(texture2D(fb, fbCoord), texture2D(fbOlder, fbCoord), fbDelayFraction);
+    }
     
     // Clamp coordinates for clean edges
     if(toroidSwitch == 0 && mirrorSwitch == 0) {
@@ -164,6 +228,22 @@ void main() {
         }
     }
     
+    // Add the echo taps, one fetch each
+    vec3 echo = vec3(0.0);
+    if(echoTapCount > 0) {
+        echo += echoSample(echoTap0, echoGain[0], echoZoom[0], echoRotate[0], echoOffset[0], echoHue[0]);
+    }
+    if(echoTapCount > 1 && echoGain[1] != 0.0) {
+        echo += echoSample(echoTap1, echoGain[1], echoZoom[1], echoRotate[1], echoOffset[1], echoHue[1]);
+    }
+    if(echoTapCount > 2 && echoGain[2] != 0.0) {
+        echo += echoSample(echoTap2, echoGain[2], echoZoom[2], echoRotate[2], echoOffset[2], echoHue[2]);
+    }
+    if(echoTapCount > 3 && echoGain[3] != 0.0) {
+        echo += echoSample(echoTap3, echoGain[3], echoZoom[3], echoRotate[3], echoOffset[3], echoHue[3]);
+    }
+    fbColor.rgb = clamp(fbColor.rgb + echo, 0.0, 1.0);
+    
     // Convert to HSB for color manipulation
     vec3 fbColorHsb = rgb2hsb(fbColor.rgb);
     
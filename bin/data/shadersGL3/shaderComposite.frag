@@ -0,0 +1,45 @@
+OF_GLSL_SHADER_HEADER
+
+// Input varying
+in vec2 texCoordVarying;
+
+// Output color
+out vec4 outputColor;
+
+uniform sampler2D tex0;       // Input, full resolution
+uniform sampler2D loopOutput; // Feedback loop output
+uniform sampler2D loopInput;  // The input as the loop mixed it
+
+// The mixer controls that decide how much input it kept
+uniform float fbMix;
+uniform float vMix;
+uniform float lumakey;
+uniform float vLumakey;
+uniform int lumakeyInvertSwitch;
+uniform float temporalFilterMix;
+uniform float vtemporalFilterMix;
+
+// Split resolution: the feedback loop ran at a lower resolution. Swap the
+// input it mixed in for the full-resolution one, at the weight the mixer
+// gave it; feedback, key edges and sharpening stay at loop resolution.
+
+//-------------------------
+void main() {
+    vec4 inputColor = texture(tex0, texCoordVarying);
+    vec4 loopColor = texture(loopOutput, texCoordVarying);
+    vec4 loopInputColor = texture(loopInput, texCoordVarying);
+
+    // The mixer's video reactive attenuator: HSB brightness of the input it saw
+    float VVV = max(max(loopInputColor.r, loopInputColor.g), loopInputColor.b);
+
+    // How much of the input survived the mix, the luma key and the temporal filter
+    float inputWeight = 1.0 - (fbMix + vMix * VVV);
+    float lumakeyValue = lumakey + vLumakey * VVV;
+    if((lumakeyInvertSwitch == 0 && VVV < lumakeyValue) || (lumakeyInvertSwitch != 0 && VVV > lumakeyValue)) {
+        inputWeight = 0.0;
+    }
+    inputWeight *= 1.0 - (temporalFilterMix + vtemporalFilterMix * VVV);
+
+    vec3 color = loopColor.rgb + inputWeight * (inputColor.rgb - loopInputColor.rgb);
+    outputColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+OF_GLSL_SHADER_HEADER
+
+// Input varying
+in vec2 texCoordVarying;
+
+// Output color
+out vec4 outputColor;
+
+uniform sampler2D tex0;  // Output at processing resolution, drawn to the window
+uniform vec2 sourceSize; // Its size in pixels
+uniform float sharpness; // 0..1
+
+//-------------------------
+// Lanczos-2 weight from the squared distance: the polynomial FSR's EASU uses in place of sin()
+float lanczos2(in float d2) {
+    d2 = min(d2, 4.0);
+    float base = 0.4 * d2 - 1.0;
+    float window = 0.25 * d2 - 1.0;
+    return (1.5625 * base * base - 0.5625) * window * window;
+}
+
+//-------------------------
+void main() {
+    vec2 position = texCoordVarying * sourceSize - 0.5;
+    vec2 origin = floor(position);
+    vec2 f = position - origin;
+
+    // 4x4 texels around the sample; the four nearest bound the result so edges don't ring
+    vec4 color = vec4(0.0);
+    float total = 0.0;
+    vec4 lo = vec4(65504.0);
+    vec4 hi = vec4(-65504.0);
+    for(int y = -1; y <= 2; y++) {
+        for(int x = -1; x <= 2; x++) {
+            vec2 offset = vec2(float(x), float(y));
+            vec4 texel = texture(tex0, (origin + offset + 0.5) / sourceSize);
+            vec2 d = offset - f;
+            float w = lanczos2(d.x * d.x) * lanczos2(d.y * d.y);
+            color += texel * w;
+            total += w;
+            if(x >= 0 && x <= 1 && y >= 0 && y <= 1) {
+                lo = min(lo, texel);
+                hi = max(hi, texel);
+            }
+        }
+    }
+    color = clamp(color / total, lo, hi);
+
+    // Sharpen against the bilinear estimate, more where local contrast is low (as CAS/RCAS do),
+    // and limited to the same range so it can't halo
+    vec4 bilinear = texture(tex0, texCoordVarying);
+    vec4 amount = sharpness * sqrt(clamp(min(lo, 1.0 - hi) / max(hi, vec4(0.0001)), 0.0, 1.0));
+    color = clamp(color + (color - bilinear) * amount, lo, hi);
+
+    outputColor = vec4(color.rgb, 1.0);
+}
\ No newline at end of file
@@ -22,7 +22,7 @@ AudioReactivityManager::AudioReactivityManager(ParameterManager* paramManager)
 
     // Additional initialization
     setupDefaultBandRanges();
-    listAudioDevices();
+    // Devices are listed on a startup worker; enumeration can take seconds
 }
 
 AudioReactivityManager::~AudioReactivityManager() {
@@ -116,6 +116,9 @@ void AudioReactivityManager::setupDefaultBandRanges() {
 }
 
 void AudioReactivityManager::update() {
+    if (routesDirty) {
+        updateRoutes();
+    }
     if (!enabled || !paramManager || !fft) return;
 
     // Use mutex to protect FFT data during analysis
@@ -129,8 +132,8 @@ void AudioReactivityManager::update() {
         groupBands();
     }
 
-    // Apply mappings to parameters
-    applyMappings();
+    // Bands feed the modulation matrix; ParameterManager::evaluate() applies the routes
+    paramManager->getModulation().setAudio(smoothedBands.data(), numBands, audioInputLevel);
 }
 
 // Replaced with sputnikMesh version
@@ -188,6 +191,7 @@ void AudioReactivityManager::analyzeAudio() {
 
 void AudioReactivityManager::setEnabled(bool enabled) {
     this->enabled = enabled;
+    routesDirty = true;
 
     // Setup or close audio input based on enabled state
     if (enabled) {
@@ -225,92 +229,54 @@ void AudioReactivityManager::groupBands() {
     }
 }
 
-// Replaced with sputnikMesh version
-void AudioReactivityManager::applyMappings() {
-    for (const auto& mapping : mappings) {
-        if (mapping.band >= 0 && mapping.band < numBands) {
-            // Get the audio band value
-            float value = smoothedBands[mapping.band];
-
-            // Scale and constrain to min/max range (sputnikMesh logic)
-            value = mapping.min + value * mapping.scale * (mapping.max - mapping.min);
-            value = ofClamp(value, mapping.min, mapping.max);
-
-            // Apply to parameter using the existing applyParameterValue method
-            // which handles the parameter ID matching for this project
-            applyParameterValue(mapping.paramId, value, mapping.additive);
-        }
-    }
-}
-
-
-void AudioReactivityManager::applyParameterValue(const std::string& paramId, float value, bool additive) {
-    // Note: The 'additive' flag from settings is now ignored here.
-    // We always call the dedicated offset setters in ParameterManager.
+// Band mappings become GROUP_AUDIO routes in the modulation matrix; rebuilt only when they change
+void AudioReactivityManager::updateRoutes() {
+    routesDirty = false;
     if (!paramManager) return;
 
-    // Match parameter IDs and call the corresponding *offset* setter
-    if (paramId == "lumakey_value" || paramId == "lumakeyValue") {
-        paramManager->setAudioLumakeyValueOffset(value);
-    }
-    else if (paramId == "mix") {
-        paramManager->setAudioMixOffset(value);
-    }
-    else if (paramId == "hue") {
-        paramManager->setAudioHueOffset(value);
-    }
-    else if (paramId == "saturation") {
-        paramManager->setAudioSaturationOffset(value);
-    }
-    else if (paramId == "brightness") {
-        paramManager->setAudioBrightnessOffset(value);
-    }
-    else if (paramId == "temporal_filter_mix" || paramId == "temporalFilterMix") {
-        paramManager->setAudioTemporalFilterMixOffset(value);
-    }
-    else if (paramId == "temporal_filter_resonance" || paramId == "temporalFilterResonance") {
-        paramManager->setAudioTemporalFilterResonanceOffset(value);
-    }
-    else if (paramId == "sharpen_amount" || paramId == "sharpenAmount") {
-        paramManager->setAudioSharpenAmountOffset(value);
-    }
-    else if (paramId == "x_displace" || paramId == "xDisplace") {
-        paramManager->setAudioXDisplaceOffset(value);
-    }
-    else if (paramId == "y_displace" || paramId == "yDisplace") {
-        paramManager->setAudioYDisplaceOffset(value);
-    }
-    else if (paramId == "z_displace" || paramId == "zDisplace") {
-        paramManager->setAudioZDisplaceOffset(value);
-    }
-    else if (paramId == "z_frequency" || paramId == "zFrequency") {
-        paramManager->setAudioZFrequencyOffset(value);
-    }
-    else if (paramId == "x_frequency" || paramId == "xFrequency") {
-        paramManager->setAudioXFrequencyOffset(value);
-    }
-    else if (paramId == "y_frequency" || paramId == "yFrequency") {
-        paramManager->setAudioYFrequencyOffset(value);
-    }
-    else if (paramId == "rotate") {
-        paramManager->setAudioRotateOffset(value);
-    }
-    else if (paramId == "hue_modulation" || paramId == "hueModulation") {
-        paramManager->setAudioHueModulationOffset(value);
-    }
-    else if (paramId == "hue_offset" || paramId == "hueOffset") {
-        // Use the renamed offset setter for hueOffset
-        paramManager->setAudioHueOffsetOffset(value);
+    ModulationMatrix& modulation = paramManager->getModulation();
+    modulation.removeRoutes(ModulationMatrix::GROUP_AUDIO);
+    if (!enabled) {
+        modulation.clearAudio();
+        return; // No routes while disabled, so mapping minimums don't apply
     }
-    else if (paramId == "hue_lfo" || paramId == "hueLFO") {
-        paramManager->setAudioHueLFOOffset(value);
-    }
-    else if (paramId == "delay_amount" || paramId == "delayAmount") {
-        paramManager->setAudioDelayAmountOffset(static_cast<int>(value));
-    }
-    // Note: If new parameters are added for audio reactivity,
-    // ensure corresponding offset variables and setters/getters exist in ParameterManager
-    // and update this function to call the correct offset setter.
+
+    for (const auto& mapping : mappings) {
+        int paramIndex = resolveParameter(mapping.paramId);
+        if (mapping.band < 0 || mapping.band >= std::min(numBands, ModulationMatrix::MAX_AUDIO_BANDS) || paramIndex < 0) {
+            ofLogWarning("AudioReactivityManager") << "Skipping mapping of band " << mapping.band << " to " << mapping.paramId;
+            continue;
+        }
+        // Same curve as before: min + band * scale * (max - min), clamped to min..max
+        modulation.addRoute(ModulationMatrix::GROUP_AUDIO, ModulationMatrix::SOURCE_AUDIO_BAND_1 + mapping.band, paramIndex,
+                            mapping.scale * (mapping.max - mapping.min), false, mapping.min, mapping.min, mapping.max);
+    }
+}
+
+int AudioReactivityManager::resolveParameter(const std::string& paramId) const {
+    // Settings use either parameter IDs or the older snake_case names
+    static const std::map<std::string, int> aliases = {
+        { "lumakey_value", ParameterManager::PARAM_LUMAKEY_VALUE },
+        { "temporal_filter_mix", ParameterManager::PARAM_TEMPORAL_FILTER_MIX },
+        { "temporal_filter_resonance", ParameterManager::PARAM_TEMPORAL_FILTER_RESONANCE },
+        { "sharpen_amount", ParameterManager::PARAM_SHARPEN_AMOUNT },
+        { "x_displace", ParameterManager::PARAM_X_DISPLACE },
+        { "y_displace", ParameterManager::PARAM_Y_DISPLACE },
+        { "z_displace", ParameterManager::PARAM_Z_DISPLACE },
+        { "z_frequency", ParameterManager::PARAM_Z_FREQUENCY },
+        { "x_frequency", ParameterManager::PARAM_X_FREQUENCY },
+        { "y_frequency", ParameterManager::PARAM_Y_FREQUENCY },
+        { "hue_modulation", ParameterManager::PARAM_HUE_MODULATION },
+        { "hue_offset", ParameterManager::PARAM_HUE_OFFSET },
+        { "hue_lfo", ParameterManager::PARAM_HUE_LFO },
+        { "delay_amount", ParameterManager::PARAM_DELAY_AMOUNT }
+    };
+    auto it = aliases.find(paramId);
+    if (it != aliases.end()) {
+        return it->second;
+    }
+    int index = paramManager->findParameterIndex(paramId);
+    return (index >= 0 && !paramManager->isToggleParameter(index)) ? index : -1;
 }
 
 void AudioReactivityManager::listAudioDevices() {
@@ -331,6 +297,9 @@ void AudioReactivityManager::listAudioDevices() {
 
 std::vector<std::string> AudioReactivityManager::getAudioDeviceList() const {
     std::vector<std::string> deviceNames;
+    if (!devicesListed) {
+        return deviceNames;
+    }
     for (const auto& device : deviceList) {
         if (device.inputChannels > 0) {
             deviceNames.push_back(device.name);
@@ -344,6 +313,9 @@ int AudioReactivityManager::getCurrentDeviceIndex() const {
 }
 
 std::string AudioReactivityManager::getCurrentDeviceName() const {
+    if (!devicesListed) {
+        return "Listing devices...";
+    }
     if (currentDeviceIndex >= 0 && currentDeviceIndex < deviceList.size()) {
         return deviceList[currentDeviceIndex].name;
     }
@@ -352,7 +324,7 @@ std::string AudioReactivityManager::getCurrentDeviceName() const {
 
 bool AudioReactivityManager::selectAudioDevice(int deviceIndex) {
     // Check if index is valid
-    if (deviceIndex < 0 || deviceIndex >= deviceList.size() ||
+    if (!devicesListed || deviceIndex < 0 || deviceIndex >= deviceList.size() ||
         deviceList[deviceIndex].inputChannels <= 0) {
         ofLogError("AudioReactivityManager") << "Invalid device index: " << deviceIndex;
         return false;
@@ -377,6 +349,10 @@ bool AudioReactivityManager::selectAudioDevice(int deviceIndex) {
 
 bool AudioReactivityManager::selectAudioDevice(const std::string& deviceName) {
     // Find device by name
+    if (!devicesListed) {
+        preferredDeviceName = deviceName; // Picked up by startInput()
+        return false;
+    }
     for (int i = 0; i < deviceList.size(); i++) {
         if (deviceList[i].name == deviceName && deviceList[i].inputChannels > 0) {
             return selectAudioDevice(i);
@@ -387,7 +363,27 @@ bool AudioReactivityManager::selectAudioDevice(const std::string& deviceName) {
     return false;
 }
 
+void AudioReactivityManager::startInput() {
+    // Device and stream state stay on the render thread; only the enumeration ran on the worker
+    for (int i = 0; i < deviceList.size(); i++) {
+        if (deviceList[i].name == preferredDeviceName && deviceList[i].inputChannels > 0) {
+            currentDeviceIndex = i;
+            break;
+        }
+    }
+    devicesListed = true;
+
+    if (enabled) {
+        setupAudioInput();
+    }
+}
+
 void AudioReactivityManager::setupAudioInput() {
+    if (!devicesListed) {
+        // Opened by startInput() once the devices are known
+        return;
+    }
+
     // Close any existing audio input
     closeAudioInput();
 
@@ -505,6 +501,17 @@ float AudioReactivityManager::getAudioInputLevel() const {
     return audioInputLevel;
 }
 
+size_t AudioReactivityManager::getMemoryBytes() const {
+    size_t floats = audioBuffer.capacity() + fftSpectrum.capacity() + fftSmoothed.capacity() +
+                    bands.capacity() + smoothedBands.capacity();
+    size_t bytes = sizeof(*this) + floats * sizeof(float) + bandRanges.capacity() * sizeof(BandRange) +
+                   mappings.capacity() * sizeof(BandMapping);
+    if (fft) {
+        bytes += bufferSize * 3 * sizeof(float); // ofxFft signal, window and spectrum buffers
+    }
+    return bytes;
+}
+
 bool AudioReactivityManager::isEnabled() const {
     return enabled;
 }
@@ -527,16 +534,19 @@ float AudioReactivityManager::getSmoothing() const {
 
 void AudioReactivityManager::addMapping(const BandMapping& mapping) {
     mappings.push_back(mapping);
+    routesDirty = true;
 }
 
 void AudioReactivityManager::removeMapping(int index) {
     if (index >= 0 && index < mappings.size()) {
         mappings.erase(mappings.begin() + index);
+        routesDirty = true;
     }
 }
 
 void AudioReactivityManager::clearMappings() {
     mappings.clear();
+    routesDirty = true;
 }
 
 std::vector<AudioReactivityManager::BandMapping> AudioReactivityManager::getMappings() const {
@@ -613,7 +623,8 @@ void AudioReactivityManager::loadFromXml(ofxXmlSettings& xml) {
 
         // Device settings
         std::string deviceName = xml.getValue("deviceName", "");
-        if (!deviceName.empty()) {
+        preferredDeviceName = deviceName;
+        if (!deviceName.empty() && devicesListed) {
             selectAudioDevice(deviceName);
         }
 
@@ -704,7 +715,9 @@ void AudioReactivityManager::saveToXml(ofxXmlSettings& xml) const {
         xml.setValue("smoothing", smoothing);
         xml.setValue("numBands", numBands);
 
-        if (currentDeviceIndex >= 0 && currentDeviceIndex < deviceList.size()) {
+        if (!devicesListed) {
+            xml.setValue("deviceName", preferredDeviceName); // Not selected yet, keep the saved choice
+        } else if (currentDeviceIndex >= 0 && currentDeviceIndex < deviceList.size()) {
             xml.setValue("deviceName", deviceList[currentDeviceIndex].name);
             xml.setValue("deviceIndex", currentDeviceIndex);
         }
@@ -4,6 +4,7 @@
 #include "ofxXmlSettings.h"
 #include "ofxFft.h"
 #include "ParameterManager.h"
+#include <atomic>
 #include <mutex>
 #include <memory>
 
@@ -60,6 +61,7 @@ public:
     int getNumBands() const;
     std::vector<float> getAllBands() const;
     float getAudioInputLevel() const;
+    size_t getMemoryBytes() const; // Sample, spectrum and band buffers, for MemoryTracker
     
     // Toggle controls
     void setEnabled(bool enabled);
@@ -76,7 +78,9 @@ public:
     float getSmoothing() const;
     
     // Audio device management
-    void listAudioDevices();
+    void listAudioDevices(); // Startup worker; nothing reads deviceList until startInput() publishes it
+    void startInput();       // Render thread, after listAudioDevices(): select the saved device, open the stream if enabled
+    bool isInputStarted() const { return devicesListed; }
     std::vector<std::string> getAudioDeviceList() const;
     int getCurrentDeviceIndex() const;
     std::string getCurrentDeviceName() const;
@@ -92,7 +96,7 @@ public:
         float scale;            // Scaling factor
         float min;              // Minimum value
         float max;              // Maximum value
-        bool additive;          // Add to (true) or replace (false) parameter value
+        bool additive;          // Kept for settings compatibility; mappings always add
     };
     
     void addMapping(const BandMapping& mapping);
@@ -109,12 +113,11 @@ private:
     // Audio analysis
     void analyzeAudio();
     void groupBands();
-    void applyMappings();
+    void updateRoutes(); // Mappings -> modulation matrix routes
     
     
     // Helper methods
-    float getParameterValue(const std::string& paramId) const;
-    void applyParameterValue(const std::string& paramId, float value, bool additive);
+    int resolveParameter(const std::string& paramId) const; // ParamId, -1 if unknown
     void setupDefaultBandRanges();
     void addDefaultMappings(); // Added declaration for default mappings helper
     
@@ -145,6 +148,8 @@ private:
     ofSoundStream soundStream;
     int currentDeviceIndex;
     std::vector<ofSoundDevice> deviceList;
+    std::atomic<bool> devicesListed{false}; // Set by startInput(); deviceList is only read once this is set
+    std::string preferredDeviceName;        // From settings, selected by startInput()
     bool audioInputInitialized;
     float audioInputLevel;
     
@@ -155,8 +160,9 @@ private:
     };
     std::vector<BandRange> bandRanges;
     
-    // Parameter mappings
+    // Parameter mappings, applied as routes in the parameter manager's modulation matrix
     std::vector<BandMapping> mappings;
+    bool routesDirty = true;
     
     // Reference to parameter manager
     ParameterManager* paramManager;
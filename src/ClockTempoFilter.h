@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * @class ClockTempoFilter
+ * @brief Tempo estimate from MIDI clock intervals
+ *
+ * A moving average over the last beat of intervals smooths USB jitter.
+ * Intervals far outside the current estimate (doubled messages, a stalled
+ * port) are ignored, but a run of them in a row is taken as a real tempo
+ * change, up or down, and the average restarts from there.
+ *
+ * No openFrameworks dependency, so it can be tested on its own.
+ */
+class ClockTempoFilter {
+public:
+    static const int WINDOW = 24;                // Intervals averaged: one beat at 24 PPQN
+    static const int TEMPO_CHANGE_INTERVALS = 6; // Outliers in a row taken as a new tempo, a quarter beat
+
+    explicit ClockTempoFilter(double initialInterval)
+        : interval(initialInterval) {
+        reset();
+    }
+
+    void addInterval(double value) {
+        // Anything is accepted once the average is empty
+        bool plausible = count == 0 || (value < interval * 4.0 && value > interval * 0.25);
+        if (!plausible) {
+            if (++outliers < TEMPO_CHANGE_INTERVALS) {
+                return;
+            }
+            reset(); // Consistently off: the tempo really changed
+        }
+        outliers = 0;
+
+        if (count == WINDOW) {
+            sum -= values[index];
+        } else {
+            count++;
+        }
+        values[index] = value;
+        sum += value;
+        index = (index + 1) % WINDOW;
+        interval = sum / count;
+    }
+
+    void reset() {
+        for (int i = 0; i < WINDOW; i++) {
+            values[i] = 0.0;
+        }
+        count = 0;
+        index = 0;
+        sum = 0.0;
+        outliers = 0;
+    }
+
+    double getInterval() const { return interval; } // Smoothed, in the units given
+
+private:
+    double values[WINDOW];
+    int count = 0;
+    int index = 0;
+    double sum = 0.0;
+    int outliers = 0;     // Consecutive rejected intervals
+    double interval;
+};
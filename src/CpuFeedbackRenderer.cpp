@@ -0,0 +1,596 @@
+#include "CpuFeedbackRenderer.h"
+
+// Vector unit for the per-pixel math; the scalar build is the fallback and reference
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define CPU_RENDERER_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CPU_RENDERER_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define CPU_RENDERER_NEON 1
+#endif
+
+namespace {
+
+// Comparisons return lane masks, consumed by select() and combined with & and |
+#if defined(CPU_RENDERER_AVX2)
+struct Vec {
+    static const int width = 8;
+    __m256 v;
+    Vec() {}
+    Vec(__m256 v) : v(v) {}
+    Vec(float f) : v(_mm256_set1_ps(f)) {}
+    static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    void store(float* p) const { _mm256_storeu_ps(p, v); }
+};
+inline Vec operator+(Vec a, Vec b) { return _mm256_add_ps(a.v, b.v); }
+inline Vec operator-(Vec a, Vec b) { return _mm256_sub_ps(a.v, b.v); }
+inline Vec operator*(Vec a, Vec b) { return _mm256_mul_ps(a.v, b.v); }
+inline Vec operator/(Vec a, Vec b) { return _mm256_div_ps(a.v, b.v); }
+inline Vec vmin(Vec a, Vec b) { return _mm256_min_ps(a.v, b.v); }
+inline Vec vmax(Vec a, Vec b) { return _mm256_max_ps(a.v, b.v); }
+inline Vec vabs(Vec a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v); }
+inline Vec vfloor(Vec a) { return _mm256_floor_ps(a.v); }
+inline Vec operator<(Vec a, Vec b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+inline Vec operator>(Vec a, Vec b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ); }
+inline Vec operator>=(Vec a, Vec b) { return _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ); }
+inline Vec operator&(Vec a, Vec b) { return _mm256_and_ps(a.v, b.v); }
+inline Vec operator|(Vec a, Vec b) { return _mm256_or_ps(a.v, b.v); }
+inline Vec select(Vec mask, Vec a, Vec b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+#elif defined(CPU_RENDERER_SSE2)
+struct Vec {
+    static const int width = 4;
+    __m128 v;
+    Vec() {}
+    Vec(__m128 v) : v(v) {}
+    Vec(float f) : v(_mm_set1_ps(f)) {}
+    static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+};
+inline Vec operator+(Vec a, Vec b) { return _mm_add_ps(a.v, b.v); }
+inline Vec operator-(Vec a, Vec b) { return _mm_sub_ps(a.v, b.v); }
+inline Vec operator*(Vec a, Vec b) { return _mm_mul_ps(a.v, b.v); }
+inline Vec operator/(Vec a, Vec b) { return _mm_div_ps(a.v, b.v); }
+inline Vec vmin(Vec a, Vec b) { return _mm_min_ps(a.v, b.v); }
+inline Vec vmax(Vec a, Vec b) { return _mm_max_ps(a.v, b.v); }
+inline Vec vabs(Vec a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+inline Vec vfloor(Vec a) {
+    // SSE2 has no round-down; truncate, then step back where that rounded up
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)));
+}
+inline Vec operator<(Vec a, Vec b) { return _mm_cmplt_ps(a.v, b.v); }
+inline Vec operator>(Vec a, Vec b) { return _mm_cmpgt_ps(a.v, b.v); }
+inline Vec operator>=(Vec a, Vec b) { return _mm_cmpge_ps(a.v, b.v); }
+inline Vec operator&(Vec a, Vec b) { return _mm_and_ps(a.v, b.v); }
+inline Vec operator|(Vec a, Vec b) { return _mm_or_ps(a.v, b.v); }
+inline Vec select(Vec mask, Vec a, Vec b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+#elif defined(CPU_RENDERER_NEON)
+struct Vec {
+    static const int width = 4;
+    float32x4_t v;
+    Vec() {}
+    Vec(float32x4_t v) : v(v) {}
+    Vec(float f) : v(vdupq_n_f32(f)) {}
+    static Vec load(const float* p) { return vld1q_f32(p); }
+    void store(float* p) const { vst1q_f32(p, v); }
+};
+inline Vec fromMask(uint32x4_t m) { return vreinterpretq_f32_u32(m); }
+inline uint32x4_t toMask(Vec a) { return vreinterpretq_u32_f32(a.v); }
+inline Vec operator+(Vec a, Vec b) { return vaddq_f32(a.v, b.v); }
+inline Vec operator-(Vec a, Vec b) { return vsubq_f32(a.v, b.v); }
+inline Vec operator*(Vec a, Vec b) { return vmulq_f32(a.v, b.v); }
+inline Vec operator/(Vec a, Vec b) {
+#if defined(__aarch64__)
+    return vdivq_f32(a.v, b.v);
+#else
+    // ARMv7 NEON has no divide: reciprocal estimate and two Newton steps
+    float32x4_t r = vrecpeq_f32(b.v);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    r = vmulq_f32(vrecpsq_f32(b.v, r), r);
+    return vmulq_f32(a.v, r);
+#endif
+}
+inline Vec vmin(Vec a, Vec b) { return vminq_f32(a.v, b.v); }
+inline Vec vmax(Vec a, Vec b) { return vmaxq_f32(a.v, b.v); }
+inline Vec vabs(Vec a) { return vabsq_f32(a.v); }
+inline Vec vfloor(Vec a) {
+    float32x4_t t = vcvtq_f32_s32(vcvtq_s32_f32(a.v));
+    return vsubq_f32(t, fromMask(vandq_u32(vcgtq_f32(t, a.v), vreinterpretq_u32_f32(vdupq_n_f32(1.0f)))).v);
+}
+inline Vec operator<(Vec a, Vec b) { return fromMask(vcltq_f32(a.v, b.v)); }
+inline Vec operator>(Vec a, Vec b) { return fromMask(vcgtq_f32(a.v, b.v)); }
+inline Vec operator>=(Vec a, Vec b) { return fromMask(vcgeq_f32(a.v, b.v)); }
+inline Vec operator&(Vec a, Vec b) { return fromMask(vandq_u32(toMask(a), toMask(b))); }
+inline Vec operator|(Vec a, Vec b) { return fromMask(vorrq_u32(toMask(a), toMask(b))); }
+inline Vec select(Vec mask, Vec a, Vec b) { return vbslq_f32(toMask(mask), a.v, b.v); }
+#else
+struct Vec {
+    static const int width = 1;
+    float v;
+    Vec() {}
+    Vec(float f) : v(f) {}
+    static Vec load(const float* p) { return *p; }
+    void store(float* p) const { *p = v; }
+};
+inline Vec operator+(Vec a, Vec b) { return a.v + b.v; }
+inline Vec operator-(Vec a, Vec b) { return a.v - b.v; }
+inline Vec operator*(Vec a, Vec b) { return a.v * b.v; }
+inline Vec operator/(Vec a, Vec b) { return a.v / b.v; }
+inline Vec vmin(Vec a, Vec b) { return std::min(a.v, b.v); }
+inline Vec vmax(Vec a, Vec b) { return std::max(a.v, b.v); }
+inline Vec vabs(Vec a) { return std::fabs(a.v); }
+inline Vec vfloor(Vec a) { return std::floor(a.v); }
+// Masks are 1 or 0 here
+inline Vec operator<(Vec a, Vec b) { return a.v < b.v ? 1.0f : 0.0f; }
+inline Vec operator>(Vec a, Vec b) { return a.v > b.v ? 1.0f : 0.0f; }
+inline Vec operator>=(Vec a, Vec b) { return a.v >= b.v ? 1.0f : 0.0f; }
+inline Vec operator&(Vec a, Vec b) { return std::min(a.v, b.v); }
+inline Vec operator|(Vec a, Vec b) { return std::max(a.v, b.v); }
+inline Vec select(Vec mask, Vec a, Vec b) { return mask.v != 0.0f ? a : b; }
+#endif
+
+const int LANES = Vec::width;
+
+// GLSL built-ins, same definitions as the spec
+inline Vec fract(Vec a) { return a - vfloor(a); }
+inline Vec mod(Vec a, Vec b) { return a - b * vfloor(a / b); }
+inline Vec clamp01(Vec a) { return vmin(vmax(a, 0.0f), 1.0f); }
+inline Vec mix(Vec a, Vec b, Vec t) { return a * (Vec(1.0f) - t) + b * t; }
+
+inline Vec vsin(Vec x) {
+    // Wrap to [-pi, pi], fold into [-pi/2, pi/2], then odd Taylor terms to x^9 (error < 4e-6)
+    const float pi = 3.14159265f;
+    x = x - Vec(TWO_PI) * vfloor((x + pi) * Vec(1.0f / TWO_PI));
+    x = select(x > Vec(HALF_PI), Vec(pi) - x, x);
+    x = select(x < Vec(-HALF_PI), Vec(-pi) - x, x);
+    Vec x2 = x * x;
+    return x * (Vec(1.0f) + x2 * (Vec(-1.0f / 6.0f) + x2 * (Vec(1.0f / 120.0f) +
+                x2 * (Vec(-1.0f / 5040.0f) + x2 * Vec(1.0f / 362880.0f)))));
+}
+
+inline Vec vcos(Vec x) { return vsin(x + Vec(HALF_PI)); }
+
+struct Rgb {
+    Vec r, g, b;
+};
+
+// rgb2hsb() from the shaders, branch-free the same way
+inline Rgb rgbToHsb(const Rgb& c) {
+    Vec gb = c.g >= c.b;
+    Vec px = select(gb, c.g, c.b);
+    Vec py = select(gb, c.b, c.g);
+    Vec pz = select(gb, Vec(0.0f), Vec(-1.0f));
+    Vec pw = select(gb, Vec(-1.0f / 3.0f), Vec(2.0f / 3.0f));
+    Vec rp = c.r >= px;
+    Vec qx = select(rp, c.r, px);
+    Vec qz = select(rp, pz, pw);
+    Vec qw = select(rp, px, c.r);
+    Vec d = qx - vmin(qw, py);
+    const float e = 1.0e-10f;
+    return Rgb{vabs(qz + (qw - py) / (Vec(6.0f) * d + e)), d / (qx + e), qx};
+}
+
+inline Rgb hsbToRgb(const Rgb& c) {
+    Vec pr = vabs(fract(c.r + 1.0f) * 6.0f - 3.0f);
+    Vec pg = vabs(fract(c.r + 2.0f / 3.0f) * 6.0f - 3.0f);
+    Vec pb = vabs(fract(c.r + 1.0f / 3.0f) * 6.0f - 3.0f);
+    Vec one(1.0f);
+    return Rgb{c.b * mix(one, clamp01(pr - one), c.g), c.b * mix(one, clamp01(pg - one), c.g),
+               c.b * mix(one, clamp01(pb - one), c.g)};
+}
+
+inline Vec brightness(const Rgb& c) { return vmax(vmax(c.r, c.g), c.b); } // rgb2hsb(c).z
+
+// Samplers. Lanes are gathered one at a time: texture reads have no useful SIMD form
+// on SSE2/NEON, and the arithmetic around them is where the vectors pay off
+struct Texels {
+    float r[LANES];
+    float g[LANES];
+    float b[LANES];
+    Rgb load() const { return Rgb{Vec::load(r), Vec::load(g), Vec::load(b)}; }
+};
+
+inline void readTexel(const ofPixels& pixels, int x, int y, float& r, float& g, float& b) {
+    size_t channels = pixels.getNumChannels();
+    const unsigned char* p = pixels.getData() + ((size_t)y * pixels.getWidth() + x) * channels;
+    const float scale = 1.0f / 255.0f;
+    r = p[0] * scale;
+    g = p[channels >= 3 ? 1 : 0] * scale;
+    b = p[channels >= 3 ? 2 : 0] * scale;
+}
+
+// GL_LINEAR with GL_CLAMP_TO_EDGE at normalized coordinates
+inline void sampleLinear(const ofPixels& pixels, float u, float v, float& r, float& g, float& b) {
+    int w = (int)pixels.getWidth();
+    int h = (int)pixels.getHeight();
+    float x = std::max(-1.0f, std::min(u, 2.0f)) * w - 0.5f; // Past the edge is the edge anyway
+    float y = std::max(-1.0f, std::min(v, 2.0f)) * h - 0.5f;
+    float fx = std::floor(x);
+    float fy = std::floor(y);
+    float ax = x - fx;
+    float ay = y - fy;
+    int x0 = std::max(0, std::min((int)fx, w - 1));
+    int x1 = std::max(0, std::min((int)fx + 1, w - 1));
+    int y0 = std::max(0, std::min((int)fy, h - 1));
+    int y1 = std::max(0, std::min((int)fy + 1, h - 1));
+
+    float c[4][3];
+    readTexel(pixels, x0, y0, c[0][0], c[0][1], c[0][2]);
+    readTexel(pixels, x1, y0, c[1][0], c[1][1], c[1][2]);
+    readTexel(pixels, x0, y1, c[2][0], c[2][1], c[2][2]);
+    readTexel(pixels, x1, y1, c[3][0], c[3][1], c[3][2]);
+    float out[3];
+    for (int i = 0; i < 3; i++) {
+        float top = c[0][i] + (c[1][i] - c[0][i]) * ax;
+        float bottom = c[2][i] + (c[3][i] - c[2][i]) * ax;
+        out[i] = top + (bottom - top) * ay;
+    }
+    r = out[0];
+    g = out[1];
+    b = out[2];
+}
+
+inline bool isUsable(const ofPixels* pixels) {
+    return pixels && pixels->isAllocated() && pixels->getWidth() > 0 && pixels->getHeight() > 0;
+}
+
+Rgb gather(const ofPixels* pixels, Vec u, Vec v) {
+    if (!isUsable(pixels)) {
+        return Rgb{0.0f, 0.0f, 0.0f};
+    }
+    float us[LANES];
+    float vs[LANES];
+    u.store(us);
+    v.store(vs);
+    Texels texels;
+    for (int i = 0; i < LANES; i++) {
+        sampleLinear(*pixels, us[i], vs[i], texels.r[i], texels.g[i], texels.b[i]);
+    }
+    return texels.load();
+}
+
+// At texel centres of an image the output's size, bilinear filtering is a plain read
+Rgb fetchRow(const ofPixels* pixels, int x, int y, int width, int height, Vec u, Vec v) {
+    if (!isUsable(pixels)) {
+        return Rgb{0.0f, 0.0f, 0.0f};
+    }
+    if ((int)pixels->getWidth() != width || (int)pixels->getHeight() != height) {
+        return gather(pixels, u, v);
+    }
+    Texels texels;
+    for (int i = 0; i < LANES; i++) {
+        readTexel(*pixels, std::min(x + i, width - 1), y, texels.r[i], texels.g[i], texels.b[i]);
+    }
+    return texels.load();
+}
+
+// Unit-range float to 8 bits the way a GL_RGBA8 target stores it
+void storeRow(const Rgb& c, unsigned char* row, int x, int count) {
+    float r[LANES];
+    float g[LANES];
+    float b[LANES];
+    (clamp01(c.r) * 255.0f + 0.5f).store(r);
+    (clamp01(c.g) * 255.0f + 0.5f).store(g);
+    (clamp01(c.b) * 255.0f + 0.5f).store(b);
+    for (int i = 0; i < count; i++) {
+        unsigned char* p = row + (size_t)(x + i) * 4;
+        p[0] = (unsigned char)r[i];
+        p[1] = (unsigned char)g[i];
+        p[2] = (unsigned char)b[i];
+        p[3] = 255;
+    }
+}
+
+// rotate() from the mixer, about the centre of the unit square
+inline void rotate(Vec& x, Vec& y, Vec s, Vec c) {
+    Vec cx = x - 0.5f;
+    Vec cy = y - 0.5f;
+    x = cx * c - cy * s + 0.5f;
+    y = cx * s + cy * c + 0.5f;
+}
+
+inline Vec outsideUnit(Vec x, Vec y) {
+    return (x > Vec(1.0f)) | (y > Vec(1.0f)) | (x < Vec(0.0f)) | (y < Vec(0.0f));
+}
+
+// hueShift() from the mixer: rotation of the chroma plane in YIQ
+inline Rgb hueShift(const Rgb& c, float turns) {
+    Vec y = c.r * 0.299f + c.g * 0.587f + c.b * 0.114f;
+    Vec i = c.r * 0.596f + c.g * -0.274f + c.b * -0.322f;
+    Vec q = c.r * 0.211f + c.g * -0.523f + c.b * 0.312f;
+    float angle = turns * 6.2831853f;
+    Vec s(std::sin(angle));
+    Vec co(std::cos(angle));
+    Vec ri = i * co - q * s;
+    Vec rq = i * s + q * co;
+    return Rgb{y + ri * 0.956f + rq * 0.621f, y + ri * -0.272f + rq * -0.647f, y + ri * -1.106f + rq * 1.703f};
+}
+
+// shader_mixer.frag main() for LANES pixels of row y starting at x
+void mixPixels(const CpuFeedbackRenderer::Sources& src, const CpuFeedbackRenderer::Uniforms& u,
+               int x, int y, int width, int height, unsigned char* row, int count) {
+    float lane[LANES];
+    for (int i = 0; i < LANES; i++) {
+        lane[i] = (float)std::min(x + i, width - 1);
+    }
+    Vec texX = (Vec::load(lane) + 0.5f) * Vec(1.0f / width);
+    Vec texY((y + 0.5f) / height);
+
+    Rgb input = fetchRow(src.input, x, y, width, height, texX, texY);
+    Vec vvv = brightness(input);
+    Rgb temporal = fetchRow(src.temporalFilter, x, y, width, height, texX, texY);
+
+    // Feedback coordinates
+    Vec zoom = Vec(u.fbZDisplace) * (Vec(1.0f) + Vec(u.vZ) * vvv);
+    Vec fx = (texX - 0.5f) * zoom;
+    Vec fy = (texY - 0.5f) * zoom;
+    if (u.horizontalMirror) fx = select(fx > Vec(0.0f), Vec(0.0f) - fx, fx);
+    if (u.verticalMirror) fy = select(fy > Vec(0.0f), Vec(0.0f) - fy, fy);
+    fx = fx + Vec(u.fbXDisplace) + Vec(u.vX) * vvv + 0.5f;
+    fy = fy + Vec(u.fbYDisplace) + Vec(u.vY) * vvv + 0.5f;
+    if (u.vRotate != 0.0f) {
+        Vec theta = Vec(u.fbRotate) + Vec(u.vRotate) * vvv;
+        rotate(fx, fy, vsin(theta), vcos(theta));
+    } else {
+        rotate(fx, fy, std::sin(u.fbRotate), std::cos(u.fbRotate));
+    }
+    if (u.toroid) {
+        fx = select(vabs(fx) > Vec(1.0f), vabs(Vec(1.0f) - fx), fx);
+        fy = select(vabs(fy) > Vec(1.0f), vabs(Vec(1.0f) - fy), fy);
+        fx = fract(fx);
+        fy = fract(fy);
+    }
+    if (u.mirror) {
+        fx = mod(vabs(fx), 2.0f);
+        fy = mod(vabs(fy), 2.0f);
+        fx = select(fx > Vec(1.0f), Vec(1.0f) - mod(fx, 1.0f), fx);
+        fy = select(fy > Vec(1.0f), Vec(1.0f) - mod(fy, 1.0f), fy);
+    }
+
+    Rgb fb = gather(src.fb, fx, fy);
+    if (u.fbDelayFraction > 0.0f && isUsable(src.fbOlder)) {
+        Rgb older = gather(src.fbOlder, fx, fy);
+        fb = Rgb{mix(fb.r, older.r, u.fbDelayFraction), mix(fb.g, older.g, u.fbDelayFraction),
+                 mix(fb.b, older.b, u.fbDelayFraction)};
+    }
+    if (!u.toroid && !u.mirror) {
+        Vec outside = outsideUnit(fx, fy);
+        fb = Rgb{select(outside, 0.0f, fb.r), select(outside, 0.0f, fb.g), select(outside, 0.0f, fb.b)};
+    }
+
+    // Echo taps
+    if (u.echoTapCount > 0) {
+        Rgb echo{0.0f, 0.0f, 0.0f};
+        for (int t = 0; t < std::min(u.echoTapCount, CpuFeedbackRenderer::MAX_ECHO_TAPS); t++) {
+            if ((t > 0 && u.echoGain[t] == 0.0f) || !isUsable(src.echoTaps[t])) {
+                continue;
+            }
+            Vec ex = (texX - 0.5f) * u.echoZoom[t] + 0.5f + u.echoOffset[t * 2];
+            Vec ey = (texY - 0.5f) * u.echoZoom[t] + 0.5f + u.echoOffset[t * 2 + 1];
+            rotate(ex, ey, std::sin(u.echoRotate[t]), std::cos(u.echoRotate[t]));
+            Rgb tap = hueShift(gather(src.echoTaps[t], ex, ey), u.echoHue[t]);
+            Vec gain = select(outsideUnit(ex, ey), 0.0f, u.echoGain[t]);
+            echo = Rgb{echo.r + tap.r * gain, echo.g + tap.g * gain, echo.b + tap.b * gain};
+        }
+        fb = Rgb{clamp01(fb.r + echo.r), clamp01(fb.g + echo.g), clamp01(fb.b + echo.b)};
+    }
+
+    // Hue, saturation and brightness of the feedback
+    Rgb hsb = rgbToHsb(fb);
+    Vec hueEffect = Vec(u.fbHue) * (Vec(1.0f) + Vec(u.vHue) * vvv);
+    Vec lfoPart(0.0f);
+    if (u.fbHuexLfo != 0.0f || u.vHuexLfo != 0.0f) {
+        lfoPart = (Vec(u.fbHuexLfo) + Vec(u.vHuexLfo) * vvv) * vsin(hsb.r * Vec(1.0f / 3.14f));
+    }
+    hsb.r = vabs(hsb.r * hueEffect + lfoPart);
+    hsb.r = fract(mod(hsb.r, Vec(u.fbHuexMod) + Vec(u.vHuexMod) * vvv) + Vec(u.fbHuexOff) + Vec(u.vHuexOff) * vvv);
+    hsb.g = clamp01(hsb.g * u.fbSaturation * (Vec(1.0f) + Vec(u.vSat) * vvv));
+    hsb.b = clamp01(hsb.b * u.fbBright * (Vec(1.0f) + Vec(u.vBright) * vvv));
+    if (u.brightInvert) hsb.b = Vec(1.0f) - hsb.b;
+    if (u.saturationInvert) hsb.g = Vec(1.0f) - hsb.g;
+    if (u.hueInvert) hsb.r = fract(vabs(Vec(1.0f) - hsb.r));
+    fb = hsbToRgb(hsb);
+
+    // Temporal filter resonance
+    Rgb temporalHsb = rgbToHsb(temporal);
+    Vec resonance = Vec(u.temporalFilterResonance) * (Vec(1.0f) + Vec(u.vFb1X) * vvv);
+    temporalHsb.b = clamp01(temporalHsb.b * (Vec(1.0f) + resonance * 0.5f));
+    temporalHsb.g = clamp01(temporalHsb.g * (Vec(1.0f) + resonance * 0.25f));
+    temporal = hsbToRgb(temporalHsb);
+
+    // Mix, key and temporal filter
+    Vec amount = Vec(u.fbMix) + Vec(u.vMix) * vvv;
+    Rgb color{mix(input.r, fb.r, amount), mix(input.g, fb.g, amount), mix(input.b, fb.b, amount)};
+    Vec key = Vec(u.lumakey) + Vec(u.vLumakey) * vvv;
+    Vec keyed = u.lumakeyInvert ? (vvv > key) : (vvv < key);
+    color = Rgb{select(keyed, fb.r, color.r), select(keyed, fb.g, color.g), select(keyed, fb.b, color.b)};
+    Vec temporalAmount = Vec(u.temporalFilterMix) + Vec(u.vTemporalFilterMix) * vvv;
+    color = Rgb{mix(color.r, temporal.r, temporalAmount), mix(color.g, temporal.g, temporalAmount),
+                mix(color.b, temporal.b, temporalAmount)};
+
+    storeRow(color, row, x, count);
+}
+
+// shaderSharpen.frag main() for LANES pixels of row y starting at x
+void sharpenPixels(const ofPixels& mixed, const CpuFeedbackRenderer::Uniforms& u,
+                   int x, int y, int width, int height, unsigned char* row, int count) {
+    float lane[LANES];
+    for (int i = 0; i < LANES; i++) {
+        lane[i] = (float)std::min(x + i, width - 1);
+    }
+    Vec texX = (Vec::load(lane) + 0.5f) * Vec(1.0f / width);
+    Vec texY((y + 0.5f) / height);
+
+    // Same fixed offsets as the shader, in normalized coordinates
+    const float offsetX = 0.003125f;
+    const float offsetY = 0.004166f;
+    Vec around = brightness(gather(&mixed, texX + offsetX, texY + offsetY)) +
+                 brightness(gather(&mixed, texX - offsetX, texY + offsetY)) +
+                 brightness(gather(&mixed, texX - offsetX, texY - offsetY)) +
+                 brightness(gather(&mixed, texX + offsetX, texY - offsetY));
+    around = around * 0.25f;
+
+    Rgb hsb = rgbToHsb(fetchRow(&mixed, x, y, width, height, texX, texY));
+    Vec vvv = hsb.b;
+    hsb.b = hsb.b - (Vec(u.sharpenAmount) + Vec(u.vSharpenAmount) * vvv) * around;
+    if (u.sharpenAmount > 0.0f) {
+        hsb.b = hsb.b * (Vec(1.0f + u.sharpenAmount * 0.45f) + Vec(0.45f * u.vSharpenAmount) * vvv);
+        hsb.g = hsb.g * (Vec(1.0f + u.sharpenAmount * 0.25f) + Vec(0.25f * u.vSharpenAmount) * vvv);
+    }
+    storeRow(hsbToRgb(hsb), row, x, count);
+}
+
+} // namespace
+
+CpuFeedbackRenderer::CpuFeedbackRenderer(int threads) {
+    if (threads <= 0) {
+        threads = std::max(1, std::min(8, (int)std::thread::hardware_concurrency()));
+    }
+    // The calling thread takes tiles too
+    for (int i = 1; i < threads; i++) {
+        workers.emplace_back(&CpuFeedbackRenderer::workerLoop, this);
+    }
+}
+
+CpuFeedbackRenderer::~CpuFeedbackRenderer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void CpuFeedbackRenderer::render(const Sources& sources, const Uniforms& uniforms, int width, int height,
+                                 ofPixels& mixed, ofPixels& output) {
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+    if ((int)mixed.getWidth() != width || (int)mixed.getHeight() != height || mixed.getNumChannels() != 4) {
+        mixed.allocate(width, height, OF_PIXELS_RGBA);
+    }
+    if ((int)output.getWidth() != width || (int)output.getHeight() != height || output.getNumChannels() != 4) {
+        output.allocate(width, height, OF_PIXELS_RGBA);
+    }
+
+    // The sharpen pass reads neighbouring rows of the mixer output, so the passes don't overlap
+    runTiles(height, [&](int first, int last) {
+        for (int y = first; y < last; y++) {
+            unsigned char* row = mixed.getData() + (size_t)y * width * 4;
+            for (int x = 0; x < width; x += LANES) {
+                mixPixels(sources, uniforms, x, y, width, height, row, std::min(LANES, width - x));
+            }
+        }
+    });
+    runTiles(height, [&](int first, int last) {
+        for (int y = first; y < last; y++) {
+            unsigned char* row = output.getData() + (size_t)y * width * 4;
+            for (int x = 0; x < width; x += LANES) {
+                sharpenPixels(mixed, uniforms, x, y, width, height, row, std::min(LANES, width - x));
+            }
+        }
+    });
+}
+
+const char* CpuFeedbackRenderer::getSimdName() {
+#if defined(CPU_RENDERER_AVX2)
+    return "AVX2";
+#elif defined(CPU_RENDERER_SSE2)
+    return "SSE2";
+#elif defined(CPU_RENDERER_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+void CpuFeedbackRenderer::compare(const ofPixels& a, const ofPixels& b, int& maxError, float& meanError) {
+    maxError = 0;
+    meanError = 0.0f;
+    if (a.getWidth() != b.getWidth() || a.getHeight() != b.getHeight() || a.getWidth() == 0 || a.getHeight() == 0) {
+        maxError = 255;
+        meanError = 255.0f;
+        return;
+    }
+    size_t pixels = (size_t)a.getWidth() * a.getHeight();
+    size_t channelsA = a.getNumChannels();
+    size_t channelsB = b.getNumChannels();
+    uint64_t total = 0;
+    for (size_t i = 0; i < pixels; i++) {
+        for (size_t c = 0; c < 3; c++) { // Alpha is 1 on both sides
+            int error = std::abs((int)a.getData()[i * channelsA + std::min(c, channelsA - 1)] -
+                                 (int)b.getData()[i * channelsB + std::min(c, channelsB - 1)]);
+            maxError = std::max(maxError, error);
+            total += error;
+        }
+    }
+    meanError = (float)total / (pixels * 3);
+}
+
+void CpuFeedbackRenderer::runTiles(int height, const std::function<void(int, int)>& job) {
+    if (workers.empty()) {
+        job(0, height);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = job;
+        jobHeight = height;
+        tileCount = (height + tileRows - 1) / tileRows;
+        tilesDone = 0;
+        nextTile = 0;
+        generation++;
+    }
+    wake.notify_all();
+
+    int done = runAvailableTiles();
+    std::unique_lock<std::mutex> lock(mutex);
+    tilesDone += done;
+    // Workers still inside the job keep reading it, so it's only replaced once they've left
+    finished.wait(lock, [this] { return tilesDone == tileCount && activeWorkers == 0; });
+    currentJob = nullptr;
+}
+
+void CpuFeedbackRenderer::workerLoop() {
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            if (nextTile.load() >= tileCount) {
+                continue; // Woke after the others finished this job
+            }
+            activeWorkers++;
+        }
+        int done = runAvailableTiles();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tilesDone += done;
+            activeWorkers--;
+        }
+        finished.notify_all();
+    }
+}
+
+int CpuFeedbackRenderer::runAvailableTiles() {
+    int done = 0;
+    while (true) {
+        int tile = nextTile.fetch_add(1);
+        if (tile >= tileCount) {
+            break;
+        }
+        int first = tile * tileRows;
+        currentJob(first, std::min(first + tileRows, jobHeight));
+        done++;
+    }
+    return done;
+}
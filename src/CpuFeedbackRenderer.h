@@ -0,0 +1,119 @@
+#pragma once
+
+#include "ofMain.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class CpuFeedbackRenderer
+ * @brief Software implementation of the mixer and sharpen passes
+ *
+ * A port of shader_mixer.frag (GL3) and shaderSharpen.frag for machines
+ * without a working GPU driver, and a reference for checking shader
+ * changes against. Sampling follows GL_LINEAR with GL_CLAMP_TO_EDGE on
+ * RGBA8 images, and the intermediate is quantized to 8 bits like the mixer target,
+ * so results match the GPU to within rounding (and the polynomial sine).
+ *
+ * Rows are split into tiles shared between the calling thread and a
+ * worker pool. The per-pixel math runs several pixels at a time with
+ * AVX2, SSE2 or NEON, picked at compile time, with a scalar fallback.
+ *
+ * The renderer holds no history; the caller owns the frames and passes
+ * the ones this frame reads.
+ */
+class CpuFeedbackRenderer {
+public:
+    static const int MAX_ECHO_TAPS = 4;
+
+    // Everything the two shaders take as uniforms, same names without the prefixes
+    struct Uniforms {
+        float lumakey = 0.0f;
+        float fbMix = 0.0f;
+        float fbHue = 1.0f;
+        float fbSaturation = 1.0f;
+        float fbBright = 1.0f;
+        float temporalFilterMix = 0.0f;
+        float temporalFilterResonance = 0.0f;
+        float fbXDisplace = 0.0f;
+        float fbYDisplace = 0.0f;
+        float fbZDisplace = 1.0f;
+        float fbRotate = 0.0f;
+        float fbHuexMod = 1.0f;
+        float fbHuexOff = 0.0f;
+        float fbHuexLfo = 0.0f;
+        float fbDelayFraction = 0.0f;
+        bool brightInvert = false;
+        bool saturationInvert = false;
+        bool hueInvert = false;
+        bool horizontalMirror = false;
+        bool verticalMirror = false;
+        bool toroid = false;
+        bool lumakeyInvert = false;
+        bool mirror = false;
+        float vLumakey = 0.0f;
+        float vMix = 0.0f;
+        float vHue = 0.0f;
+        float vSat = 0.0f;
+        float vBright = 0.0f;
+        float vTemporalFilterMix = 0.0f;
+        float vFb1X = 0.0f;
+        float vX = 0.0f;
+        float vY = 0.0f;
+        float vZ = 0.0f;
+        float vRotate = 0.0f;
+        float vHuexMod = 0.0f;
+        float vHuexOff = 0.0f;
+        float vHuexLfo = 0.0f;
+        int echoTapCount = 0;
+        float echoGain[MAX_ECHO_TAPS] = {};
+        float echoZoom[MAX_ECHO_TAPS] = {};
+        float echoRotate[MAX_ECHO_TAPS] = {};
+        float echoHue[MAX_ECHO_TAPS] = {};
+        float echoOffset[MAX_ECHO_TAPS * 2] = {};
+        float sharpenAmount = 0.0f;
+        float vSharpenAmount = 0.0f;
+    };
+
+    // The images one frame reads; RGBA8. Missing history reads as black
+    struct Sources {
+        const ofPixels* input = nullptr;     // Any size, stretched like the GPU draw
+        const ofPixels* fb = nullptr;
+        const ofPixels* fbOlder = nullptr;
+        const ofPixels* temporalFilter = nullptr;
+        const ofPixels* echoTaps[MAX_ECHO_TAPS] = {};
+    };
+
+    explicit CpuFeedbackRenderer(int threads = 0); // 0 = one per core, up to 8
+    ~CpuFeedbackRenderer();
+
+    // mixed receives the mixer output, output the sharpened frame; both width x height RGBA8
+    void render(const Sources& sources, const Uniforms& uniforms, int width, int height, ofPixels& mixed, ofPixels& output);
+
+    int getThreadCount() const { return (int)workers.size() + 1; }
+    static const char* getSimdName(); // "AVX2", "SSE2", "NEON" or "scalar"
+
+    // Largest and mean per-channel difference between two equally sized images, in 0-255 steps
+    static void compare(const ofPixels& a, const ofPixels& b, int& maxError, float& meanError);
+
+private:
+    void runTiles(int height, const std::function<void(int, int)>& job); // Rows [first, last)
+    void workerLoop();
+    int runAvailableTiles(); // Claims tiles until none are left; returns how many it ran
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    std::function<void(int, int)> currentJob;
+    int tileRows = 16;
+    int tileCount = 0;
+    int jobHeight = 0;
+    std::atomic<int> nextTile{0};
+    int tilesDone = 0;
+    int activeWorkers = 0; // Workers inside runAvailableTiles() for the current job
+    uint64_t generation = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,217 @@
+#include "MemoryTracker.h"
+
+void MemoryTracker::track(const std::string& name, const std::string& subsystem, Kind kind, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    trackLocked(name, subsystem, kind, bytes);
+}
+
+bool MemoryTracker::reserve(const std::string& name, const std::string& subsystem, Kind kind, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (policy != POLICY_WARN && budgets[kind] > 0) {
+        auto it = entries.find(name);
+        size_t replaced = (it != entries.end() && it->second.kind == kind) ? it->second.bytes : 0;
+        if (totals[kind] - replaced + bytes > budgets[kind]) {
+            if (!overBudgetLogged[kind]) {
+                ofLogWarning("MemoryTracker") << "Refused " << name << " (" << toMegabytes(bytes) << " MB): "
+                                              << (kind == GPU ? "GPU" : "CPU") << " budget of "
+                                              << toMegabytes(budgets[kind]) << " MB reached";
+                overBudgetLogged[kind] = true;
+            }
+            return false;
+        }
+    }
+    trackLocked(name, subsystem, kind, bytes);
+    return true;
+}
+
+void MemoryTracker::release(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(name);
+    if (it != entries.end()) {
+        releaseLocked(it);
+    }
+}
+
+void MemoryTracker::releasePrefix(const std::string& prefix) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.lower_bound(prefix);
+    while (it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        auto next = std::next(it);
+        releaseLocked(it);
+        it = next;
+    }
+}
+
+size_t MemoryTracker::getAvailable(Kind kind, const std::string& excludingPrefix) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (budgets[kind] == 0) {
+        return SIZE_MAX;
+    }
+    size_t used = totals[kind];
+    if (!excludingPrefix.empty()) {
+        for (auto it = entries.lower_bound(excludingPrefix);
+             it != entries.end() && it->first.compare(0, excludingPrefix.size(), excludingPrefix) == 0; ++it) {
+            if (it->second.kind == kind) {
+                used -= it->second.bytes;
+            }
+        }
+    }
+    return used < budgets[kind] ? budgets[kind] - used : 0;
+}
+
+size_t MemoryTracker::getTotal(Kind kind) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return totals[kind];
+}
+
+size_t MemoryTracker::getPeak(Kind kind) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peaks[kind];
+}
+
+std::vector<MemoryTracker::SubsystemTotal> MemoryTracker::getSubsystemTotals() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, SubsystemTotal> bySubsystem;
+    for (const auto& entry : entries) {
+        SubsystemTotal& total = bySubsystem[entry.second.subsystem];
+        total.name = entry.second.subsystem;
+        total.bytes[entry.second.kind] += entry.second.bytes;
+    }
+    std::vector<SubsystemTotal> result;
+    for (const auto& total : bySubsystem) {
+        result.push_back(total.second);
+    }
+    return result;
+}
+
+size_t MemoryTracker::getBudget(Kind kind) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return budgets[kind];
+}
+
+void MemoryTracker::setBudget(Kind kind, size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budgets[kind] = bytes;
+    overBudgetLogged[kind] = false;
+}
+
+MemoryTracker::Policy MemoryTracker::getPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return policy;
+}
+
+void MemoryTracker::setPolicy(Policy policy) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->policy = policy;
+}
+
+void MemoryTracker::logReport() const {
+    auto subsystems = getSubsystemTotals();
+    std::lock_guard<std::mutex> lock(mutex);
+    ofLogNotice("MemoryTracker") << "Memory: GPU " << toMegabytes(totals[GPU]) << " MB (peak " << toMegabytes(peaks[GPU])
+                                 << ", budget " << (budgets[GPU] ? ofToString(toMegabytes(budgets[GPU])) + " MB" : "none")
+                                 << "), CPU " << toMegabytes(totals[CPU]) << " MB (peak " << toMegabytes(peaks[CPU])
+                                 << ", budget " << (budgets[CPU] ? ofToString(toMegabytes(budgets[CPU])) + " MB" : "none")
+                                 << "), policy " << getPolicyName(policy);
+    for (const auto& subsystem : subsystems) {
+        ofLogNotice("MemoryTracker") << "  " << subsystem.name << ": GPU " << toMegabytes(subsystem.bytes[GPU])
+                                     << " MB, CPU " << toMegabytes(subsystem.bytes[CPU]) << " MB";
+    }
+}
+
+size_t MemoryTracker::getTextureBytes(int width, int height, int internalFormat) {
+    size_t bytesPerPixel = 4;
+    switch (internalFormat) {
+        case GL_RGB:
+#ifdef GL_RGB8
+        case GL_RGB8:
+#endif
+            bytesPerPixel = 3;
+            break;
+#ifdef GL_RGBA16F
+        case GL_RGBA16F:
+            bytesPerPixel = 8;
+            break;
+#endif
+#ifdef GL_RGBA32F
+        case GL_RGBA32F:
+            bytesPerPixel = 16;
+            break;
+#endif
+#ifdef GL_R8
+        case GL_R8:
+#endif
+#ifdef GL_LUMINANCE
+        case GL_LUMINANCE:
+#endif
+            bytesPerPixel = 1;
+            break;
+        default: // GL_RGBA, GL_RGBA8
+            break;
+    }
+    return (size_t)std::max(width, 0) * std::max(height, 0) * bytesPerPixel;
+}
+
+size_t MemoryTracker::getFboBytes(const ofFboSettings& settings) {
+    size_t color = getTextureBytes(settings.width, settings.height, settings.internalformat) * std::max(settings.numColorbuffers, 1);
+    size_t bytes = color;
+    if (settings.numSamples > 0) {
+        bytes += color * settings.numSamples; // Multisampled renderbuffers, resolved into the textures
+    }
+    if (settings.useDepth || settings.useStencil) {
+        bytes += (size_t)settings.width * settings.height * 4; // 24-bit depth + 8-bit stencil
+    }
+    return bytes;
+}
+
+std::string MemoryTracker::getPolicyName(Policy policy) {
+    switch (policy) {
+        case POLICY_REFUSE: return "refuse";
+        case POLICY_DEGRADE: return "degrade";
+        default: return "warn";
+    }
+}
+
+MemoryTracker::Policy MemoryTracker::findPolicy(const std::string& name) {
+    if (name == "refuse") return POLICY_REFUSE;
+    if (name == "degrade") return POLICY_DEGRADE;
+    return POLICY_WARN;
+}
+
+void MemoryTracker::loadFromXml(ofxXmlSettings& xml) {
+    // Budgets in MB; 0 = unlimited
+    setBudget(GPU, (size_t)(xml.getValue("memory:gpuBudgetMB", 0.0) * 1024 * 1024));
+    setBudget(CPU, (size_t)(xml.getValue("memory:cpuBudgetMB", 0.0) * 1024 * 1024));
+    setPolicy(findPolicy(xml.getValue("memory:policy", getPolicyName(policy))));
+}
+
+void MemoryTracker::saveToXml(ofxXmlSettings& xml) const {
+    xml.setValue("memory:gpuBudgetMB", toMegabytes(getBudget(GPU)));
+    xml.setValue("memory:cpuBudgetMB", toMegabytes(getBudget(CPU)));
+    xml.setValue("memory:policy", getPolicyName(getPolicy()));
+}
+
+void MemoryTracker::trackLocked(const std::string& name, const std::string& subsystem, Kind kind, size_t bytes) {
+    auto it = entries.find(name);
+    if (it != entries.end()) {
+        releaseLocked(it);
+    }
+    entries[name] = Entry{subsystem, kind, bytes};
+    totals[kind] += bytes;
+    peaks[kind] = std::max(peaks[kind], totals[kind]);
+
+    if (budgets[kind] > 0 && totals[kind] > budgets[kind] && !overBudgetLogged[kind]) {
+        ofLogWarning("MemoryTracker") << (kind == GPU ? "GPU" : "CPU") << " memory " << toMegabytes(totals[kind])
+                                      << " MB exceeds the budget of " << toMegabytes(budgets[kind]) << " MB after " << name;
+        overBudgetLogged[kind] = true;
+    }
+}
+
+void MemoryTracker::releaseLocked(std::map<std::string, Entry>::iterator it) {
+    Kind kind = it->second.kind;
+    totals[kind] -= it->second.bytes;
+    entries.erase(it);
+    if (totals[kind] <= budgets[kind]) {
+        overBudgetLogged[kind] = false;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxXmlSettings.h"
+#include <mutex>
+
+/**
+ * @class MemoryTracker
+ * @brief Named accounting of GPU and CPU allocations against optional budgets
+ *
+ * Each allocation is recorded under a unique name ("video.pastFrame.12")
+ * and a subsystem ("video", "input", "audio", "midi"), so totals can be
+ * reported per subsystem. GPU sizes are estimates from dimensions and
+ * internal format; drivers add their own padding.
+ *
+ * With a budget set, the policy decides what happens when an allocation
+ * would exceed it: warn only, refuse optional allocations (reserve()
+ * returns false), or let owners degrade what they allocate (fewer delay
+ * frames, lower resolution) so everything fits.
+ */
+class MemoryTracker {
+public:
+    enum Kind { GPU = 0, CPU, KIND_COUNT };
+    enum Policy { POLICY_WARN = 0, POLICY_REFUSE, POLICY_DEGRADE };
+
+    struct SubsystemTotal {
+        std::string name;
+        size_t bytes[KIND_COUNT] = {};
+    };
+
+    // Record an allocation, replacing any earlier size under the same name
+    void track(const std::string& name, const std::string& subsystem, Kind kind, size_t bytes);
+    // As track(), but only if it fits the budget or the policy is POLICY_WARN; false = refused
+    bool reserve(const std::string& name, const std::string& subsystem, Kind kind, size_t bytes);
+    void release(const std::string& name);
+    void releasePrefix(const std::string& prefix); // e.g. every "video.pastFrame."
+
+    // Bytes left in the budget, not counting entries under excludingPrefix; SIZE_MAX without a budget
+    size_t getAvailable(Kind kind, const std::string& excludingPrefix = "") const;
+    size_t getTotal(Kind kind) const;
+    size_t getPeak(Kind kind) const;
+    std::vector<SubsystemTotal> getSubsystemTotals() const; // Sorted by name
+
+    size_t getBudget(Kind kind) const; // 0 = unlimited
+    void setBudget(Kind kind, size_t bytes);
+    Policy getPolicy() const;
+    void setPolicy(Policy policy);
+
+    void logReport() const;
+
+    // Size estimates
+    static size_t getTextureBytes(int width, int height, int internalFormat);
+    static size_t getFboBytes(const ofFboSettings& settings);
+    static float toMegabytes(size_t bytes) { return bytes / (1024.0f * 1024.0f); }
+
+    static std::string getPolicyName(Policy policy);
+    static Policy findPolicy(const std::string& name); // POLICY_WARN if unknown
+
+    // <memory> settings, read before anything is allocated
+    void loadFromXml(ofxXmlSettings& xml);
+    void saveToXml(ofxXmlSettings& xml) const;
+
+private:
+    struct Entry {
+        std::string subsystem;
+        Kind kind;
+        size_t bytes;
+    };
+
+    void trackLocked(const std::string& name, const std::string& subsystem, Kind kind, size_t bytes);
+    void releaseLocked(std::map<std::string, Entry>::iterator it);
+
+    mutable std::mutex mutex; // Audio and startup threads report too
+    std::map<std::string, Entry> entries;
+    size_t totals[KIND_COUNT] = {};
+    size_t peaks[KIND_COUNT] = {};
+    size_t budgets[KIND_COUNT] = {};
+    bool overBudgetLogged[KIND_COUNT] = {};
+    Policy policy = POLICY_WARN;
+};
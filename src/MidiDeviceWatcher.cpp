@@ -0,0 +1,175 @@
+#include "MidiDeviceWatcher.h"
+
+#if defined(TARGET_LINUX) && __has_include(<alsa/asoundlib.h>)
+    #define MIDI_WATCHER_USE_ALSA 1
+    #include <alsa/asoundlib.h>
+    #include <poll.h>
+#endif
+
+MidiDeviceWatcher::MidiDeviceWatcher() {
+}
+
+MidiDeviceWatcher::~MidiDeviceWatcher() {
+    stop();
+}
+
+void MidiDeviceWatcher::start(ChangeCallback callback) {
+    if (running) {
+        return;
+    }
+    onChange = callback;
+    running = true;
+    scanRequested = true; // Initial enumeration happens on the thread too
+    thread = std::thread(&MidiDeviceWatcher::threadLoop, this);
+}
+
+void MidiDeviceWatcher::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    wakeCondition.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void MidiDeviceWatcher::requestScan() {
+    scanRequested = true;
+    wakeCondition.notify_all();
+}
+
+void MidiDeviceWatcher::threadLoop() {
+    usingPortEvents = openPortEvents();
+    ofLogNotice("MidiDeviceWatcher") << "Watching MIDI devices using "
+                                     << (usingPortEvents ? "ALSA port announcements" : "polling");
+
+    auto lastScan = std::chrono::steady_clock::now();
+    while (running) {
+        bool changed = scanRequested.exchange(false);
+
+        if (!changed) {
+            if (usingPortEvents) {
+                // Short timeout so stop() and requestScan() stay responsive
+                changed = waitForPortEvent(250);
+                if (changed) {
+                    // Devices usually register a client and then its ports
+                    std::this_thread::sleep_for(std::chrono::milliseconds(EVENT_SETTLE_MS));
+                    waitForPortEvent(0);
+                }
+            } else {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCondition.wait_for(lock, std::chrono::milliseconds(250));
+                float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - lastScan).count();
+                changed = elapsed >= POLL_INTERVAL;
+            }
+            changed = changed || scanRequested.exchange(false);
+        }
+
+        if (changed && running) {
+            scan();
+            lastScan = std::chrono::steady_clock::now();
+        }
+    }
+
+    closePortEvents();
+}
+
+void MidiDeviceWatcher::scan() {
+    std::vector<std::string> devices;
+    try {
+        devices = scanner.getInPortList();
+    } catch (const std::exception& e) {
+        ofLogError("MidiDeviceWatcher") << "Failed to enumerate MIDI devices: " << e.what();
+        return;
+    }
+
+    if (hasScanned && devices == lastDevices) {
+        return; // Nothing to report
+    }
+    hasScanned = true;
+    lastDevices = devices;
+
+    ofLogNotice("MidiDeviceWatcher") << "Found " << devices.size() << " MIDI devices:";
+    for (size_t i = 0; i < devices.size(); i++) {
+        ofLogNotice("MidiDeviceWatcher") << i << ": " << devices[i];
+    }
+
+    if (onChange) {
+        onChange(devices);
+    }
+}
+
+#ifdef MIDI_WATCHER_USE_ALSA
+
+bool MidiDeviceWatcher::openPortEvents() {
+    snd_seq_t* seq = nullptr;
+    if (snd_seq_open(&seq, "default", SND_SEQ_OPEN_INPUT, SND_SEQ_NONBLOCK) < 0) {
+        ofLogWarning("MidiDeviceWatcher") << "Could not open ALSA sequencer, falling back to polling";
+        return false;
+    }
+    snd_seq_set_client_name(seq, "nievePool device watcher");
+
+    int port = snd_seq_create_simple_port(seq, "announce",
+        SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE | SND_SEQ_PORT_CAP_NO_EXPORT,
+        SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+    if (port < 0 || snd_seq_connect_from(seq, port, SND_SEQ_CLIENT_SYSTEM, SND_SEQ_PORT_SYSTEM_ANNOUNCE) < 0) {
+        ofLogWarning("MidiDeviceWatcher") << "Could not subscribe to ALSA announcements, falling back to polling";
+        snd_seq_close(seq);
+        return false;
+    }
+
+    sequencer = seq;
+    return true;
+}
+
+void MidiDeviceWatcher::closePortEvents() {
+    if (sequencer) {
+        snd_seq_close(static_cast<snd_seq_t*>(sequencer));
+        sequencer = nullptr;
+    }
+}
+
+bool MidiDeviceWatcher::waitForPortEvent(int timeoutMs) {
+    snd_seq_t* seq = static_cast<snd_seq_t*>(sequencer);
+
+    int count = snd_seq_poll_descriptors_count(seq, POLLIN);
+    std::vector<struct pollfd> fds(count);
+    snd_seq_poll_descriptors(seq, fds.data(), count, POLLIN);
+    if (poll(fds.data(), count, timeoutMs) <= 0) {
+        return false;
+    }
+
+    // Drain everything queued; any client/port change means a rescan
+    bool changed = false;
+    snd_seq_event_t* event = nullptr;
+    while (snd_seq_event_input(seq, &event) >= 0 && event) {
+        switch (event->type) {
+            case SND_SEQ_EVENT_CLIENT_START:
+            case SND_SEQ_EVENT_CLIENT_EXIT:
+            case SND_SEQ_EVENT_PORT_START:
+            case SND_SEQ_EVENT_PORT_EXIT:
+            case SND_SEQ_EVENT_PORT_CHANGE:
+                changed = true;
+                break;
+            default:
+                break;
+        }
+    }
+    return changed;
+}
+
+#else
+
+bool MidiDeviceWatcher::openPortEvents() {
+    return false;
+}
+
+void MidiDeviceWatcher::closePortEvents() {
+}
+
+bool MidiDeviceWatcher::waitForPortEvent(int timeoutMs) {
+    return false;
+}
+
+#endif
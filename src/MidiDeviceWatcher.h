@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMidi.h"
+
+/**
+ * @class MidiDeviceWatcher
+ * @brief Enumerates MIDI input ports on a background thread
+ *
+ * Port enumeration goes through the ALSA sequencer on Linux and can take long
+ * enough to drop a frame, so it never runs on the render thread. On Linux the
+ * watcher subscribes to the sequencer's announce port and rescans only when a
+ * client or port appears or disappears; elsewhere (or if ALSA is unavailable)
+ * it falls back to polling. The callback fires on the watcher thread, and only
+ * when the device list actually changed.
+ */
+class MidiDeviceWatcher {
+public:
+    typedef std::function<void(const std::vector<std::string>&)> ChangeCallback;
+
+    MidiDeviceWatcher();
+    ~MidiDeviceWatcher();
+
+    void start(ChangeCallback callback);
+    void stop();
+
+    // Ask for a rescan without waiting for a port event or the poll interval
+    void requestScan();
+
+    bool isUsingPortEvents() const { return usingPortEvents; }
+
+private:
+    static constexpr float POLL_INTERVAL = 2.0f;      // Seconds, fallback when no port events
+    static constexpr int EVENT_SETTLE_MS = 200;       // Coalesce bursts of port events
+
+    void threadLoop();
+    void scan();
+
+    // Port event source; false if unavailable on this platform
+    bool openPortEvents();
+    void closePortEvents();
+    bool waitForPortEvent(int timeoutMs); // true if ports changed
+
+    ofxMidiIn scanner; // Separate client so enumeration never touches the open input
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> scanRequested{false};
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+
+    ChangeCallback onChange;
+    std::vector<std::string> lastDevices;
+    bool hasScanned = false;
+
+    bool usingPortEvents = false;
+    void* sequencer = nullptr; // snd_seq_t* on Linux
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMidi.h"
+
+/**
+ * @struct MidiEvent
+ * @brief Compact, trivially copyable MIDI message with its arrival time
+ *
+ * Channel messages keep their 1-16 channel; data1 is the control/note number
+ * (or LSB for song position) and data2 the value/velocity (or MSB).
+ */
+struct MidiEvent {
+    uint64_t timeMicros = 0; // ofGetElapsedTimeMicros() when the message arrived
+    int status = MIDI_UNKNOWN;
+    int channel = 0;
+    int data1 = 0;
+    int data2 = 0;
+    int portNum = 0;
+
+    static MidiEvent fromMessage(const ofxMidiMessage& message, uint64_t timeMicros) {
+        MidiEvent event;
+        event.timeMicros = timeMicros;
+        event.status = message.status;
+        event.channel = message.channel;
+        event.portNum = message.portNum;
+        switch (message.status) {
+            case MIDI_CONTROL_CHANGE:
+                event.data1 = message.control;
+                event.data2 = message.value;
+                break;
+            case MIDI_NOTE_ON:
+            case MIDI_NOTE_OFF:
+                event.data1 = message.pitch;
+                event.data2 = message.velocity;
+                break;
+            default:
+                event.data1 = message.bytes.size() > 1 ? message.bytes[1] : 0;
+                event.data2 = message.bytes.size() > 2 ? message.bytes[2] : 0;
+                break;
+        }
+        return event;
+    }
+};
+
+/**
+ * @class MidiEventRing
+ * @brief Fixed-capacity single-producer/single-consumer lock-free ring
+ *
+ * The MIDI input callback is the only producer and the render thread the only
+ * consumer. Neither side blocks or allocates; when the ring is full new events
+ * are dropped and counted.
+ */
+template <typename T, size_t Capacity>
+class MidiEventRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    // Producer side
+    bool push(const T& item) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) >= Capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[head & (Capacity - 1)] = item;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = slots[tail & (Capacity - 1)];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    T slots[Capacity];
+    // Separate cache lines so producer and consumer don't contend
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+    std::atomic<size_t> dropped{0};
+};
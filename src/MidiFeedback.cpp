@@ -0,0 +1,201 @@
+#include "MidiFeedback.h"
+
+MidiFeedback::MidiFeedback() {
+}
+
+MidiFeedback::~MidiFeedback() {
+    stop();
+}
+
+void MidiFeedback::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    thread = std::thread(&MidiFeedback::threadLoop, this);
+}
+
+void MidiFeedback::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    pendingCondition.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    if (midiOut.isOpen()) {
+        midiOut.closePort();
+    }
+    portOpen = false;
+}
+
+void MidiFeedback::setOutputPort(const std::string& portName) {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        requestedPort = portName;
+        portRequested = true;
+    }
+    pendingCondition.notify_all();
+}
+
+int MidiFeedback::makeKey(Kind kind, int channel, int number) {
+    // CC and 14-bit CC share the controller's knob, NRPNs have their own space
+    if (kind == KIND_NRPN) {
+        return (1 << 20) | ((channel - 1) << 14) | (number & 0x3FFF);
+    }
+    return ((channel - 1) << 7) | (number & 0x7F);
+}
+
+int MidiFeedback::messageCost(Kind kind) {
+    switch (kind) {
+        case KIND_CC14: return 2; // MSB + LSB
+        case KIND_NRPN: return 4; // Parameter select MSB/LSB + data entry MSB/LSB
+        case KIND_CC:
+        default: return 1;
+    }
+}
+
+void MidiFeedback::setValue(Kind kind, int channel, int number, int value, uint64_t nowMicros) {
+    if (!isActive()) {
+        return;
+    }
+    if (resendRequested.exchange(false)) {
+        controls.clear(); // New port: the controller doesn't know any values yet
+    }
+
+    ControlState& state = controls[makeKey(kind, channel, number)];
+    if (value == state.lastQueued || nowMicros < state.holdUntil) {
+        return;
+    }
+    state.lastQueued = value;
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        int key = makeKey(kind, channel, number);
+        auto it = pendingValues.find(key);
+        if (it == pendingValues.end()) {
+            pendingOrder.push_back(key);
+            pendingValues[key] = Pending{ kind, channel, number, value };
+        } else {
+            it->second.value = value; // Not sent yet, just update it
+        }
+    }
+    pendingCondition.notify_one();
+}
+
+void MidiFeedback::holdControl(Kind kind, int channel, int number, uint64_t nowMicros) {
+    ControlState& state = controls[makeKey(kind, channel, number)];
+    state.holdUntil = nowMicros + HOLD_MICROS;
+    state.lastQueued = -1; // Send the settled value once the hold expires
+}
+
+void MidiFeedback::resendAll() {
+    controls.clear();
+}
+
+void MidiFeedback::threadLoop() {
+    auto lastRefill = std::chrono::steady_clock::now();
+
+    while (running) {
+        Pending message;
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex);
+            pendingCondition.wait_for(lock, std::chrono::milliseconds(100), [this] {
+                return !running || portRequested || !pendingOrder.empty();
+            });
+            if (!running) {
+                break;
+            }
+            if (portRequested) {
+                lock.unlock();
+                openRequestedPort();
+                continue;
+            }
+            if (pendingOrder.empty()) {
+                continue;
+            }
+
+            // Refill the bucket; wait outside the lock if the next message doesn't fit
+            auto now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+            lastRefill = now;
+            tokens = std::min<double>(BURST_MESSAGES, tokens + elapsed * messagesPerSecond);
+
+            const Pending& next = pendingValues[pendingOrder.front()];
+            int cost = messageCost(next.kind);
+            if (tokens < cost) {
+                double waitSeconds = (cost - tokens) / messagesPerSecond;
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::duration<double>(waitSeconds));
+                continue;
+            }
+            tokens -= cost;
+
+            message = next;
+            pendingValues.erase(pendingOrder.front());
+            pendingOrder.pop_front();
+        }
+
+        send(message);
+    }
+}
+
+void MidiFeedback::openRequestedPort() {
+    std::string portName;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        portName = requestedPort;
+        portRequested = false;
+
+        // Anything queued was meant for the previous port
+        pendingOrder.clear();
+        pendingValues.clear();
+    }
+
+    if (midiOut.isOpen()) {
+        midiOut.closePort();
+        portOpen = false;
+        ofLogNotice("MidiFeedback") << "Closed MIDI feedback output";
+    }
+    if (portName.empty()) {
+        return;
+    }
+
+    try {
+        std::vector<std::string> ports = midiOut.getOutPortList();
+        if (std::find(ports.begin(), ports.end(), portName) == ports.end()) {
+            ofLogNotice("MidiFeedback") << "No MIDI output named '" << portName << "', feedback disabled";
+            return;
+        }
+        portOpen = midiOut.openPort(portName);
+        resendRequested = portOpen.load();
+        ofLogNotice("MidiFeedback") << (portOpen ? "Sending feedback to " : "Failed to open ") << portName;
+    } catch (const std::exception& e) {
+        ofLogError("MidiFeedback") << "Failed to open MIDI output: " << e.what();
+        portOpen = false;
+    }
+}
+
+void MidiFeedback::send(const Pending& message) {
+    if (!portOpen) {
+        return;
+    }
+
+    switch (message.kind) {
+        case KIND_CC:
+            midiOut.sendControlChange(message.channel, message.number, message.value);
+            break;
+        case KIND_CC14:
+            midiOut.sendControlChange(message.channel, message.number, message.value >> 7);
+            midiOut.sendControlChange(message.channel, message.number + 32, message.value & 0x7F);
+            break;
+        case KIND_NRPN:
+            midiOut.sendControlChange(message.channel, 99, message.number >> 7);
+            midiOut.sendControlChange(message.channel, 98, message.number & 0x7F);
+            midiOut.sendControlChange(message.channel, 6, message.value >> 7);
+            midiOut.sendControlChange(message.channel, 38, message.value & 0x7F);
+            break;
+    }
+    sentCount++;
+}
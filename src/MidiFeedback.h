@@ -0,0 +1,92 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMidi.h"
+
+/**
+ * @class MidiFeedback
+ * @brief Mirrors parameter values back to the controller's LEDs and motor faders
+ *
+ * MidiManager calls setValue() every frame for each mapped control. Only
+ * values that changed since they were last queued are passed on, and newer
+ * values replace older ones still waiting to go out. A dedicated thread sends
+ * them through ofxMidiOut, limited by a token bucket so playback never
+ * saturates the MIDI link. A control the user is moving is held for a short
+ * time so motor faders don't fight the hand on them.
+ */
+class MidiFeedback {
+public:
+    enum Kind { KIND_CC, KIND_CC14, KIND_NRPN };
+
+    MidiFeedback();
+    ~MidiFeedback();
+
+    void start();
+    void stop();
+
+    // Open the output port by name on the sender thread; empty closes it
+    void setOutputPort(const std::string& portName);
+    bool isActive() const { return enabled && portOpen; }
+
+    // Render thread
+    void setValue(Kind kind, int channel, int number, int value, uint64_t nowMicros); // 7 or 14-bit value
+    void holdControl(Kind kind, int channel, int number, uint64_t nowMicros);         // Incoming from the controller
+    void resendAll(); // Forget what was sent, e.g. after a mapping change
+
+    // Settings
+    bool isEnabled() const { return enabled; }
+    void setEnabled(bool enable) { enabled = enable; }
+    int getChannel() const { return channel; }
+    void setChannel(int ch) { channel = ofClamp(ch, 1, 16); } // Channel for omni mappings
+    float getRate() const { return messagesPerSecond; }
+    void setRate(float rate) { messagesPerSecond = std::max(10.0f, rate); }
+    size_t getSentCount() const { return sentCount; }
+
+private:
+    static constexpr uint64_t HOLD_MICROS = 300000; // Ignore feedback while a control is being moved
+    static constexpr int BURST_MESSAGES = 32;       // Token bucket depth
+
+    struct Pending {
+        Kind kind;
+        int channel;
+        int number;
+        int value;
+    };
+
+    struct ControlState {
+        int lastQueued = -1;
+        uint64_t holdUntil = 0;
+    };
+
+    static int makeKey(Kind kind, int channel, int number);
+    static int messageCost(Kind kind);
+
+    void threadLoop();
+    void openRequestedPort();
+    void send(const Pending& message);
+
+    // Render thread state
+    std::unordered_map<int, ControlState> controls;
+
+    // Shared with the sender thread; latest value per control wins
+    std::mutex pendingMutex;
+    std::condition_variable pendingCondition;
+    std::deque<int> pendingOrder;
+    std::unordered_map<int, Pending> pendingValues;
+    std::string requestedPort;
+    bool portRequested = false;
+
+    // Sender thread
+    ofxMidiOut midiOut;
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> portOpen{false};
+    std::atomic<bool> resendRequested{false}; // Set when a port opens, cleared by the render thread
+    std::atomic<size_t> sentCount{0};
+    double tokens = BURST_MESSAGES;
+
+    // Settings
+    std::atomic<bool> enabled{true};
+    int channel = 1;
+    std::atomic<float> messagesPerSecond{300.0f};
+};
@@ -2,57 +2,99 @@
 
 MidiManager::MidiManager(ParameterManager* paramManager)
     : paramManager(paramManager) {
+    activeGlides.reserve(ParameterManager::PARAM_COUNT);
 }
 
 MidiManager::~MidiManager() {
+    deviceWatcher.stop();
+    feedback.stop();
     disconnectCurrentDevice();
     midiIn.removeListener(this);
 }
 
 void MidiManager::setup() {
-    // List available devices
-    midiIn.listInPorts();
-    
     // Register as MIDI listener
     midiIn.addListener(this);
     
-    // Scan for devices
-    scanForDevices();
+    // Compile mappings loaded by ParameterManager
+    rebuildMappings();
     
-    // Try to connect to first available device
-    if (!availableDevices.empty()) {
-        connectToDevice(0);
+    // Feedback sender runs on its own thread
+    feedback.start();
+    if (!feedbackPortName.empty()) {
+        feedback.setOutputPort(feedbackPortName);
     }
+    
+    // Enumerate devices in the background; the first result connects a device
+    deviceWatcher.start([this](const std::vector<std::string>& devices) {
+        onDevicesChanged(devices);
+    });
 }
 
 void MidiManager::update() {
-    // Check for device changes periodically
-    float currentTime = ofGetElapsedTimef();
-    if (currentTime - lastDeviceScanTime > DEVICE_SCAN_INTERVAL) {
-        scanForDevices();
-        lastDeviceScanTime = currentTime;
-    }
+    // Apply queued MIDI input on the render thread
+    processEvents();
+    
+    // Advance MIDI value interpolation at frame rate
+    updateGlides(ofGetLastFrameTime());
+    
+    // Mirror the resulting values back to the controller
+    updateFeedback();
 }
 
 void MidiManager::scanForDevices() {
-    // Get list of available MIDI devices
-    availableDevices = midiIn.getInPortList();
-    
-    // Log the found devices
-    ofLogNotice("MidiManager") << "Found " << availableDevices.size() << " MIDI devices:";
-    for (size_t i = 0; i < availableDevices.size(); i++) {
-        ofLogNotice("MidiManager") << i << ": " << availableDevices[i];
+    // Non-blocking; results arrive through onDevicesChanged()
+    deviceWatcher.requestScan();
+}
+
+void MidiManager::onDevicesChanged(const std::vector<std::string>& devices) {
+    // Called on the watcher thread, so connecting here never stalls a frame
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    std::string connectedName = isDeviceConnected && currentDeviceIndex >= 0 && currentDeviceIndex < availableDevices.size()
+        ? availableDevices[currentDeviceIndex] : "";
+    availableDevices = devices;
+
+    // Re-resolve the open device's index, or drop it if it was unplugged
+    if (isDeviceConnected) {
+        auto it = std::find(devices.begin(), devices.end(), connectedName);
+        if (it == devices.end()) {
+            ofLogNotice("MidiManager") << "MIDI device removed: " << connectedName;
+            closeDeviceLocked();
+        } else {
+            currentDeviceIndex = static_cast<int>(it - devices.begin());
+        }
+    }
+
+    selectDeviceLocked();
+}
+
+void MidiManager::selectDeviceLocked() {
+    // Prefer the saved device; otherwise keep the current one or take the first
+    bool hasPreferred = !preferredDeviceName.empty() && preferredDeviceName != "Not connected";
+    auto preferred = hasPreferred
+        ? std::find(availableDevices.begin(), availableDevices.end(), preferredDeviceName)
+        : availableDevices.end();
+    int preferredIndex = static_cast<int>(preferred - availableDevices.begin());
+    if (preferred != availableDevices.end() && (!isDeviceConnected || currentDeviceIndex != preferredIndex)) {
+        openDeviceLocked(preferredIndex);
+    } else if (!isDeviceConnected && !availableDevices.empty()) {
+        openDeviceLocked(0);
     }
 }
 
 bool MidiManager::connectToDevice(int deviceIndex) {
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    return openDeviceLocked(deviceIndex);
+}
+
+bool MidiManager::openDeviceLocked(int deviceIndex) {
     if (deviceIndex < 0 || deviceIndex >= availableDevices.size()) {
         ofLogError("MidiManager") << "Invalid device index: " << deviceIndex;
         return false;
     }
     
     // Disconnect from current device if connected
-    disconnectCurrentDevice();
+    closeDeviceLocked();
     
     // Try to open the device
     try {
@@ -64,6 +106,11 @@ bool MidiManager::connectToDevice(int deviceIndex) {
         // Don't ignore MIDI messages
         midiIn.ignoreTypes(false, false, false);
         
+        // Controllers usually expose an output with the same name
+        if (feedbackPortName.empty()) {
+            feedback.setOutputPort(availableDevices[deviceIndex]);
+        }
+        
         return true;
     } catch (const std::exception& e) {
         ofLogError("MidiManager") << "Failed to connect to MIDI device: " << e.what();
@@ -72,9 +119,10 @@ bool MidiManager::connectToDevice(int deviceIndex) {
 }
 
 bool MidiManager::connectToDevice(const std::string& deviceName) {
+    std::lock_guard<std::mutex> lock(deviceMutex);
     for (size_t i = 0; i < availableDevices.size(); i++) {
         if (availableDevices[i] == deviceName) {
-            return connectToDevice(i);
+            return openDeviceLocked(i);
         }
     }
     
@@ -83,8 +131,16 @@ bool MidiManager::connectToDevice(const std::string& deviceName) {
 }
 
 void MidiManager::disconnectCurrentDevice() {
+    std::lock_guard<std::mutex> lock(deviceMutex);
+    closeDeviceLocked();
+}
+
+void MidiManager::closeDeviceLocked() {
     if (isDeviceConnected) {
         midiIn.closePort();
+        if (feedbackPortName.empty()) {
+            feedback.setOutputPort("");
+        }
         isDeviceConnected = false;
         currentDeviceIndex = -1;
         ofLogNotice("MidiManager") << "Disconnected from MIDI device";
@@ -92,29 +148,83 @@ void MidiManager::disconnectCurrentDevice() {
 }
 
 void MidiManager::newMidiMessage(ofxMidiMessage& message) {
-    // Add to message queue
-    midiMessages.push_back(message);
-    
-    // Remove old messages if queue is too long
-    while (midiMessages.size() > maxMessages) {
-        midiMessages.erase(midiMessages.begin());
+    // MIDI input thread: timestamp and hand off, never process here
+    eventRing.push(MidiEvent::fromMessage(message, ofGetElapsedTimeMicros()));
+}
+
+void MidiManager::processEvents() {
+    // Render thread: drain everything that arrived since the last frame, in order
+    MidiEvent event;
+    Transport& transport = paramManager->getTransport();
+    while (eventRing.pop(event)) {
+        // Realtime messages drive the transport and stay out of the history
+        switch (event.status) {
+            case MIDI_TIME_CLOCK:
+                transport.clock(event.timeMicros);
+                continue;
+            case MIDI_START:
+                transport.start();
+                continue;
+            case MIDI_CONTINUE:
+                transport.resume();
+                continue;
+            case MIDI_STOP:
+                transport.stop();
+                continue;
+            case MIDI_SONG_POS_POINTER:
+                transport.setSongPosition((event.data2 << 7) | event.data1);
+                continue;
+            default:
+                break;
+        }
+
+        recentEvents[recentHead] = event;
+        recentHead = (recentHead + 1) % MAX_RECENT_EVENTS;
+        recentCount = std::min(recentCount + 1, MAX_RECENT_EVENTS);
+
+        if (event.status == MIDI_CONTROL_CHANGE) {
+            processControlChange(event);
+        } else if (event.status == MIDI_NOTE_ON || event.status == MIDI_NOTE_OFF) {
+            processNote(event);
+        } else if (event.status == MIDI_PROGRAM_CHANGE) {
+            // Program N recalls preset N
+            if (presetChannel == -1 || event.channel == presetChannel) {
+                paramManager->recallPreset(event.data1);
+            }
+        }
     }
-    
-    // Process the message based on type
-    if (message.status == MIDI_CONTROL_CHANGE) {
-        processControlChange(message);
+}
+
+std::vector<MidiEvent> MidiManager::getRecentMessages() const {
+    // Oldest first
+    std::vector<MidiEvent> events;
+    events.reserve(recentCount);
+    for (size_t i = 0; i < recentCount; i++) {
+        events.push_back(recentEvents[(recentHead + MAX_RECENT_EVENTS - recentCount + i) % MAX_RECENT_EVENTS]);
     }
+    return events;
 }
 
-std::vector<ofxMidiMessage> MidiManager::getRecentMessages() const {
-    return midiMessages;
+size_t MidiManager::getDroppedMessageCount() const {
+    return eventRing.getDroppedCount();
+}
+
+size_t MidiManager::getMemoryBytes() const {
+    size_t bytes = sizeof(*this) + activeGlides.capacity() * sizeof(int) +
+                   mappingSpecs.capacity() * sizeof(MidiMappingTable::MappingSpec);
+    if (mappingTable) {
+        bytes += mappingTable->getMemoryBytes();
+    }
+    return bytes;
 }
 
 std::vector<std::string> MidiManager::getAvailableDevices() const {
+    std::lock_guard<std::mutex> lock(deviceMutex);
     return availableDevices;
 }
 
 std::string MidiManager::getCurrentDeviceName() const {
+    std::lock_guard<std::mutex> lock(deviceMutex);
     if (isDeviceConnected && currentDeviceIndex >= 0 && currentDeviceIndex < availableDevices.size()) {
         return availableDevices[currentDeviceIndex];
     }
@@ -122,10 +232,12 @@ std::string MidiManager::getCurrentDeviceName() const {
 }
 
 int MidiManager::getCurrentDeviceIndex() const {
+    std::lock_guard<std::mutex> lock(deviceMutex);
     return currentDeviceIndex;
 }
 
 std::string MidiManager::getPreferredDeviceName() const {
+    std::lock_guard<std::mutex> lock(deviceMutex);
     return preferredDeviceName;
 }
 
@@ -135,299 +247,352 @@ void MidiManager::loadSettings(ofxXmlSettings& xml) {
         xml.pushTag("midi");
         
         // Get preferred device name
-        preferredDeviceName = xml.getValue("preferredDevice", "");
+        std::string preferred = xml.getValue("preferredDevice", "");
         
-        ofLogNotice("MidiManager") << "Loading MIDI settings, preferred device: " << preferredDeviceName;
+        ofLogNotice("MidiManager") << "Loading MIDI settings, preferred device: " << preferred;
         
-        // Try to connect to the saved device if it exists
-        if (!preferredDeviceName.empty() && preferredDeviceName != "Not connected") {
-            for (size_t i = 0; i < availableDevices.size(); i++) {
-                if (availableDevices[i] == preferredDeviceName) {
-                    connectToDevice(i);
-                    ofLogNotice("MidiManager") << "Connected to saved MIDI device: " << preferredDeviceName;
-                    break;
-                }
-            }
+        // Extended mappings (curve, range, pickup, resolution, glide)
+        defaultGlideTime = xml.getValue("glideTime", defaultGlideTime);
+        MidiMappingTable::loadSpecs(xml, mappingSpecs);
+        
+        // Feedback output; an empty port follows the input device
+        feedback.setEnabled(xml.getValue("feedback:enabled", feedback.isEnabled() ? 1 : 0) != 0);
+        feedback.setChannel(xml.getValue("feedback:channel", feedback.getChannel()));
+        feedback.setRate(xml.getValue("feedback:rate", feedback.getRate()));
+        feedbackPortName = xml.getValue("feedback:port", feedbackPortName);
+        
+        // P-Lock pattern notes
+        patternNoteBase = xml.getValue("patterns:noteBase", patternNoteBase);
+        patternChannel = xml.getValue("patterns:channel", patternChannel);
+        presetChannel = xml.getValue("presets:channel", presetChannel);
+        
+        // Switch to the saved device if it has already been enumerated;
+        // otherwise the watcher connects it when it shows up
+        {
+            std::lock_guard<std::mutex> lock(deviceMutex);
+            preferredDeviceName = preferred;
+            selectDeviceLocked();
         }
         
         xml.popTag(); // pop midi
     } else {
         ofLogWarning("MidiManager") << "No midi tag found in settings";
     }
+    
+    rebuildMappings();
 }
 
 void MidiManager::saveSettings(ofxXmlSettings& xml) const {
     // Save the preferred device name loaded from settings, not the currently connected one
     // This preserves the user's preference in settings.xml
-    if (!preferredDeviceName.empty()) {
-        xml.setValue("midi:preferredDevice", preferredDeviceName);
+    std::string preferred = getPreferredDeviceName();
+    if (!preferred.empty()) {
+        xml.setValue("midi:preferredDevice", preferred);
     } else {
         // If no preferred name was loaded, save the current one (or "Not connected")
         xml.setValue("midi:preferredDevice", getCurrentDeviceName());
     }
+    
+    xml.setValue("midi:glideTime", defaultGlideTime);
+    xml.setValue("midi:feedback:enabled", feedback.isEnabled() ? 1 : 0);
+    xml.setValue("midi:feedback:channel", feedback.getChannel());
+    xml.setValue("midi:feedback:rate", feedback.getRate());
+    xml.setValue("midi:feedback:port", feedbackPortName);
+    xml.setValue("midi:patterns:noteBase", patternNoteBase);
+    xml.setValue("midi:patterns:channel", patternChannel);
+    xml.setValue("midi:presets:channel", presetChannel);
+    
+    if (!mappingSpecs.empty() && xml.pushTag("midi")) {
+        MidiMappingTable::saveSpecs(xml, mappingSpecs);
+        xml.popTag(); // pop midi
+    }
+}
+
+void MidiManager::rebuildMappings() {
+    auto table = std::make_shared<MidiMappingTable>();
+    table->build(*paramManager, mappingSpecs);
+    std::atomic_store(&mappingTable, std::shared_ptr<const MidiMappingTable>(table));
+    feedback.resendAll(); // Addresses may have moved
 }
 
-void MidiManager::processControlChange(const ofxMidiMessage& message) {
-    // Handle toggles and mode switches
-    switch (message.control) {
+MidiMappingTable::Layer MidiManager::getActiveLayer() const {
+    if (paramManager->isVideoReactiveEnabled()) return MidiMappingTable::LAYER_VIDEO_REACTIVE;
+    if (paramManager->isLfoAmpModeEnabled()) return MidiMappingTable::LAYER_LFO_AMP;
+    if (paramManager->isLfoRateModeEnabled()) return MidiMappingTable::LAYER_LFO_RATE;
+    return MidiMappingTable::LAYER_NORMAL;
+}
+
+void MidiManager::processControlChange(const MidiEvent& event) {
+    // Hold a reference so a concurrent rebuild can't free the table under us
+    std::shared_ptr<const MidiMappingTable> table = std::atomic_load(&mappingTable);
+    if (!table || event.channel < 1 || event.channel > MidiMappingTable::NUM_CHANNELS) {
+        return;
+    }
+    MidiMappingTable::Layer layer = getActiveLayer();
+    int ch = event.channel - 1;
+    
+    // Don't echo a control back while the user is moving it
+    feedback.holdControl(MidiFeedback::KIND_CC, event.channel, event.data1, event.timeMicros);
+
+    // NRPN parameter select / data entry
+    if (table->hasNrpnMappings(event.channel) && processNrpn(*table, layer, event)) {
+        return;
+    }
+
+    // LSB of a 14-bit pair: combine with the latched MSB of control - 32
+    if (event.data1 >= 32 && event.data1 < 64) {
+        int msbIndex = table->find(layer, event.channel, event.data1 - 32);
+        if (msbIndex >= 0 && table->getMapping(msbIndex).highResolution) {
+            int value14 = (ccMsb[ch][event.data1 - 32] << 7) | event.data2;
+            applyMapping(*table, msbIndex, ccMsb[ch][event.data1 - 32], value14 / 16383.0f);
+            return;
+        }
+    }
+
+    int index = table->find(layer, event.channel, event.data1);
+    if (index < 0) {
+        // ofLogVerbose("MidiManager") << "Unhandled MIDI CC: Ch=" << event.channel << " Ctrl=" << event.data1 << " Val=" << event.data2;
+        return;
+    }
+
+    float normalized = event.data2 / 127.0f;
+    if (table->getMapping(index).highResolution) {
+        // MSB alone already moves the parameter; a following LSB refines it
+        ccMsb[ch][event.data1] = static_cast<uint8_t>(event.data2);
+        normalized = (event.data2 << 7) / 16383.0f;
+    }
+    applyMapping(*table, index, event.data2, normalized);
+}
+
+bool MidiManager::processNrpn(const MidiMappingTable& table, MidiMappingTable::Layer layer, const MidiEvent& event) {
+    NrpnState& state = nrpnStates[event.channel - 1];
+    switch (event.data1) {
+        case 99: // NRPN MSB
+            state.paramMsb = event.data2;
+            state.number = -1;
+            return true;
+        case 98: // NRPN LSB
+            state.number = (state.paramMsb << 7) | event.data2;
+            return true;
+        case 101: // RPN MSB / LSB - registered parameters are not mapped
+        case 100:
+            state.number = -1;
+            return true;
+        case 6: // Data entry MSB
+        case 38: { // Data entry LSB
+            if (state.number < 0) {
+                return false; // Plain CC 6 / 38
+            }
+            if (event.data1 == 6) {
+                state.dataMsb = event.data2;
+            }
+            int index = table.findNrpn(layer, event.channel, state.number);
+            feedback.holdControl(MidiFeedback::KIND_NRPN, event.channel, state.number, event.timeMicros);
+            if (index >= 0) {
+                int value14 = (state.dataMsb << 7) | (event.data1 == 38 ? event.data2 : 0);
+                applyMapping(table, index, state.dataMsb, value14 / 16383.0f);
+            }
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void MidiManager::applyMapping(const MidiMappingTable& table, int index, int value, float normalized) {
+    const MidiMappingTable::Mapping& mapping = table.getMapping(index);
+    switch (mapping.target) {
         // P-Lock record toggle
-        case 55:
-            if (message.value == 127) {
+        case MidiMappingTable::TARGET_RECORD:
+            if (value == 127) {
                 paramManager->startRecording();
-            } else if (message.value == 0) {
+            } else if (value == 0) {
                 paramManager->stopRecording();
             }
-            return;
-            
+            break;
+
         // Video reactive toggle
-        case 39:
-            if (message.value == 127) {
+        case MidiMappingTable::TARGET_VIDEO_REACTIVE:
+            if (value == 127) {
                 paramManager->setVideoReactiveEnabled(true);
                 paramManager->setRecordingEnabled(false);
-            } else if (message.value == 0) {
+            } else if (value == 0) {
                 paramManager->setVideoReactiveEnabled(false);
                 paramManager->setRecordingEnabled(true);
             }
-            return;
-            
+            break;
+
         // Clear buffers
-        case 58:
-            if (message.value == 127) {
+        case MidiMappingTable::TARGET_CLEAR_BUFFERS:
+            if (value == 127) {
                 // TODO: Implement clear functionality in VideoFeedbackManager
             }
-            return;
-            
+            break;
+
         // Reset all parameters
-        case 59:
-            if (message.value == 127) {
+        case MidiMappingTable::TARGET_RESET:
+            if (value == 127) {
                 paramManager->resetToDefaults();
+                cancelGlides(); // Don't glide back to pre-reset values
             }
-            return;
-            
-        // X scaling toggles
-        case 32:
-            xScaling.times2 = (message.value == 127);
-            return;
-        case 48:
-            xScaling.times5 = (message.value == 127);
-            return;
-        case 64:
-            xScaling.times10 = (message.value == 127);
-            return;
-            
-        // Y scaling toggles
-        case 33:
-            yScaling.times2 = (message.value == 127);
-            return;
-        case 49:
-            yScaling.times5 = (message.value == 127);
-            return;
-        case 65:
-            yScaling.times10 = (message.value == 127);
-            return;
-            
-        // Z scaling toggles
-        case 34:
-            zScaling.times2 = (message.value == 127);
-            return;
-        case 50:
-            zScaling.times5 = (message.value == 127);
-            return;
-        case 66:
-            zScaling.times10 = (message.value == 127);
-            return;
-            
-        // Rotation scaling toggles
-        case 35:
-            rotateScaling.times2 = (message.value == 127);
-            return;
-        case 51:
-            rotateScaling.times5 = (message.value == 127);
-            return;
-        case 67:
-            rotateScaling.times10 = (message.value == 127);
-            return;
-            
-        // Hue modulation scaling toggles
-        case 36:
-            hueModScaling.times2 = (message.value == 127);
-            return;
-        case 52:
-            hueModScaling.times5 = (message.value == 127);
-            return;
-        case 68:
-            hueModScaling.times10 = (message.value == 127);
-            return;
-            
-        // Hue offset scaling toggles
-        case 37:
-            hueOffsetScaling.times2 = (message.value == 127);
-            return;
-        case 53:
-            hueOffsetScaling.times5 = (message.value == 127);
-            return;
-        case 69:
-            hueOffsetScaling.times10 = (message.value == 127);
-            return;
-            
-        // Hue LFO scaling toggles
-        case 38:
-            hueLfoScaling.times2 = (message.value == 127);
-            return;
-        case 54:
-            hueLfoScaling.times5 = (message.value == 127);
-            return;
-        case 70:
-            hueLfoScaling.times10 = (message.value == 127);
-            return;
-            
-        // Other effect toggles
-        case 42:
-            paramManager->setHueInverted(message.value == 127);
-            return;
-        case 43:
-            paramManager->setBrightnessInverted(message.value == 127);
-            return;
-        case 44:
-            paramManager->setSaturationInverted(message.value == 127);
-            return;
-        case 41:
-            paramManager->setHorizontalMirrorEnabled(message.value == 127);
-            return;
-        case 45:
-            paramManager->setVerticalMirrorEnabled(message.value == 127);
-            return;
-        case 46:
-            paramManager->setToroidEnabled(message.value == 127);
-            return;
-        case 61:
-            paramManager->setMirrorModeEnabled(message.value == 127);
-            return;
-        case 60:
-            paramManager->setLumakeyInverted(message.value == 127);
-            return;
-        case 71:
-            paramManager->setWetModeEnabled(message.value == 0);
-            return;
-    }
+            break;
 
-    // --- Dynamic MIDI Mapping for Continuous Controls ---
-    bool videoReactiveMode = paramManager->isVideoReactiveEnabled();
-    bool lfoAmpMode = paramManager->isLfoAmpModeEnabled();
-    bool lfoRateMode = paramManager->isLfoRateModeEnabled();
+        // x2 / x5 / x10 scaling toggles
+        case MidiMappingTable::TARGET_SCALE:
+            scaling[mapping.scaleGroup].set(mapping.scaleFactor, value == 127);
+            break;
 
-    // Iterate through all known parameters to find a match
-    const auto& paramIds = paramManager->getAllParameterIds();
-    for (const auto& id : paramIds) {
-        int mappedChannel = paramManager->getMidiChannel(id);
-        int mappedControl = paramManager->getMidiControl(id);
+        case MidiMappingTable::TARGET_TOGGLE: {
+            bool enabled = mapping.inverted ? (value == 0) : (value == 127);
+            paramManager->setParameterValue(mapping.paramIndex, enabled ? 1.0f : 0.0f);
+            break;
+        }
 
-        // Check if the incoming message matches the mapping for this parameter
-        if (mappedChannel != -1 && mappedControl != -1 &&
-            message.channel == mappedChannel && message.control == mappedControl)
-        {
-            // Found a match, process the value based on parameter ID and mode
-            float normalizedValue = 0.0f;
-            float scale = 1.0f; // Default scale
-
-            // Determine normalization and scaling based on parameter ID
-            // (This logic mirrors the original switch statement's behavior)
-            if (id == "lumakeyValue" || id == "temporalFilterResonance" || id == "sharpenAmount" || id == "delayAmount") {
-                normalizedValue = normalizeValue(message.value, false); // 0 to 1
-            } else if (id == "mix" || id == "hue" || id == "saturation" || id == "brightness" ||
-                       id == "temporalFilterMix" || id == "xDisplace" || id == "yDisplace" ||
-                       id == "zDisplace" || id == "rotate" || id == "hueOffset" || id == "hueLFO" ||
-                       id == "xLfoAmp" || id == "xLfoRate" || id == "yLfoAmp" || id == "yLfoRate" ||
-                       id == "zLfoAmp" || id == "zLfoRate" || id == "rotateLfoAmp" || id == "rotateLfoRate" ||
-                       id == "vMix" || id == "vHue" || id == "vSaturation" || id == "vBrightness" ||
-                       id == "vTemporalFilterMix" || id == "vXDisplace" || id == "vYDisplace" ||
-                       id == "vZDisplace" || id == "vRotate" || id == "vHueOffset" || id == "vHueLFO") {
-                normalizedValue = normalizeValue(message.value, true); // -1 to 1
-            } else if (id == "hueModulation" || id == "vHueModulation") {
-                 normalizedValue = message.value / 32.0f; // Special scaling for hue modulation
-            } else {
-                // If it's not a known continuous float/int parameter, skip
-                // (Toggles are handled by the switch above)
-                continue;
+        case MidiMappingTable::TARGET_PARAMETER: {
+            float target = mapping.apply(normalized);
+            if (mapping.scaleGroup != MidiMappingTable::SCALE_NONE) {
+                target *= scaling[mapping.scaleGroup].getScale();
+            }
+
+            // Soft takeover: ignore the control until it reaches the current value
+            float current = paramManager->getParameterValue(mapping.paramIndex);
+            if (!table.checkPickup(index, target, current, CONTROL_THRESHOLD)) {
+                break;
             }
 
-            // Apply scaling factors for specific parameters
-            if (id == "xDisplace" || id == "vXDisplace" || id == "xLfoAmp" || id == "xLfoRate") scale = xScaling.getScale();
-            else if (id == "yDisplace" || id == "vYDisplace" || id == "yLfoAmp" || id == "yLfoRate") scale = yScaling.getScale();
-            else if (id == "zDisplace" || id == "vZDisplace" || id == "zLfoAmp" || id == "zLfoRate") scale = zScaling.getScale();
-            else if (id == "rotate" || id == "vRotate" || id == "rotateLfoAmp" || id == "rotateLfoRate") scale = rotateScaling.getScale();
-            else if (id == "hueModulation" || id == "vHueModulation") scale = hueModScaling.getScale();
-            else if (id == "hueOffset" || id == "vHueOffset") scale = hueOffsetScaling.getScale();
-            else if (id == "hueLFO" || id == "vHueLFO") scale = hueLfoScaling.getScale();
-
-            normalizedValue *= scale;
-
-            // Apply the value using the correct setter based on mode and ID
-            if (videoReactiveMode) {
-                if (id == "vLumakeyValue") paramManager->setVLumakeyValue(normalizedValue);
-                else if (id == "vMix") paramManager->setVMix(normalizedValue);
-                else if (id == "vHue") paramManager->setVHue(normalizedValue);
-                else if (id == "vSaturation") paramManager->setVSaturation(normalizedValue);
-                else if (id == "vBrightness") paramManager->setVBrightness(normalizedValue);
-                else if (id == "vTemporalFilterMix") paramManager->setVTemporalFilterMix(normalizedValue);
-                else if (id == "vTemporalFilterResonance") paramManager->setVTemporalFilterResonance(normalizedValue);
-                else if (id == "vSharpenAmount") paramManager->setVSharpenAmount(normalizedValue);
-                else if (id == "vXDisplace") paramManager->setVXDisplace(normalizedValue);
-                else if (id == "vYDisplace") paramManager->setVYDisplace(normalizedValue);
-                else if (id == "vZDisplace") paramManager->setVZDisplace(normalizedValue);
-                else if (id == "vRotate") paramManager->setVRotate(normalizedValue);
-                else if (id == "vHueModulation") paramManager->setVHueModulation(normalizedValue);
-                else if (id == "vHueOffset") paramManager->setVHueOffset(normalizedValue);
-                else if (id == "vHueLFO") paramManager->setVHueLFO(normalizedValue);
-                // Note: DelayAmount, LFO Amp/Rate are not affected by videoReactiveMode in original code
-            } else if (lfoAmpMode) {
-                if (id == "xLfoAmp") paramManager->setXLfoAmp(normalizedValue);
-                else if (id == "yLfoAmp") paramManager->setYLfoAmp(normalizedValue);
-                else if (id == "zLfoAmp") paramManager->setZLfoAmp(normalizedValue);
-                else if (id == "rotateLfoAmp") paramManager->setRotateLfoAmp(normalizedValue);
-                // Note: Other params not affected by lfoAmpMode
-            } else if (lfoRateMode) {
-                if (id == "xLfoRate") paramManager->setXLfoRate(normalizedValue);
-                else if (id == "yLfoRate") paramManager->setYLfoRate(normalizedValue);
-                else if (id == "zLfoRate") paramManager->setZLfoRate(normalizedValue);
-                else if (id == "rotateLfoRate") paramManager->setRotateLfoRate(normalizedValue);
-                 // Note: Other params not affected by lfoRateMode
+            float glideTime = mapping.glideTime >= 0.0f ? mapping.glideTime : defaultGlideTime;
+            if (glideTime > 0.0f) {
+                startGlide(mapping.paramIndex, target, glideTime);
             } else {
-                // Normal mode
-                if (id == "lumakeyValue") paramManager->setLumakeyValue(normalizedValue);
-                else if (id == "mix") paramManager->setMix(normalizedValue);
-                else if (id == "hue") paramManager->setHue(normalizedValue);
-                else if (id == "saturation") paramManager->setSaturation(normalizedValue);
-                else if (id == "brightness") paramManager->setBrightness(normalizedValue);
-                else if (id == "temporalFilterMix") paramManager->setTemporalFilterMix(normalizedValue);
-                else if (id == "temporalFilterResonance") paramManager->setTemporalFilterResonance(normalizedValue);
-                else if (id == "sharpenAmount") paramManager->setSharpenAmount(normalizedValue);
-                else if (id == "xDisplace") paramManager->setXDisplace(normalizedValue);
-                else if (id == "yDisplace") paramManager->setYDisplace(normalizedValue);
-                else if (id == "zDisplace") paramManager->setZDisplace(normalizedValue);
-                else if (id == "rotate") paramManager->setRotate(normalizedValue);
-                else if (id == "hueModulation") paramManager->setHueModulation(normalizedValue);
-                else if (id == "hueOffset") paramManager->setHueOffset(normalizedValue);
-                else if (id == "hueLFO") paramManager->setHueLFO(normalizedValue);
-                else if (id == "delayAmount") paramManager->setDelayAmount(static_cast<int>(normalizedValue * 100)); // Scale int delay
-                // Note: LFO Amp/Rate setters are called directly in lfoAmp/Rate modes above
+                paramManager->setParameterValue(mapping.paramIndex, target);
+                table.noteWritten(mapping.paramIndex, target);
             }
+            break;
+        }
+    }
+}
 
-            // Found and processed the mapping, no need to check further
-            return;
+void MidiManager::processNote(const MidiEvent& event) {
+    if (patternNoteBase < 0 || (patternChannel >= 1 && event.channel != patternChannel)) {
+        return;
+    }
+    int pattern = event.data1 - patternNoteBase;
+    if (pattern < 0 || pattern >= paramManager->getNumPatterns()) {
+        return;
+    }
+
+    bool noteOn = event.status == MIDI_NOTE_ON && event.data2 > 0;
+    if (!noteOn) {
+        if (event.data1 == heldPatternNote) {
+            heldPatternNote = -1;
         }
+        return;
     }
 
-    // If no mapping was found for this CC message, log it (optional)
-    // ofLogVerbose("MidiManager") << "Unhandled MIDI CC: Ch=" << message.channel << " Ctrl=" << message.control << " Val=" << message.value;
+    if (heldPatternNote >= 0 && heldPatternNote != event.data1) {
+        // Second note while one is held: chain held -> pressed
+        int held = heldPatternNote - patternNoteBase;
+        paramManager->setPatternChain(held, pattern, 1);
+        ofLogNotice("MidiManager") << "Chained P-Lock pattern " << held << " -> " << pattern;
+        return;
+    }
+    heldPatternNote = event.data1;
+    paramManager->selectPattern(pattern);
 }
 
-float MidiManager::normalizeValue(int value, bool centered) const {
-    if (centered) {
-        // For values that should be centered around 0 (-1 to 1)
-        return (value - MIDI_MAGIC) / MIDI_MAGIC;
-    } else {
-        // For values that range from 0 to 1
-        return value / 127.0f;
+void MidiManager::updateFeedback() {
+    if (!feedback.isActive()) {
+        return;
+    }
+    std::shared_ptr<const MidiMappingTable> table = std::atomic_load(&mappingTable);
+    if (!table) {
+        return;
+    }
+    MidiMappingTable::Layer layer = getActiveLayer();
+    uint64_t now = ofGetElapsedTimeMicros();
+
+    for (size_t i = 0; i < table->getNumMappings(); i++) {
+        const MidiMappingTable::Mapping& mapping = table->getMapping(i);
+        if (mapping.paramIndex < 0 ||
+            (mapping.target != MidiMappingTable::TARGET_PARAMETER && mapping.target != MidiMappingTable::TARGET_TOGGLE)) {
+            continue;
+        }
+
+        // Only controls that currently drive this mapping (active layer, not overridden)
+        int channel = mapping.channel >= 1 ? mapping.channel : feedback.getChannel();
+        int found = mapping.nrpn >= 0 ? table->findNrpn(layer, channel, mapping.nrpn)
+                                      : table->find(layer, channel, mapping.control);
+        if (found != static_cast<int>(i)) {
+            continue;
+        }
+
+        float value = paramManager->getEffectiveParameterValue(mapping.paramIndex);
+        if (mapping.target == MidiMappingTable::TARGET_TOGGLE) {
+            bool on = (value > 0.5f) != mapping.inverted;
+            feedback.setValue(MidiFeedback::KIND_CC, channel, mapping.control, on ? 127 : 0, now);
+            continue;
+        }
+
+        if (mapping.scaleGroup != MidiMappingTable::SCALE_NONE) {
+            value /= scaling[mapping.scaleGroup].getScale();
+        }
+        float normalized = mapping.normalize(value);
+        if (mapping.nrpn >= 0) {
+            feedback.setValue(MidiFeedback::KIND_NRPN, channel, mapping.nrpn, static_cast<int>(normalized * 16383.0f + 0.5f), now);
+        } else if (mapping.highResolution) {
+            feedback.setValue(MidiFeedback::KIND_CC14, channel, mapping.control, static_cast<int>(normalized * 16383.0f + 0.5f), now);
+        } else {
+            feedback.setValue(MidiFeedback::KIND_CC, channel, mapping.control, static_cast<int>(normalized * 127.0f + 0.5f), now);
+        }
+    }
+}
+
+void MidiManager::startGlide(int paramIndex, float target, float glideTime) {
+    GlideState& glide = glides[paramIndex];
+    if (!glide.active) {
+        glide.current = paramManager->getParameterValue(paramIndex);
+        glide.active = true;
+        activeGlides.push_back(paramIndex);
+    }
+    glide.target = target;
+    glide.time = glideTime;
+}
+
+void MidiManager::cancelGlides() {
+    for (int paramIndex : activeGlides) {
+        glides[paramIndex].active = false;
+    }
+    activeGlides.clear();
+}
+
+void MidiManager::updateGlides(float deltaTime) {
+    if (activeGlides.empty()) {
+        return;
+    }
+    std::shared_ptr<const MidiMappingTable> table = std::atomic_load(&mappingTable);
+
+    // Only parameters that are still moving are visited
+    for (size_t i = 0; i < activeGlides.size();) {
+        int paramIndex = activeGlides[i];
+        GlideState& glide = glides[paramIndex];
+
+        // Frame-rate independent exponential approach
+        float alpha = 1.0f - expf(-deltaTime / glide.time);
+        glide.current += (glide.target - glide.current) * alpha;
+        if (std::abs(glide.target - glide.current) < GLIDE_EPSILON) {
+            glide.current = glide.target;
+            glide.active = false;
+        }
+        paramManager->setParameterValue(paramIndex, glide.current);
+        if (table) {
+            table->noteWritten(paramIndex, glide.current); // Soft takeover tells our own writes from others
+        }
+
+        if (!glide.active) {
+            activeGlides[i] = activeGlides.back();
+            activeGlides.pop_back();
+        } else {
+            i++;
+        }
     }
 }
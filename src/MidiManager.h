@@ -3,6 +3,10 @@
 #include "ofMain.h"
 #include "ofxMidi.h"
 #include "ParameterManager.h"
+#include "MidiMappingTable.h"
+#include "MidiDeviceWatcher.h"
+#include "MidiEventRing.h"
+#include "MidiFeedback.h"
 #include "ofxXmlSettings.h"
 
 /**
@@ -10,7 +14,8 @@
  * @brief Handles MIDI input and maps controls to parameters
  *
  * This class manages MIDI device connections, message processing,
- * and mapping of MIDI controls to effect parameters.
+ * and mapping of MIDI controls to effect parameters. Control changes are
+ * resolved through a compiled MidiMappingTable.
  */
 class MidiManager : public ofxMidiListener {
 public:
@@ -21,17 +26,19 @@ public:
     void setup();
     void update();
     
-    // MIDI device handling
-    void scanForDevices();
+    // MIDI device handling (enumeration runs on a background thread)
+    void scanForDevices(); // Request a rescan, non-blocking
     bool connectToDevice(int deviceIndex);
     bool connectToDevice(const std::string& deviceName);
     void disconnectCurrentDevice();
     
     // MIDI message handling
-    void newMidiMessage(ofxMidiMessage& message) override;
+    void newMidiMessage(ofxMidiMessage& message) override; // MIDI thread, enqueue only
     
-    // Message queue access
-    std::vector<ofxMidiMessage> getRecentMessages() const;
+    // Recent message history for the debug overlay (render thread only)
+    std::vector<MidiEvent> getRecentMessages() const;
+    size_t getDroppedMessageCount() const;
+    size_t getMemoryBytes() const; // Event ring, glide state and mapping table, for MemoryTracker
     
     // Device information
     std::vector<std::string> getAvailableDevices() const;
@@ -43,33 +50,102 @@ public:
     void loadSettings(ofxXmlSettings& xml);
     void saveSettings(ofxXmlSettings& xml) const;
     
+    // Recompile the mapping table from ParameterManager and swap it in
+    void rebuildMappings();
+    
+    // Feedback to the controller's LEDs / motor faders
+    MidiFeedback& getFeedback() { return feedback; }
+    
+    // Default time (seconds) to glide between incoming values, 0 = jump
+    float getGlideTime() const { return defaultGlideTime; }
+    void setGlideTime(float seconds) { defaultGlideTime = std::max(0.0f, seconds); }
+    
 private:
     // Constants
-    static constexpr float MIDI_MAGIC = 63.50f;
-    static constexpr float CONTROL_THRESHOLD = 0.04f;
+    static constexpr float CONTROL_THRESHOLD = 0.04f; // Soft takeover window (normalized)
+    static constexpr float GLIDE_EPSILON = 1e-4f;
     
     // Message processing methods
-    void processControlChange(const ofxMidiMessage& message);
-    float normalizeValue(int value, bool centered = false) const;
+    void processEvents();
+    void processControlChange(const MidiEvent& event);
+    bool processNrpn(const MidiMappingTable& table, MidiMappingTable::Layer layer, const MidiEvent& event);
+    void applyMapping(const MidiMappingTable& table, int index, int value, float normalized);
+    MidiMappingTable::Layer getActiveLayer() const;
+    void updateFeedback();
+    void processNote(const MidiEvent& event);
+    
+    // Device handling; *Locked methods expect deviceMutex to be held
+    void onDevicesChanged(const std::vector<std::string>& devices); // Watcher thread
+    void selectDeviceLocked();
+    bool openDeviceLocked(int deviceIndex);
+    void closeDeviceLocked();
+    
+    // Value interpolation
+    void startGlide(int paramIndex, float target, float glideTime);
+    void updateGlides(float deltaTime);
+    void cancelGlides();
     
     // MIDI input
     ofxMidiIn midiIn;
-    std::vector<ofxMidiMessage> midiMessages;
-    size_t maxMessages = 10;
+    
+    // Messages flow from the MIDI thread to the render thread through this ring
+    static const size_t EVENT_RING_SIZE = 1024;
+    MidiEventRing<MidiEvent, EVENT_RING_SIZE> eventRing;
+    
+    // Debug history, owned by the render thread
+    static const size_t MAX_RECENT_EVENTS = 10;
+    MidiEvent recentEvents[MAX_RECENT_EVENTS];
+    size_t recentHead = 0;
+    size_t recentCount = 0;
+    
+    // P-Lock pattern selection by note: base + pattern index. Holding one
+    // pattern note while pressing another chains the held pattern to it
+    int patternNoteBase = 36;   // -1 disables
+    int patternChannel = -1;    // 1-16, -1 = omni
+    int heldPatternNote = -1;
+    int presetChannel = -1;     // Program changes recall presets; 1-16, -1 = omni, 0 = off
+
+    // MIDI output, follows the input device unless a port is configured
+    MidiFeedback feedback;
+    std::string feedbackPortName;
     
     // Device management
+    MidiDeviceWatcher deviceWatcher;
+    mutable std::mutex deviceMutex; // Guards device list, connection state and preferred name
     std::vector<std::string> availableDevices;
     int currentDeviceIndex = -1;
     std::string preferredDeviceName;
     
     // Connection state
     bool isDeviceConnected = false;
-    float lastDeviceScanTime = 0;
-    const float DEVICE_SCAN_INTERVAL = 2.0f; // seconds
     
     // Reference to parameter manager
     ParameterManager* paramManager;
     
+    // Compiled mappings, replaced atomically by rebuildMappings()
+    std::shared_ptr<const MidiMappingTable> mappingTable;
+    std::vector<MidiMappingTable::MappingSpec> mappingSpecs; // Extended mappings from settings.xml
+    
+    // High-resolution input state, per channel
+    uint8_t ccMsb[MidiMappingTable::NUM_CHANNELS][32] = {}; // Latched MSB of 14-bit CC pairs
+    struct NrpnState {
+        int paramMsb = 0;
+        int number = -1; // Selected NRPN, -1 = none
+        int dataMsb = 0;
+    };
+    NrpnState nrpnStates[MidiMappingTable::NUM_CHANNELS];
+    
+    // Per-parameter glide towards the latest MIDI value, advanced in update()
+    struct GlideState {
+        float current = 0.0f;
+        float target = 0.0f;
+        float time = 0.0f;
+        bool active = false;
+    };
+    GlideState glides[ParameterManager::PARAM_COUNT];
+    std::vector<int> activeGlides;
+    float defaultGlideTime = 0.05f; // Seconds
+    
     // Scaling helpers for MIDI controls
     struct ScalingHelper {
         bool times2 = false;
@@ -82,13 +158,14 @@ private:
             if (times2) return 2.0f;
             return 1.0f;
         }
+        
+        void set(float factor, bool enabled) {
+            if (factor >= 10.0f) times10 = enabled;
+            else if (factor >= 5.0f) times5 = enabled;
+            else times2 = enabled;
+        }
     };
     
-    ScalingHelper xScaling;
-    ScalingHelper yScaling;
-    ScalingHelper zScaling;
-    ScalingHelper rotateScaling;
-    ScalingHelper hueModScaling;
-    ScalingHelper hueOffsetScaling;
-    ScalingHelper hueLfoScaling;
+    // Indexed by MidiMappingTable::ScaleGroup
+    ScalingHelper scaling[MidiMappingTable::SCALE_GROUP_COUNT];
 };
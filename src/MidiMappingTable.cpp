@@ -0,0 +1,426 @@
+#include "MidiMappingTable.h"
+
+float MidiMappingTable::Mapping::apply(float normalized) const {
+    float x = ofClamp(normalized, 0.0f, 1.0f);
+    switch (curve) {
+        case CURVE_EXPONENTIAL: x = x * x; break;
+        case CURVE_LOGARITHMIC: x = sqrtf(x); break;
+        case CURVE_S:           x = x * x * (3.0f - 2.0f * x); break;
+        case CURVE_LINEAR:
+        default: break;
+    }
+    return minValue + x * (maxValue - minValue);
+}
+
+float MidiMappingTable::Mapping::normalize(float value) const {
+    float range = maxValue - minValue;
+    float x = std::abs(range) > 1e-6f ? ofClamp((value - minValue) / range, 0.0f, 1.0f) : 0.0f;
+    switch (curve) {
+        case CURVE_EXPONENTIAL: return sqrtf(x);
+        case CURVE_LOGARITHMIC: return x * x;
+        case CURVE_S:           return 0.5f - sinf(asinf(1.0f - 2.0f * x) / 3.0f); // Inverse smoothstep
+        case CURVE_LINEAR:
+        default: return x;
+    }
+}
+
+MidiMappingTable::MidiMappingTable() {
+    std::fill(&cells[0][0][0], &cells[0][0][0] + LAYER_COUNT * NUM_CHANNELS * NUM_CONTROLS, NO_MAPPING);
+}
+
+void MidiMappingTable::build(const ParameterManager& params, const std::vector<MappingSpec>& specs) {
+    mappings.clear();
+    nrpnCells.clear();
+    nrpnChannelMask = 0;
+    std::fill(&cells[0][0][0], &cells[0][0][0] + LAYER_COUNT * NUM_CHANNELS * NUM_CONTROLS, NO_MAPPING);
+
+    // Legacy controller layout first, so mappings from settings.xml can override it
+    addLegacyControls();
+
+    // Per-parameter mappings from <param midiChannel=".." midiControl=".."/>
+    const auto& paramIds = params.getAllParameterIds();
+    for (size_t i = 0; i < paramIds.size(); i++) {
+        int channel = params.getMidiChannel(paramIds[i]);
+        int control = params.getMidiControl(paramIds[i]);
+        if (channel < 1 || channel > NUM_CHANNELS || control < 0 || control >= NUM_CONTROLS) {
+            continue; // Both must be set, as before; omni is only offered by <mapping> entries
+        }
+
+        Mapping mapping;
+        if (!makeDefaultMapping(static_cast<int>(i), mapping)) {
+            ofLogWarning("MidiMappingTable") << "Parameter " << paramIds[i] << " cannot be mapped to MIDI";
+            continue;
+        }
+        mapping.userDefined = true;
+        assign(mapping, channel, control);
+    }
+
+    // Extended mappings with curve, range and pickup
+    for (const auto& spec : specs) {
+        int paramIndex = params.findParameterIndex(spec.paramId);
+        Mapping mapping;
+        bool validAddress = spec.nrpn >= 0 ? spec.nrpn < 16384 : (spec.control >= 0 && spec.control < NUM_CONTROLS);
+        if (paramIndex < 0 || !validAddress) {
+            ofLogWarning("MidiMappingTable") << "Ignoring invalid mapping for '" << spec.paramId
+                                             << "' (control " << spec.control << ", nrpn " << spec.nrpn << ")";
+            continue;
+        }
+        if (!makeDefaultMapping(paramIndex, mapping)) {
+            // Not mappable by default (e.g. frequencies) - allow it when a range is given
+            if (!spec.hasRange) {
+                ofLogWarning("MidiMappingTable") << "Mapping for '" << spec.paramId << "' needs min/max";
+                continue;
+            }
+            mapping.target = TARGET_PARAMETER;
+            mapping.layer = LAYER_NORMAL;
+            mapping.paramIndex = paramIndex;
+        }
+        mapping.curve = spec.curve;
+        mapping.pickup = spec.pickup;
+        if (spec.hasRange) {
+            mapping.minValue = spec.minValue;
+            mapping.maxValue = spec.maxValue;
+        }
+        mapping.glideTime = spec.glideTime;
+        mapping.userDefined = true;
+        if (spec.nrpn >= 0) {
+            mapping.highResolution = true; // NRPN data entry is always MSB + LSB
+            assignNrpn(mapping, spec.channel, spec.nrpn);
+            continue;
+        }
+        mapping.highResolution = spec.highResolution;
+        if (mapping.highResolution && spec.control >= 32) {
+            ofLogWarning("MidiMappingTable") << "14-bit mapping for '" << spec.paramId
+                                             << "' needs an MSB control 0-31, using 7-bit";
+            mapping.highResolution = false;
+        }
+        assign(mapping, spec.channel, spec.control);
+    }
+
+    pickupStates.assign(mappings.size(), MidiPickup());
+
+    ofLogNotice("MidiMappingTable") << "Built MIDI mapping table with " << mappings.size() << " mappings";
+}
+
+int MidiMappingTable::find(Layer activeLayer, int channel, int control) const {
+    if (channel < 1 || channel > NUM_CHANNELS || control < 0 || control >= NUM_CONTROLS) {
+        return -1;
+    }
+    int16_t index = cells[LAYER_ALWAYS][channel - 1][control];
+    if (index == NO_MAPPING) {
+        index = cells[activeLayer][channel - 1][control];
+    }
+    return index;
+}
+
+int MidiMappingTable::findNrpn(Layer activeLayer, int channel, int nrpn) const {
+    if (channel < 1 || channel > NUM_CHANNELS) {
+        return -1;
+    }
+    auto it = nrpnCells.find(((channel - 1) << 14) | (nrpn & 0x3FFF));
+    if (it == nrpnCells.end()) {
+        return -1;
+    }
+    Layer layer = mappings[it->second].layer;
+    return (layer == LAYER_ALWAYS || layer == activeLayer) ? it->second : -1;
+}
+
+bool MidiMappingTable::hasNrpnMappings(int channel) const {
+    return channel >= 1 && channel <= NUM_CHANNELS && (nrpnChannelMask & (1 << (channel - 1)));
+}
+
+bool MidiMappingTable::checkPickup(int index, float incoming, float current, float threshold) const {
+    const Mapping& mapping = mappings[index];
+    if (mapping.pickup == PICKUP_JUMP) {
+        return true;
+    }
+    return pickupStates[index].check(incoming, current, mapping.maxValue - mapping.minValue, threshold);
+}
+
+void MidiMappingTable::noteWritten(int paramIndex, float value) const {
+    for (size_t i = 0; i < mappings.size(); i++) {
+        if (mappings[i].paramIndex == paramIndex && mappings[i].pickup != PICKUP_JUMP) {
+            pickupStates[i].noteWritten(value);
+        }
+    }
+}
+
+bool MidiMappingTable::makeDefaultMapping(int paramIndex, Mapping& mapping) {
+    mapping.paramIndex = paramIndex;
+    mapping.target = TARGET_PARAMETER;
+    mapping.layer = LAYER_NORMAL;
+    mapping.minValue = -1.0f; // Centered around 0 by default
+    mapping.maxValue = 1.0f;
+    mapping.scaleGroup = SCALE_NONE;
+
+    switch (paramIndex) {
+        // Toggles and mode flags respond in every mode
+        case ParameterManager::PARAM_HUE_INVERT:
+        case ParameterManager::PARAM_SATURATION_INVERT:
+        case ParameterManager::PARAM_BRIGHTNESS_INVERT:
+        case ParameterManager::PARAM_HORIZONTAL_MIRROR:
+        case ParameterManager::PARAM_VERTICAL_MIRROR:
+        case ParameterManager::PARAM_LUMAKEY_INVERT:
+        case ParameterManager::PARAM_TOROID_ENABLED:
+        case ParameterManager::PARAM_MIRROR_MODE_ENABLED:
+        case ParameterManager::PARAM_VIDEO_REACTIVE_MODE:
+        case ParameterManager::PARAM_LFO_AMP_MODE:
+        case ParameterManager::PARAM_LFO_RATE_MODE:
+            mapping.target = TARGET_TOGGLE;
+            mapping.layer = LAYER_ALWAYS;
+            return true;
+        case ParameterManager::PARAM_WET_MODE_ENABLED:
+            mapping.target = TARGET_TOGGLE;
+            mapping.layer = LAYER_ALWAYS;
+            mapping.inverted = true; // Wet mode is on when the button is released
+            return true;
+
+        // Unipolar 0 to 1
+        case ParameterManager::PARAM_LUMAKEY_VALUE:
+        case ParameterManager::PARAM_TEMPORAL_FILTER_RESONANCE:
+        case ParameterManager::PARAM_SHARPEN_AMOUNT:
+            mapping.minValue = 0.0f;
+            return true;
+        case ParameterManager::PARAM_DELAY_AMOUNT:
+            mapping.minValue = 0.0f;
+            mapping.maxValue = 100.0f; // Frames
+            return true;
+
+        // Centered -1 to 1
+        case ParameterManager::PARAM_MIX:
+        case ParameterManager::PARAM_HUE:
+        case ParameterManager::PARAM_SATURATION:
+        case ParameterManager::PARAM_BRIGHTNESS:
+        case ParameterManager::PARAM_TEMPORAL_FILTER_MIX:
+            return true;
+        case ParameterManager::PARAM_X_DISPLACE: mapping.scaleGroup = SCALE_X; return true;
+        case ParameterManager::PARAM_Y_DISPLACE: mapping.scaleGroup = SCALE_Y; return true;
+        case ParameterManager::PARAM_Z_DISPLACE: mapping.scaleGroup = SCALE_Z; return true;
+        case ParameterManager::PARAM_ROTATE: mapping.scaleGroup = SCALE_ROTATE; return true;
+        case ParameterManager::PARAM_HUE_OFFSET: mapping.scaleGroup = SCALE_HUE_OFFSET; return true;
+        case ParameterManager::PARAM_HUE_LFO: mapping.scaleGroup = SCALE_HUE_LFO; return true;
+        case ParameterManager::PARAM_HUE_MODULATION:
+            mapping.minValue = 0.0f;
+            mapping.maxValue = 127.0f / 32.0f;
+            mapping.scaleGroup = SCALE_HUE_MOD;
+            return true;
+
+        // LFO amplitude / rate only respond in their mode
+        case ParameterManager::PARAM_X_LFO_AMP: mapping.layer = LAYER_LFO_AMP; mapping.scaleGroup = SCALE_X; return true;
+        case ParameterManager::PARAM_Y_LFO_AMP: mapping.layer = LAYER_LFO_AMP; mapping.scaleGroup = SCALE_Y; return true;
+        case ParameterManager::PARAM_Z_LFO_AMP: mapping.layer = LAYER_LFO_AMP; mapping.scaleGroup = SCALE_Z; return true;
+        case ParameterManager::PARAM_ROTATE_LFO_AMP: mapping.layer = LAYER_LFO_AMP; mapping.scaleGroup = SCALE_ROTATE; return true;
+        case ParameterManager::PARAM_X_LFO_RATE: mapping.layer = LAYER_LFO_RATE; mapping.scaleGroup = SCALE_X; return true;
+        case ParameterManager::PARAM_Y_LFO_RATE: mapping.layer = LAYER_LFO_RATE; mapping.scaleGroup = SCALE_Y; return true;
+        case ParameterManager::PARAM_Z_LFO_RATE: mapping.layer = LAYER_LFO_RATE; mapping.scaleGroup = SCALE_Z; return true;
+        case ParameterManager::PARAM_ROTATE_LFO_RATE: mapping.layer = LAYER_LFO_RATE; mapping.scaleGroup = SCALE_ROTATE; return true;
+
+        // Video reactive parameters only respond in video reactive mode
+        case ParameterManager::PARAM_V_LUMAKEY_VALUE:
+        case ParameterManager::PARAM_V_TEMPORAL_FILTER_RESONANCE:
+        case ParameterManager::PARAM_V_SHARPEN_AMOUNT:
+            mapping.layer = LAYER_VIDEO_REACTIVE;
+            mapping.minValue = 0.0f; // Unipolar like their base parameters
+            return true;
+        case ParameterManager::PARAM_V_MIX:
+        case ParameterManager::PARAM_V_HUE:
+        case ParameterManager::PARAM_V_SATURATION:
+        case ParameterManager::PARAM_V_BRIGHTNESS:
+        case ParameterManager::PARAM_V_TEMPORAL_FILTER_MIX:
+            mapping.layer = LAYER_VIDEO_REACTIVE;
+            return true;
+        case ParameterManager::PARAM_V_X_DISPLACE: mapping.layer = LAYER_VIDEO_REACTIVE; mapping.scaleGroup = SCALE_X; return true;
+        case ParameterManager::PARAM_V_Y_DISPLACE: mapping.layer = LAYER_VIDEO_REACTIVE; mapping.scaleGroup = SCALE_Y; return true;
+        case ParameterManager::PARAM_V_Z_DISPLACE: mapping.layer = LAYER_VIDEO_REACTIVE; mapping.scaleGroup = SCALE_Z; return true;
+        case ParameterManager::PARAM_V_ROTATE: mapping.layer = LAYER_VIDEO_REACTIVE; mapping.scaleGroup = SCALE_ROTATE; return true;
+        case ParameterManager::PARAM_V_HUE_OFFSET: mapping.layer = LAYER_VIDEO_REACTIVE; mapping.scaleGroup = SCALE_HUE_OFFSET; return true;
+        case ParameterManager::PARAM_V_HUE_LFO: mapping.layer = LAYER_VIDEO_REACTIVE; mapping.scaleGroup = SCALE_HUE_LFO; return true;
+        case ParameterManager::PARAM_V_HUE_MODULATION:
+            mapping.layer = LAYER_VIDEO_REACTIVE;
+            mapping.minValue = 0.0f;
+            mapping.maxValue = 127.0f / 32.0f;
+            mapping.scaleGroup = SCALE_HUE_MOD;
+            return true;
+
+        // Frequencies have no sensible default range
+        default:
+            return false;
+    }
+}
+
+void MidiMappingTable::addLegacyControls() {
+    // Transport and actions
+    addAction(55, TARGET_RECORD);
+    addAction(39, TARGET_VIDEO_REACTIVE);
+    addAction(58, TARGET_CLEAR_BUFFERS);
+    addAction(59, TARGET_RESET);
+
+    // Scale toggles: x2 / x5 / x10 per group
+    const int scaleBase[SCALE_GROUP_COUNT] = { 32, 33, 34, 35, 36, 37, 38 };
+    for (int group = 0; group < SCALE_GROUP_COUNT; group++) {
+        addAction(scaleBase[group], TARGET_SCALE, 2.0f, group);
+        addAction(scaleBase[group] + 16, TARGET_SCALE, 5.0f, group);
+        addAction(scaleBase[group] + 32, TARGET_SCALE, 10.0f, group);
+    }
+
+    // Effect toggles
+    addToggle(42, ParameterManager::PARAM_HUE_INVERT);
+    addToggle(43, ParameterManager::PARAM_BRIGHTNESS_INVERT);
+    addToggle(44, ParameterManager::PARAM_SATURATION_INVERT);
+    addToggle(41, ParameterManager::PARAM_HORIZONTAL_MIRROR);
+    addToggle(45, ParameterManager::PARAM_VERTICAL_MIRROR);
+    addToggle(46, ParameterManager::PARAM_TOROID_ENABLED);
+    addToggle(61, ParameterManager::PARAM_MIRROR_MODE_ENABLED);
+    addToggle(60, ParameterManager::PARAM_LUMAKEY_INVERT);
+    addToggle(71, ParameterManager::PARAM_WET_MODE_ENABLED, true);
+}
+
+void MidiMappingTable::addAction(int control, Target target, float scaleFactor, int scaleGroup) {
+    Mapping mapping;
+    mapping.target = target;
+    mapping.layer = LAYER_ALWAYS;
+    mapping.scaleFactor = scaleFactor;
+    mapping.scaleGroup = scaleGroup;
+    assign(mapping, -1, control);
+}
+
+void MidiMappingTable::addToggle(int control, int paramIndex, bool inverted) {
+    Mapping mapping;
+    mapping.target = TARGET_TOGGLE;
+    mapping.layer = LAYER_ALWAYS;
+    mapping.paramIndex = paramIndex;
+    mapping.inverted = inverted;
+    assign(mapping, -1, control);
+}
+
+void MidiMappingTable::assign(const Mapping& mapping, int channel, int control) {
+    if (mappings.size() >= static_cast<size_t>(std::numeric_limits<int16_t>::max())) {
+        ofLogError("MidiMappingTable") << "Too many MIDI mappings";
+        return;
+    }
+    int16_t index = static_cast<int16_t>(mappings.size());
+    mappings.push_back(mapping);
+    mappings.back().channel = channel >= 1 && channel <= NUM_CHANNELS ? channel : -1;
+    mappings.back().control = control;
+
+    // Channel 1-16 maps a single channel, anything else listens on all channels
+    int firstChannel = 0;
+    int lastChannel = NUM_CHANNELS - 1;
+    if (channel >= 1 && channel <= NUM_CHANNELS) {
+        firstChannel = lastChannel = channel - 1;
+    }
+
+    for (int ch = firstChannel; ch <= lastChannel; ch++) {
+        // A user mapping replaces a legacy control on the same CC in any layer
+        int16_t always = cells[LAYER_ALWAYS][ch][control];
+        if (mapping.userDefined && always != NO_MAPPING && !mappings[always].userDefined) {
+            cells[LAYER_ALWAYS][ch][control] = NO_MAPPING;
+        }
+        cells[mapping.layer][ch][control] = index;
+    }
+}
+
+void MidiMappingTable::assignNrpn(const Mapping& mapping, int channel, int nrpn) {
+    if (mappings.size() >= static_cast<size_t>(std::numeric_limits<int16_t>::max())) {
+        ofLogError("MidiMappingTable") << "Too many MIDI mappings";
+        return;
+    }
+    int16_t index = static_cast<int16_t>(mappings.size());
+    mappings.push_back(mapping);
+    mappings.back().channel = channel >= 1 && channel <= NUM_CHANNELS ? channel : -1;
+    mappings.back().nrpn = nrpn;
+
+    for (int ch = 0; ch < NUM_CHANNELS; ch++) {
+        if (channel >= 1 && channel <= NUM_CHANNELS && ch != channel - 1) {
+            continue;
+        }
+        nrpnCells[(ch << 14) | nrpn] = index;
+        nrpnChannelMask |= (1 << ch);
+    }
+}
+
+void MidiMappingTable::loadSpecs(ofxXmlSettings& xml, std::vector<MappingSpec>& specs) {
+    specs.clear();
+    if (!xml.tagExists("mappings")) {
+        return;
+    }
+    xml.pushTag("mappings");
+    int numMappings = xml.getNumTags("mapping");
+    for (int i = 0; i < numMappings; i++) {
+        MappingSpec spec;
+        spec.paramId = xml.getAttribute("mapping", "param", std::string(""), i);
+        spec.channel = xml.getAttribute("mapping", "channel", -1, i);
+        spec.control = xml.getAttribute("mapping", "control", -1, i);
+        spec.nrpn = xml.getAttribute("mapping", "nrpn", -1, i);
+        spec.highResolution = xml.getAttribute("mapping", "resolution", 7, i) == 14;
+        spec.glideTime = static_cast<float>(xml.getAttribute("mapping", "glide", -1.0, i));
+        spec.curve = curveFromString(xml.getAttribute("mapping", "curve", std::string("linear"), i));
+        spec.pickup = xml.getAttribute("mapping", "pickup", std::string("jump"), i) == "takeover"
+            ? PICKUP_TAKEOVER : PICKUP_JUMP;
+        std::string minStr = xml.getAttribute("mapping", "min", std::string(""), i);
+        std::string maxStr = xml.getAttribute("mapping", "max", std::string(""), i);
+        if (!minStr.empty() && !maxStr.empty()) {
+            spec.hasRange = true;
+            spec.minValue = ofToFloat(minStr);
+            spec.maxValue = ofToFloat(maxStr);
+        }
+        specs.push_back(spec);
+    }
+    xml.popTag(); // pop mappings
+}
+
+void MidiMappingTable::saveSpecs(ofxXmlSettings& xml, const std::vector<MappingSpec>& specs) {
+    if (specs.empty()) {
+        return;
+    }
+    if (!xml.tagExists("mappings")) {
+        xml.addTag("mappings");
+    }
+    xml.pushTag("mappings");
+    while (xml.getNumTags("mapping") > 0) {
+        xml.removeTag("mapping", 0);
+    }
+    for (const auto& spec : specs) {
+        int tagIndex = xml.addTag("mapping");
+        xml.addAttribute("mapping", "param", spec.paramId, tagIndex);
+        xml.addAttribute("mapping", "channel", spec.channel, tagIndex);
+        if (spec.nrpn >= 0) {
+            xml.addAttribute("mapping", "nrpn", spec.nrpn, tagIndex);
+        } else {
+            xml.addAttribute("mapping", "control", spec.control, tagIndex);
+            xml.addAttribute("mapping", "resolution", spec.highResolution ? 14 : 7, tagIndex);
+        }
+        if (spec.glideTime >= 0.0f) {
+            xml.addAttribute("mapping", "glide", static_cast<double>(spec.glideTime), tagIndex);
+        }
+        xml.addAttribute("mapping", "curve", curveToString(spec.curve), tagIndex);
+        xml.addAttribute("mapping", "pickup", std::string(spec.pickup == PICKUP_TAKEOVER ? "takeover" : "jump"), tagIndex);
+        if (spec.hasRange) {
+            xml.addAttribute("mapping", "min", static_cast<double>(spec.minValue), tagIndex);
+            xml.addAttribute("mapping", "max", static_cast<double>(spec.maxValue), tagIndex);
+        }
+    }
+    xml.popTag(); // pop mappings
+}
+
+MidiMappingTable::Curve MidiMappingTable::curveFromString(const std::string& name) {
+    if (name == "exp" || name == "exponential") return CURVE_EXPONENTIAL;
+    if (name == "log" || name == "logarithmic") return CURVE_LOGARITHMIC;
+    if (name == "s" || name == "scurve") return CURVE_S;
+    return CURVE_LINEAR;
+}
+
+std::string MidiMappingTable::curveToString(Curve curve) {
+    switch (curve) {
+        case CURVE_EXPONENTIAL: return "exp";
+        case CURVE_LOGARITHMIC: return "log";
+        case CURVE_S: return "scurve";
+        default: return "linear";
+    }
+}
+
+size_t MidiMappingTable::getMemoryBytes() const {
+    // Node-based map: entry plus roughly two pointers of bucket and node overhead
+    return sizeof(*this) + mappings.capacity() * sizeof(Mapping) +
+           nrpnCells.size() * (sizeof(std::pair<const int, int16_t>) + 2 * sizeof(void*));
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxXmlSettings.h"
+#include "ParameterManager.h"
+#include "MidiPickup.h"
+
+/**
+ * @class MidiMappingTable
+ * @brief Compiled lookup table from (channel, CC) to parameter mappings
+ *
+ * The table is built once from the parameter mappings in settings.xml plus the
+ * legacy hard-wired controls (record, reset, scale toggles, effect toggles) and
+ * is never modified afterwards. MidiManager swaps in a freshly built table when
+ * mappings change, so resolving a control change is a direct array index.
+ */
+class MidiMappingTable {
+public:
+    static const int NUM_CHANNELS = 16;
+    static const int NUM_CONTROLS = 128;
+
+    // Mode layers. LAYER_ALWAYS is checked first, then the layer for the current mode
+    enum Layer {
+        LAYER_ALWAYS = 0, LAYER_NORMAL, LAYER_VIDEO_REACTIVE, LAYER_LFO_AMP, LAYER_LFO_RATE,
+        LAYER_COUNT
+    };
+
+    enum Target {
+        TARGET_PARAMETER,       // Continuous parameter
+        TARGET_TOGGLE,          // Boolean parameter, on at 127
+        TARGET_RECORD,          // P-Lock record start/stop
+        TARGET_VIDEO_REACTIVE,  // Video reactive mode (disables P-Lock recording)
+        TARGET_CLEAR_BUFFERS,   // Clear feedback buffers
+        TARGET_RESET,           // Reset all parameters
+        TARGET_SCALE            // Scale group multiplier toggle
+    };
+
+    enum Curve { CURVE_LINEAR, CURVE_EXPONENTIAL, CURVE_LOGARITHMIC, CURVE_S };
+    enum Pickup { PICKUP_JUMP, PICKUP_TAKEOVER };
+
+    enum ScaleGroup {
+        SCALE_NONE = -1,
+        SCALE_X = 0, SCALE_Y, SCALE_Z, SCALE_ROTATE, SCALE_HUE_MOD, SCALE_HUE_OFFSET, SCALE_HUE_LFO,
+        SCALE_GROUP_COUNT
+    };
+
+    struct Mapping {
+        Target target = TARGET_PARAMETER;
+        Layer layer = LAYER_NORMAL;
+        int paramIndex = -1;
+        Curve curve = CURVE_LINEAR;
+        Pickup pickup = PICKUP_JUMP;
+        float minValue = 0.0f;
+        float maxValue = 1.0f;
+        int scaleGroup = SCALE_NONE;
+        float scaleFactor = 1.0f; // TARGET_SCALE: 2, 5 or 10
+        bool inverted = false;    // Toggle is "on" at value 0 (wet mode)
+        bool userDefined = false; // From settings.xml rather than the legacy layout
+        bool highResolution = false; // 14-bit: MSB on CC 0-31, LSB on CC+32
+        float glideTime = -1.0f;     // Seconds to glide to a new value, <0 = MidiManager default
+        int channel = -1;            // Address, kept for MIDI feedback: 1-16 or -1 = omni
+        int control = -1;
+        int nrpn = -1;
+
+        // Map a 0-1 controller position through the curve into [minValue, maxValue]
+        float apply(float normalized) const;
+        // Inverse of apply(): controller position for a parameter value
+        float normalize(float value) const;
+    };
+
+    // Optional per-mapping overrides from <midi><mappings><mapping .../></mappings>
+    struct MappingSpec {
+        std::string paramId;
+        int channel = -1;  // 1-16, -1 = omni
+        int control = -1;
+        int nrpn = -1;     // 0-16383, replaces control when set
+        bool highResolution = false;
+        float glideTime = -1.0f;
+        Curve curve = CURVE_LINEAR;
+        Pickup pickup = PICKUP_JUMP;
+        bool hasRange = false;
+        float minValue = 0.0f;
+        float maxValue = 1.0f;
+    };
+
+    MidiMappingTable();
+
+    // Compile the table from the parameter manager's channel/control maps
+    void build(const ParameterManager& params, const std::vector<MappingSpec>& specs);
+
+    // Returns the mapping index for a message, or -1 if unmapped. Channel is 1-16
+    int find(Layer activeLayer, int channel, int control) const;
+    int findNrpn(Layer activeLayer, int channel, int nrpn) const;
+    bool hasNrpnMappings(int channel) const;
+    const Mapping& getMapping(int index) const { return mappings[index]; }
+    size_t getNumMappings() const { return mappings.size(); }
+    size_t getMemoryBytes() const; // Approximate, for MemoryTracker
+
+    // Soft takeover: returns true once the control has reached the parameter's value
+    bool checkPickup(int index, float incoming, float current, float threshold) const;
+    // MIDI set the parameter; any other change to it makes its mappings pick up again
+    void noteWritten(int paramIndex, float value) const;
+
+    // XML helpers for MappingSpec lists
+    static void loadSpecs(ofxXmlSettings& xml, std::vector<MappingSpec>& specs);
+    static void saveSpecs(ofxXmlSettings& xml, const std::vector<MappingSpec>& specs);
+
+    static Curve curveFromString(const std::string& name);
+    static std::string curveToString(Curve curve);
+
+private:
+    static const int16_t NO_MAPPING = -1;
+
+    // Default target, layer, range and scale group for a parameter; false if not MIDI-mappable
+    static bool makeDefaultMapping(int paramIndex, Mapping& mapping);
+
+    void addLegacyControls();
+    void addAction(int control, Target target, float scaleFactor = 1.0f, int scaleGroup = SCALE_NONE);
+    void addToggle(int control, int paramIndex, bool inverted = false);
+    void assign(const Mapping& mapping, int channel, int control);
+    void assignNrpn(const Mapping& mapping, int channel, int nrpn);
+
+    std::vector<Mapping> mappings;
+    int16_t cells[LAYER_COUNT][NUM_CHANNELS][NUM_CONTROLS];
+
+    // NRPN mappings are sparse, keyed by (channel << 14) | nrpn
+    std::unordered_map<int, int16_t> nrpnCells;
+    uint16_t nrpnChannelMask = 0;
+
+    // Pickup state per mapping. Only touched by the thread that processes messages
+    mutable std::vector<MidiPickup> pickupStates;
+};
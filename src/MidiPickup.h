@@ -0,0 +1,61 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @struct MidiPickup
+ * @brief Soft takeover state of one MIDI mapping
+ *
+ * A control is ignored until it reaches (or crosses) the parameter's current
+ * value, so moving a knob that is out of step with the parameter doesn't
+ * make the value jump. Once engaged it follows the control until something
+ * other than MIDI moves the parameter (a preset, a reset, OSC, the
+ * keyboard); the next control change then has to pick the value up again.
+ *
+ * No openFrameworks dependency, so it can be tested on its own.
+ */
+struct MidiPickup {
+    static constexpr float CHANGED_EPSILON = 1e-4f; // Normalized; below this the value is still ours
+
+    bool engaged = false;
+    bool hasLast = false;
+    float lastIncoming = 0.0f;
+    bool hasWritten = false;
+    float written = 0.0f; // Last value MIDI gave the parameter
+
+    // True if the control may set the parameter. range is the mapping's span, threshold is normalized
+    bool check(float incoming, float current, float range, float threshold) {
+        // Compare in normalized units so the threshold works for any range
+        range = std::max(std::abs(range), 1e-6f);
+        if (hasWritten && std::abs(current - written) / range > CHANGED_EPSILON) {
+            release(); // Moved by another source since
+        }
+        if (engaged) {
+            return true;
+        }
+
+        float diff = (incoming - current) / range;
+        float lastDiff = (lastIncoming - current) / range;
+
+        // Engage when close enough or when the control has crossed the current value
+        if (std::abs(diff) < threshold || (hasLast && (diff > 0.0f) != (lastDiff > 0.0f))) {
+            engaged = true;
+        }
+        lastIncoming = incoming;
+        hasLast = true;
+        return engaged;
+    }
+
+    // After MIDI set the parameter, directly or by one glide step
+    void noteWritten(float value) {
+        written = value;
+        hasWritten = true;
+    }
+
+    void release() {
+        engaged = false;
+        hasLast = false;
+        hasWritten = false;
+    }
+};
@@ -0,0 +1,329 @@
+#include "ModulationMatrix.h"
+
+ModulationMatrix::ModulationMatrix(int numDestinations)
+    : numDestinations(numDestinations),
+      offsets(numDestinations, 0.0f),
+      scales(numDestinations, 1.0f) {
+}
+
+void ModulationMatrix::process(double seconds, uint64_t nowMicros, float deltaTime, const Transport& transport) {
+    // Sources computed here; audio and luma were set by their owners earlier in the frame
+    updateLfos(seconds, nowMicros, transport);
+    double beats = transport.getBeatPosition(nowMicros);
+    sources[SOURCE_BEAT_PHASE] = static_cast<float>(beats - std::floor(beats));
+    sources[SOURCE_BAR_PHASE] = static_cast<float>(beats / 4.0 - std::floor(beats / 4.0));
+    updateEnvelopes(deltaTime);
+
+    // Every route at once: gather sources, then accumulate into the destinations
+    for (int r = 0; r < routeCount; r++) {
+        float value = routeOffset[r] + sources[routeSource[r]] * routeDepth[r];
+        contribution[r] = std::min(std::max(value, routeMin[r]), routeMax[r]);
+    }
+    std::fill(offsets.begin(), offsets.end(), 0.0f);
+    std::fill(scales.begin(), scales.end(), 1.0f);
+    for (int r = 0; r < routeCount; r++) {
+        float* target = routeMultiply[r] ? scales.data() : offsets.data();
+        target[routeDestination[r]] += contribution[r];
+    }
+}
+
+void ModulationMatrix::updateLfos(double seconds, uint64_t nowMicros, const Transport& transport) {
+    for (int i = 0; i < NUM_LFOS; i++) {
+        const Lfo& lfo = lfos[i];
+        double phase = lfo.sync ? transport.getSyncedLfoPhase(lfo.rate, nowMicros) : seconds * lfo.rate;
+        sources[SOURCE_LFO_1 + i] = lfo.level * waveform(lfo.waveform, phase, i);
+    }
+}
+
+void ModulationMatrix::updateEnvelopes(float deltaTime) {
+    for (int i = 0; i < NUM_ENVELOPES; i++) {
+        const Envelope& envelope = envelopes[i];
+        EnvelopeState& state = envelopeStates[i];
+
+        // Fire on the rising edge only, so a held source doesn't retrigger
+        bool high = envelope.triggerSource >= 0 && sources[envelope.triggerSource] > envelope.threshold;
+        if (state.pending || (high && !state.triggerHigh)) {
+            state.attacking = true;
+        }
+        state.triggerHigh = high;
+        state.pending = false;
+
+        if (state.attacking) {
+            state.level += envelope.attack > 0.0f ? deltaTime / envelope.attack : 1.0f;
+            if (state.level >= 1.0f) {
+                state.level = 1.0f;
+                state.attacking = false;
+            }
+        } else {
+            state.level -= envelope.release > 0.0f ? deltaTime / envelope.release : 1.0f;
+            state.level = std::max(0.0f, state.level);
+        }
+        sources[SOURCE_ENVELOPE_1 + i] = state.level;
+    }
+}
+
+float ModulationMatrix::waveform(Waveform shape, double phase, int seed) {
+    double cycles = phase / TWO_PI;
+    float t = static_cast<float>(cycles - std::floor(cycles)); // 0..1 within the cycle
+
+    switch (shape) {
+        case WAVE_TRIANGLE:
+            return t < 0.25f ? 4.0f * t : (t < 0.75f ? 2.0f - 4.0f * t : 4.0f * t - 4.0f);
+        case WAVE_SAW:
+            return 2.0f * t - 1.0f;
+        case WAVE_SQUARE:
+            return t < 0.5f ? 1.0f : -1.0f;
+        case WAVE_RANDOM: {
+            // New value each cycle; hashing the cycle number keeps it stateless
+            uint32_t x = static_cast<uint32_t>(static_cast<int64_t>(std::floor(cycles))) * 2654435761u ^ (seed * 40503u);
+            x ^= x >> 16; x *= 0x7feb352du;
+            x ^= x >> 15; x *= 0x846ca68bu;
+            x ^= x >> 16;
+            return static_cast<float>(x) / 4294967295.0f * 2.0f - 1.0f;
+        }
+        case WAVE_SINE:
+        default:
+            return static_cast<float>(std::sin(phase));
+    }
+}
+
+void ModulationMatrix::setAudio(const float* bands, int numBands, float level) {
+    int count = std::min(numBands, MAX_AUDIO_BANDS);
+    std::copy(bands, bands + count, sources + SOURCE_AUDIO_BAND_1);
+    std::fill(sources + SOURCE_AUDIO_BAND_1 + count, sources + SOURCE_AUDIO_LEVEL, 0.0f);
+    sources[SOURCE_AUDIO_LEVEL] = level;
+}
+
+void ModulationMatrix::clearAudio() {
+    std::fill(sources + SOURCE_AUDIO_BAND_1, sources + SOURCE_AUDIO_LEVEL + 1, 0.0f);
+}
+
+void ModulationMatrix::analyzeLuma(const ofPixels& pixels) {
+    int width = pixels.getWidth();
+    int height = pixels.getHeight();
+    int channels = pixels.getNumChannels();
+    const unsigned char* data = pixels.getData();
+    if (!pixels.isAllocated() || !data || width <= 0 || height <= 0) {
+        return;
+    }
+
+    // A coarse grid is plenty for frame-level statistics
+    float sum = 0.0f;
+    float sumSquares = 0.0f;
+    float motion = 0.0f;
+    for (int gy = 0; gy < LUMA_GRID_HEIGHT; gy++) {
+        int y = (gy * 2 + 1) * height / (LUMA_GRID_HEIGHT * 2);
+        for (int gx = 0; gx < LUMA_GRID_WIDTH; gx++) {
+            int x = (gx * 2 + 1) * width / (LUMA_GRID_WIDTH * 2);
+            const unsigned char* p = data + (static_cast<size_t>(y) * width + x) * channels;
+            float luma = channels >= 3 ? (0.299f * p[0] + 0.587f * p[1] + 0.114f * p[2]) / 255.0f : p[0] / 255.0f;
+
+            float& previous = lumaGrid[gy * LUMA_GRID_WIDTH + gx];
+            motion += std::abs(luma - previous);
+            previous = luma;
+            sum += luma;
+            sumSquares += luma * luma;
+        }
+    }
+
+    const float count = LUMA_GRID_WIDTH * LUMA_GRID_HEIGHT;
+    float mean = sum / count;
+    sources[SOURCE_LUMA_MEAN] = mean;
+    sources[SOURCE_LUMA_CONTRAST] = std::sqrt(std::max(0.0f, sumSquares / count - mean * mean));
+    sources[SOURCE_LUMA_MOTION] = hasLumaGrid ? motion / count : 0.0f;
+    hasLumaGrid = true;
+}
+
+void ModulationMatrix::trigger(int envelope) {
+    if (envelope >= 0 && envelope < NUM_ENVELOPES) {
+        envelopeStates[envelope].pending = true;
+    }
+}
+
+int ModulationMatrix::addRoute(int group, int source, int destination, float depth, bool multiply,
+                               float offset, float min, float max) {
+    if (routeCount >= MAX_ROUTES || source < 0 || source >= SOURCE_COUNT ||
+        destination < 0 || destination >= numDestinations) {
+        return -1;
+    }
+    int r = routeCount++;
+    routeGroup[r] = group;
+    routeSource[r] = source;
+    routeDestination[r] = destination;
+    routeDepth[r] = depth;
+    routeOffset[r] = offset;
+    routeMin[r] = min;
+    routeMax[r] = max;
+    routeMultiply[r] = multiply;
+    return r;
+}
+
+void ModulationMatrix::removeRoutes(int group) {
+    int kept = 0;
+    for (int r = 0; r < routeCount; r++) {
+        if (routeGroup[r] == group) {
+            continue;
+        }
+        routeGroup[kept] = routeGroup[r];
+        routeSource[kept] = routeSource[r];
+        routeDestination[kept] = routeDestination[r];
+        routeDepth[kept] = routeDepth[r];
+        routeOffset[kept] = routeOffset[r];
+        routeMin[kept] = routeMin[r];
+        routeMax[kept] = routeMax[r];
+        routeMultiply[kept] = routeMultiply[r];
+        kept++;
+    }
+    routeCount = kept;
+}
+
+void ModulationMatrix::setRouteDepth(int route, float depth) {
+    if (route >= 0 && route < routeCount) {
+        routeDepth[route] = depth;
+    }
+}
+
+std::string ModulationMatrix::getSourceName(int source) {
+    if (source >= SOURCE_LFO_1 && source < SOURCE_ENVELOPE_1) return "lfo" + ofToString(source - SOURCE_LFO_1 + 1);
+    if (source >= SOURCE_ENVELOPE_1 && source < SOURCE_AUDIO_BAND_1) return "env" + ofToString(source - SOURCE_ENVELOPE_1 + 1);
+    if (source >= SOURCE_AUDIO_BAND_1 && source < SOURCE_AUDIO_LEVEL) return "audio" + ofToString(source - SOURCE_AUDIO_BAND_1 + 1);
+    switch (source) {
+        case SOURCE_AUDIO_LEVEL: return "audioLevel";
+        case SOURCE_BEAT_PHASE: return "beat";
+        case SOURCE_BAR_PHASE: return "bar";
+        case SOURCE_LUMA_MEAN: return "lumaMean";
+        case SOURCE_LUMA_CONTRAST: return "lumaContrast";
+        case SOURCE_LUMA_MOTION: return "lumaMotion";
+        default: return "";
+    }
+}
+
+int ModulationMatrix::findSource(const std::string& name) {
+    for (int i = 0; i < SOURCE_COUNT; i++) {
+        if (getSourceName(i) == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+std::string ModulationMatrix::getWaveformName(Waveform waveform) {
+    switch (waveform) {
+        case WAVE_TRIANGLE: return "triangle";
+        case WAVE_SAW: return "saw";
+        case WAVE_SQUARE: return "square";
+        case WAVE_RANDOM: return "random";
+        case WAVE_SINE:
+        default: return "sine";
+    }
+}
+
+ModulationMatrix::Waveform ModulationMatrix::findWaveform(const std::string& name) {
+    for (int i = 0; i < WAVE_COUNT; i++) {
+        if (getWaveformName(static_cast<Waveform>(i)) == name) {
+            return static_cast<Waveform>(i);
+        }
+    }
+    return WAVE_SINE;
+}
+
+void ModulationMatrix::loadFromXml(ofxXmlSettings& xml, const std::vector<std::string>& destinationIds) {
+    if (!xml.tagExists("modulation")) {
+        return;
+    }
+    xml.pushTag("modulation");
+
+    int numLfos = xml.getNumTags("lfo");
+    for (int i = 0; i < numLfos; i++) {
+        int index = xml.getAttribute("lfo", "index", -1, i);
+        if (index < 0 || index >= NUM_LFOS) {
+            continue;
+        }
+        Lfo& lfo = lfos[index];
+        lfo.waveform = findWaveform(xml.getAttribute("lfo", "waveform", std::string("sine"), i));
+        lfo.rate = xml.getAttribute("lfo", "rate", (double)lfo.rate, i);
+        lfo.level = xml.getAttribute("lfo", "level", (double)lfo.level, i);
+        lfo.sync = xml.getAttribute("lfo", "sync", 0, i) != 0;
+    }
+
+    int numEnvelopes = xml.getNumTags("envelope");
+    for (int i = 0; i < numEnvelopes; i++) {
+        int index = xml.getAttribute("envelope", "index", -1, i);
+        if (index < 0 || index >= NUM_ENVELOPES) {
+            continue;
+        }
+        Envelope& envelope = envelopes[index];
+        envelope.triggerSource = findSource(xml.getAttribute("envelope", "trigger", std::string(""), i));
+        envelope.threshold = xml.getAttribute("envelope", "threshold", (double)envelope.threshold, i);
+        envelope.attack = std::max(0.0, xml.getAttribute("envelope", "attack", (double)envelope.attack, i));
+        envelope.release = std::max(0.0, xml.getAttribute("envelope", "release", (double)envelope.release, i));
+    }
+
+    removeRoutes(GROUP_USER);
+    int numRoutes = xml.getNumTags("route");
+    for (int i = 0; i < numRoutes; i++) {
+        std::string sourceName = xml.getAttribute("route", "source", std::string(""), i);
+        std::string destinationId = xml.getAttribute("route", "dest", std::string(""), i);
+        int source = findSource(sourceName);
+        int destination = std::find(destinationIds.begin(), destinationIds.end(), destinationId) - destinationIds.begin();
+        if (source < 0 || destination >= (int)destinationIds.size()) {
+            ofLogWarning("ModulationMatrix") << "Skipping route " << sourceName << " -> " << destinationId;
+            continue;
+        }
+        int route = addRoute(GROUP_USER, source, destination,
+                             xml.getAttribute("route", "depth", 0.0, i),
+                             xml.getAttribute("route", "mode", std::string("add"), i) == "multiply",
+                             xml.getAttribute("route", "offset", 0.0, i),
+                             xml.getAttribute("route", "min", (double)-FLT_MAX, i),
+                             xml.getAttribute("route", "max", (double)FLT_MAX, i));
+        if (route < 0) {
+            ofLogWarning("ModulationMatrix") << "Route limit (" << MAX_ROUTES << ") reached";
+            break;
+        }
+    }
+
+    xml.popTag(); // pop modulation
+}
+
+void ModulationMatrix::saveToXml(ofxXmlSettings& xml, const std::vector<std::string>& destinationIds) const {
+    if (xml.tagExists("modulation")) {
+        xml.removeTag("modulation");
+    }
+    xml.addTag("modulation");
+    xml.pushTag("modulation");
+
+    for (int i = 0; i < NUM_LFOS; i++) {
+        int tag = xml.addTag("lfo");
+        xml.addAttribute("lfo", "index", i, tag);
+        xml.addAttribute("lfo", "waveform", getWaveformName(lfos[i].waveform), tag);
+        xml.addAttribute("lfo", "rate", lfos[i].rate, tag);
+        xml.addAttribute("lfo", "level", lfos[i].level, tag);
+        xml.addAttribute("lfo", "sync", lfos[i].sync ? 1 : 0, tag);
+    }
+
+    for (int i = 0; i < NUM_ENVELOPES; i++) {
+        int tag = xml.addTag("envelope");
+        xml.addAttribute("envelope", "index", i, tag);
+        xml.addAttribute("envelope", "trigger", getSourceName(envelopes[i].triggerSource), tag);
+        xml.addAttribute("envelope", "threshold", envelopes[i].threshold, tag);
+        xml.addAttribute("envelope", "attack", envelopes[i].attack, tag);
+        xml.addAttribute("envelope", "release", envelopes[i].release, tag);
+    }
+
+    // Built-in and audio routes are recreated by their owners
+    for (int r = 0; r < routeCount; r++) {
+        if (routeGroup[r] != GROUP_USER || routeDestination[r] >= (int)destinationIds.size()) {
+            continue;
+        }
+        int tag = xml.addTag("route");
+        xml.addAttribute("route", "source", getSourceName(routeSource[r]), tag);
+        xml.addAttribute("route", "dest", destinationIds[routeDestination[r]], tag);
+        xml.addAttribute("route", "depth", routeDepth[r], tag);
+        xml.addAttribute("route", "mode", std::string(routeMultiply[r] ? "multiply" : "add"), tag);
+        if (routeOffset[r] != 0.0f) xml.addAttribute("route", "offset", routeOffset[r], tag);
+        if (routeMin[r] != -FLT_MAX) xml.addAttribute("route", "min", routeMin[r], tag);
+        if (routeMax[r] != FLT_MAX) xml.addAttribute("route", "max", routeMax[r], tag);
+    }
+
+    xml.popTag(); // pop modulation
+}
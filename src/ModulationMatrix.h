@@ -0,0 +1,140 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxXmlSettings.h"
+#include "Transport.h"
+#include <cfloat>
+
+/**
+ * @class ModulationMatrix
+ * @brief Routes modulation sources to any parameter with per-route depth
+ *
+ * Sources are LFOs with selectable waveforms, attack/release envelopes,
+ * audio bands and level, the transport's beat and bar phase, and statistics
+ * of the input image. Each route scales one source onto one destination,
+ * either added to the value or as a multiplier (1 + contribution).
+ *
+ * process() runs once per frame: sources are updated, then every route is
+ * evaluated in one pass over structure-of-arrays route storage. Storage is
+ * sized at construction, so nothing allocates per frame.
+ */
+class ModulationMatrix {
+public:
+    static const int NUM_LFOS = 8;
+    static const int NUM_ENVELOPES = 4;
+    static const int MAX_AUDIO_BANDS = 16;
+    static const int MAX_ROUTES = 64;
+
+    enum Source {
+        SOURCE_LFO_1 = 0,
+        SOURCE_ENVELOPE_1 = SOURCE_LFO_1 + NUM_LFOS,
+        SOURCE_AUDIO_BAND_1 = SOURCE_ENVELOPE_1 + NUM_ENVELOPES,
+        SOURCE_AUDIO_LEVEL = SOURCE_AUDIO_BAND_1 + MAX_AUDIO_BANDS,
+        SOURCE_BEAT_PHASE,      // 0..1 per beat
+        SOURCE_BAR_PHASE,       // 0..1 per 4/4 bar
+        SOURCE_LUMA_MEAN,       // Average input brightness, 0..1
+        SOURCE_LUMA_CONTRAST,   // Standard deviation of input brightness
+        SOURCE_LUMA_MOTION,     // Mean brightness change since the previous frame
+        SOURCE_COUNT
+    };
+
+    enum Waveform { WAVE_SINE = 0, WAVE_TRIANGLE, WAVE_SAW, WAVE_SQUARE, WAVE_RANDOM, WAVE_COUNT };
+
+    // Routes are grouped by who owns them so each owner can replace its own set
+    enum Group { GROUP_BUILTIN = 0, GROUP_USER, GROUP_AUDIO };
+
+    struct Lfo {
+        Waveform waveform = WAVE_SINE;
+        float rate = 0.0f;    // Radians per second, or cycles per beat when synced (see Transport)
+        float level = 1.0f;   // Output is level * wave, wave in -1..1
+        bool sync = false;
+    };
+
+    // Attack/release envelope, fired by a source rising through a threshold or by trigger()
+    struct Envelope {
+        int triggerSource = -1; // -1 = manual only
+        float threshold = 0.5f;
+        float attack = 0.01f;   // Seconds
+        float release = 0.25f;  // Seconds
+    };
+
+    explicit ModulationMatrix(int numDestinations);
+
+    // Per-frame: update sources, then evaluate all routes
+    void process(double seconds, uint64_t nowMicros, float deltaTime, const Transport& transport);
+
+    // Results of the last process(), one entry per destination
+    const float* getOffsets() const { return offsets.data(); }
+    const float* getScales() const { return scales.data(); }
+    float getOffset(int destination) const { return offsets[destination]; }
+    float getScale(int destination) const { return scales[destination]; }
+
+    // Sources fed from outside
+    void setAudio(const float* bands, int numBands, float level);
+    void clearAudio();
+    void analyzeLuma(const ofPixels& pixels); // Subsampled; call with each new input frame
+    float getSourceValue(int source) const { return sources[source]; }
+
+    Lfo& getLfo(int index) { return lfos[index]; }
+    const Lfo& getLfo(int index) const { return lfos[index]; }
+    Envelope& getEnvelope(int index) { return envelopes[index]; }
+    const Envelope& getEnvelope(int index) const { return envelopes[index]; }
+    void trigger(int envelope);
+
+    // Routes; contribution = clamp(offset + source * depth, min, max)
+    int addRoute(int group, int source, int destination, float depth, bool multiply = false,
+                 float offset = 0.0f, float min = -FLT_MAX, float max = FLT_MAX); // Index, or -1 when full
+    void removeRoutes(int group);
+    void setRouteDepth(int route, float depth);
+    int getNumRoutes() const { return routeCount; }
+
+    // Names used in settings.xml
+    static std::string getSourceName(int source);
+    static int findSource(const std::string& name); // -1 if unknown
+    static std::string getWaveformName(Waveform waveform);
+    static Waveform findWaveform(const std::string& name);
+
+    // <modulation> settings: LFOs, envelopes and GROUP_USER routes; destinations by parameter ID
+    void loadFromXml(ofxXmlSettings& xml, const std::vector<std::string>& destinationIds);
+    void saveToXml(ofxXmlSettings& xml, const std::vector<std::string>& destinationIds) const;
+
+private:
+    static const int LUMA_GRID_WIDTH = 32;
+    static const int LUMA_GRID_HEIGHT = 18;
+
+    void updateLfos(double seconds, uint64_t nowMicros, const Transport& transport);
+    void updateEnvelopes(float deltaTime);
+    static float waveform(Waveform shape, double phase, int seed); // phase in radians
+
+    int numDestinations;
+    float sources[SOURCE_COUNT] = {};
+
+    Lfo lfos[NUM_LFOS];
+    Envelope envelopes[NUM_ENVELOPES];
+    struct EnvelopeState {
+        float level = 0.0f;
+        bool attacking = false;
+        bool triggerHigh = false; // Trigger source was above threshold last frame
+        bool pending = false;     // trigger() since the last process()
+    };
+    EnvelopeState envelopeStates[NUM_ENVELOPES];
+
+    // Routes, structure of arrays
+    int routeCount = 0;
+    int routeGroup[MAX_ROUTES];
+    int routeSource[MAX_ROUTES];
+    int routeDestination[MAX_ROUTES];
+    float routeDepth[MAX_ROUTES];
+    float routeOffset[MAX_ROUTES];
+    float routeMin[MAX_ROUTES];
+    float routeMax[MAX_ROUTES];
+    bool routeMultiply[MAX_ROUTES];
+    float contribution[MAX_ROUTES];
+
+    std::vector<float> offsets; // Added to the destination
+    std::vector<float> scales;  // Destination multiplier
+
+    // Previous frame's luma grid for motion
+    float lumaGrid[LUMA_GRID_WIDTH * LUMA_GRID_HEIGHT] = {};
+    bool hasLumaGrid = false;
+};
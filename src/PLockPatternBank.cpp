@@ -0,0 +1,194 @@
+#include "PLockPatternBank.h"
+
+#ifndef TARGET_WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+PLockPatternBank::PLockPatternBank(int numLanes, int maxSteps, int defaultLength)
+    : numLanes(numLanes), maxSteps(maxSteps), defaultLength(defaultLength) {
+    static_assert(sizeof(FileHeader) == 64, "Pattern bank header must stay 64 bytes");
+
+    size_t meta = sizeof(PLockPattern::Info) + 2 * sizeof(int32_t) * numLanes;
+    metaSize = (meta + 63) & ~static_cast<size_t>(63);
+    patternStride = metaSize + sizeof(float) * numLanes * maxSteps;
+
+    // Usable straight away; open() moves the bank into the file
+    useMemory();
+    initialize();
+}
+
+PLockPatternBank::~PLockPatternBank() {
+    close();
+}
+
+void PLockPatternBank::useMemory() {
+    memory.assign(getFileSize(), 0);
+    data = memory.data();
+    mapped = false;
+}
+
+bool PLockPatternBank::open(const std::string& path) {
+    close();
+    filePath = path;
+    created = false;
+    if (!setAsideIncompatible(path)) {
+        filePath.clear(); // flush() mustn't overwrite it either
+        useMemory();
+        initialize();
+        created = true;
+        return false;
+    }
+
+#ifndef TARGET_WIN32
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd >= 0) {
+        struct stat info;
+        bool sizeOk = fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == getFileSize();
+        if (!sizeOk) {
+            // New or empty (anything else was moved aside); ftruncate zero-fills
+            created = ftruncate(fd, 0) == 0 && ftruncate(fd, getFileSize()) == 0;
+        }
+        void* region = (sizeOk || created)
+            ? mmap(nullptr, getFileSize(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+            : MAP_FAILED;
+        if (region != MAP_FAILED) {
+            memory.clear();
+            memory.shrink_to_fit();
+            data = static_cast<uint8_t*>(region);
+            mapped = true;
+            fileDescriptor = fd;
+            if (!created && !isCompatible(*reinterpret_cast<const FileHeader*>(data))) {
+                created = true;
+            }
+            if (created) {
+                initialize();
+                ofLogNotice("PLockPatternBank") << "Created pattern bank " << path;
+            } else {
+                ofLogNotice("PLockPatternBank") << "Mapped pattern bank " << path;
+            }
+            return true;
+        }
+        ::close(fd);
+    }
+    ofLogWarning("PLockPatternBank") << "Could not map " << path << ", keeping patterns in memory";
+#endif
+
+    // Fallback: read the whole file into memory, flush() writes it back
+    useMemory();
+    std::ifstream file(path, std::ios::binary);
+    if (file && file.read(reinterpret_cast<char*>(data), getFileSize()) && isCompatible(*reinterpret_cast<const FileHeader*>(data))) {
+        return true;
+    }
+    created = true;
+    initialize();
+    return false;
+}
+
+void PLockPatternBank::flush() const {
+    if (mapped) {
+#ifndef TARGET_WIN32
+        msync(data, getFileSize(), MS_ASYNC);
+#endif
+    } else if (!filePath.empty()) {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data), getFileSize());
+        if (!file) {
+            ofLogError("PLockPatternBank") << "Failed to write " << filePath;
+        }
+    }
+}
+
+bool PLockPatternBank::snapshot(std::string& path, std::string& bytes) const {
+    if (mapped || filePath.empty()) {
+        flush();
+        return false;
+    }
+    path = filePath;
+    bytes.assign(reinterpret_cast<const char*>(data), getFileSize());
+    return true;
+}
+
+void PLockPatternBank::close() {
+    if (!mapped) {
+        return;
+    }
+#ifndef TARGET_WIN32
+    msync(data, getFileSize(), MS_SYNC);
+    munmap(data, getFileSize());
+    ::close(fileDescriptor);
+#endif
+    fileDescriptor = -1;
+    mapped = false;
+    data = nullptr; // Only open() or the destructor call this
+}
+
+bool PLockPatternBank::isCompatible(const FileHeader& header) const {
+    return std::memcmp(header.magic, "NPPL", 4) == 0 &&
+           header.version == FILE_VERSION &&
+           header.numPatterns == static_cast<uint32_t>(NUM_PATTERNS) &&
+           header.numLanes == static_cast<uint32_t>(numLanes) &&
+           header.maxSteps == static_cast<uint32_t>(maxSteps);
+}
+
+bool PLockPatternBank::setAsideIncompatible(const std::string& path) const {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return true; // Nothing there yet
+    }
+    std::streamoff size = file.tellg();
+    FileHeader header;
+    bool compatible = size == static_cast<std::streamoff>(getFileSize()) && file.seekg(0) &&
+                      file.read(reinterpret_cast<char*>(&header), sizeof(header)) && isCompatible(header);
+    file.close();
+    if (compatible || size == 0) {
+        return true;
+    }
+
+    // Another layout or a damaged file: keep the recordings for recovery instead of overwriting them
+    std::string backup = path + "." + ofGetTimestampString("%Y%m%d-%H%M%S") + ".bak";
+    if (std::rename(path.c_str(), backup.c_str()) != 0) {
+        ofLogError("PLockPatternBank") << path << " doesn't match this build and couldn't be moved aside; "
+                                       << "leaving it untouched and keeping patterns in memory";
+        return false;
+    }
+    ofLogError("PLockPatternBank") << path << " doesn't match this build; moved to " << backup << ", starting an empty bank";
+    return true;
+}
+
+void PLockPatternBank::initialize() {
+    FileHeader* header = reinterpret_cast<FileHeader*>(data);
+    std::memset(header, 0, sizeof(FileHeader));
+    std::memcpy(header->magic, "NPPL", 4);
+    header->version = FILE_VERSION;
+    header->numPatterns = NUM_PATTERNS;
+    header->numLanes = numLanes;
+    header->maxSteps = maxSteps;
+
+    for (int i = 0; i < NUM_PATTERNS; i++) {
+        clearPattern(i);
+    }
+}
+
+PLockPattern PLockPatternBank::getPattern(int index) const {
+    index = ofClamp(index, 0, NUM_PATTERNS - 1);
+    uint8_t* base = data + sizeof(FileHeader) + patternStride * index;
+
+    PLockPattern pattern;
+    pattern.info = reinterpret_cast<PLockPattern::Info*>(base);
+    pattern.lengths = reinterpret_cast<int32_t*>(base + sizeof(PLockPattern::Info));
+    pattern.interpolate = pattern.lengths + numLanes;
+    pattern.steps = reinterpret_cast<float*>(base + metaSize);
+    return pattern;
+}
+
+void PLockPatternBank::clearPattern(int index) {
+    PLockPattern pattern = getPattern(index);
+    *pattern.info = PLockPattern::Info();
+    pattern.info->length = defaultLength;
+    std::fill(pattern.lengths, pattern.lengths + numLanes, defaultLength);
+    std::fill(pattern.interpolate, pattern.interpolate + numLanes, 1);
+    std::fill(pattern.steps, pattern.steps + numLanes * maxSteps, 0.0f);
+}
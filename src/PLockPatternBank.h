@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ * @struct PLockPattern
+ * @brief View of one pattern's storage inside a PLockPatternBank
+ *
+ * Plain pointers into the bank, so handing a pattern to the sequencer is a
+ * few pointer copies.
+ */
+struct PLockPattern {
+    struct Info {
+        int32_t length = 0;        // Steps per loop, used for chaining
+        int32_t chainNext = -1;    // Pattern to continue with, -1 = loop this one
+        int32_t chainRepeats = 1;  // Loops before moving on
+        int32_t reserved = 0;
+    };
+
+    Info* info = nullptr;
+    int32_t* lengths = nullptr;      // Per lane
+    int32_t* interpolate = nullptr;  // Per lane, 0 or 1
+    float* steps = nullptr;          // Lane-major, maxSteps per lane
+};
+
+/**
+ * @class PLockPatternBank
+ * @brief Fixed set of P-Lock patterns kept in one binary file
+ *
+ * The file is a small header followed by fixed-size pattern records, and is
+ * memory-mapped at startup so recordings persist as they are made and
+ * switching patterns never copies or parses anything. Where mapping is
+ * unavailable the bank lives in memory and flush() writes the file.
+ */
+class PLockPatternBank {
+public:
+    static const int NUM_PATTERNS = 16;
+
+    PLockPatternBank(int numLanes, int maxSteps, int defaultLength);
+    ~PLockPatternBank();
+
+    // Map (or create) the bank file; on failure the bank stays in memory
+    bool open(const std::string& path);
+    void flush() const; // Make recordings durable; blocks for an unmapped bank
+    // Unmapped: copies the file contents for a write on another thread. Mapped: starts
+    // an asynchronous write-back and returns false, as there is nothing to copy
+    bool snapshot(std::string& path, std::string& bytes) const;
+    void close(); // Unmaps; call open() again before using patterns
+
+    bool isMapped() const { return mapped; }
+    bool wasCreated() const { return created; } // File was new, or an incompatible one was moved aside
+
+    int getNumPatterns() const { return NUM_PATTERNS; }
+    PLockPattern getPattern(int index) const;
+    void clearPattern(int index);
+
+private:
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t numPatterns;
+        uint32_t numLanes;
+        uint32_t maxSteps;
+        uint32_t reserved[11]; // Pad to 64 bytes
+    };
+
+    static const uint32_t FILE_VERSION = 1;
+
+    size_t getFileSize() const { return sizeof(FileHeader) + patternStride * NUM_PATTERNS; }
+    bool isCompatible(const FileHeader& header) const;
+    bool setAsideIncompatible(const std::string& path) const; // Renames a bank of another layout; false if it's still there
+    void initialize(); // Header plus empty patterns
+    void useMemory();
+
+    int numLanes;
+    int maxSteps;
+    int defaultLength;
+    size_t metaSize;      // Info + lengths + interpolate, padded to 64 bytes
+    size_t patternStride; // metaSize + steps
+
+    uint8_t* data = nullptr;
+    std::vector<uint8_t> memory; // Backing store when not mapped
+    bool mapped = false;
+    bool created = false;
+    std::string filePath;
+    int fileDescriptor = -1;
+};
@@ -0,0 +1,125 @@
+#include "PLockSequencer.h"
+
+PLockSequencer::PLockSequencer(int numLanes)
+    : numLanes(numLanes),
+      lastRecordedStep(numLanes, -1),
+      value0(numLanes, 0.0f),
+      value1(numLanes, 0.0f),
+      blend(numLanes, 0.0f),
+      smoothed(numLanes, 0.0f) {
+}
+
+void PLockSequencer::setPattern(const PLockPattern& newPattern) {
+    pattern = newPattern;
+    steps = pattern.steps;
+    lengths = pattern.lengths;
+    interpolate = pattern.interpolate;
+    for (int lane = 0; lane < numLanes; lane++) {
+        if (lengths[lane] < 1 || lengths[lane] > MAX_STEPS) {
+            lengths[lane] = DEFAULT_LENGTH; // Damaged or foreign bank file
+        }
+    }
+    updatePatternLength();
+    std::fill(lastRecordedStep.begin(), lastRecordedStep.end(), -1); // Don't gap-fill across patterns
+}
+
+void PLockSequencer::advance(float seconds) {
+    lastAdvance = std::max(0.0f, seconds) * stepsPerSecond;
+    position += lastAdvance; // Never wrapped, so lanes of different lengths stay in phase
+}
+
+void PLockSequencer::setPosition(double newPosition) {
+    lastAdvance = std::max(0.0, newPosition - position);
+    position = std::max(0.0, newPosition);
+}
+
+int PLockSequencer::getStep(int lane) const {
+    return static_cast<int>(std::fmod(position, static_cast<double>(lengths[lane])));
+}
+
+void PLockSequencer::setLength(int lane, int length) {
+    if (lane < 0 || lane >= numLanes) {
+        return;
+    }
+    lengths[lane] = ofClamp(length, 1, MAX_STEPS);
+    lastRecordedStep[lane] = -1;
+    updatePatternLength();
+}
+
+void PLockSequencer::updatePatternLength() {
+    // Chaining moves on after the longest lane has played through
+    pattern.info->length = *std::max_element(lengths, lengths + numLanes);
+}
+
+void PLockSequencer::record(int lane, float value) {
+    if (lane < 0 || lane >= numLanes) {
+        return;
+    }
+    int length = lengths[lane];
+    int step = getStep(lane);
+    float* laneSteps = &steps[lane * MAX_STEPS];
+
+    // Steps are finer than frames: fill the ones the playhead passed since the last frame
+    int last = lastRecordedStep[lane];
+    int gap = last >= 0 ? (step - last + length) % length : 0;
+    int maxGap = static_cast<int>(std::ceil(lastAdvance)) + 1;
+    if (gap > 0 && gap <= maxGap) {
+        for (int i = 1; i <= gap; i++) {
+            laneSteps[(last + i) % length] = value;
+        }
+    } else {
+        laneSteps[step] = value;
+    }
+    lastRecordedStep[lane] = step;
+}
+
+void PLockSequencer::fillFromCurrent() {
+    for (int lane = 0; lane < numLanes; lane++) {
+        float* laneSteps = &steps[lane * MAX_STEPS];
+        float current = laneSteps[getStep(lane)];
+        std::fill(laneSteps, laneSteps + MAX_STEPS, current);
+        lastRecordedStep[lane] = -1;
+    }
+}
+
+void PLockSequencer::clear() {
+    std::fill(steps, steps + numLanes * MAX_STEPS, 0.0f);
+    resetPlayback();
+}
+
+void PLockSequencer::resetPlayback() {
+    std::fill(smoothed.begin(), smoothed.end(), 0.0f);
+    std::fill(lastRecordedStep.begin(), lastRecordedStep.end(), -1);
+}
+
+bool PLockSequencer::hasData(int lane) const {
+    const float* laneSteps = &steps[lane * MAX_STEPS];
+    return std::any_of(laneSteps, laneSteps + lengths[lane], [](float v) { return v != 0.0f; });
+}
+
+void PLockSequencer::evaluate() {
+    // Gather each lane's neighbouring steps; lanes differ in length so this part is scalar
+    for (int lane = 0; lane < numLanes; lane++) {
+        int length = lengths[lane];
+        double lanePosition = std::fmod(position, static_cast<double>(length));
+        int i0 = static_cast<int>(lanePosition);
+        int i1 = i0 + 1 < length ? i0 + 1 : 0;
+        const float* laneSteps = &steps[lane * MAX_STEPS];
+        value0[lane] = laneSteps[i0];
+        value1[lane] = laneSteps[i1];
+        blend[lane] = interpolate[lane] ? static_cast<float>(lanePosition - i0) : 0.0f;
+    }
+
+    // Interpolate and smooth all lanes at once; contiguous and branch-free so it vectorizes
+    const float keep = smoothFactor;
+    const float take = 1.0f - smoothFactor;
+    const float* a = value0.data();
+    const float* b = value1.data();
+    const float* t = blend.data();
+    float* out = smoothed.data();
+    for (int lane = 0; lane < numLanes; lane++) {
+        float value = a[lane] + (b[lane] - a[lane]) * t[lane];
+        float s = value * take + out[lane] * keep;
+        out[lane] = std::fabs(s) < 0.01f ? 0.0f : s; // Eliminate very small values to prevent jitter
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ofMain.h"
+#include "PLockPatternBank.h"
+
+/**
+ * @class PLockSequencer
+ * @brief Time-based parameter lock sequencer with one lane per parameter
+ *
+ * Steps advance with elapsed time (or transport beats) rather than once per
+ * frame, so a recording plays back at the same speed at any frame rate. Each
+ * lane has its own length, which allows polymetric loops, and playback
+ * interpolates between neighbouring steps.
+ *
+ * Storage is structure-of-arrays: step values are one contiguous block,
+ * lane-major, and the per-lane length, output and smoothing state live in
+ * parallel arrays, so evaluate() is a pair of straight loops over all lanes.
+ * Step values, lengths and interpolation belong to the bound pattern, which
+ * lives in a PLockPatternBank; setPattern() only swaps pointers.
+ */
+class PLockSequencer {
+public:
+    static const int MAX_STEPS = 1024;        // Per lane
+    static const int DEFAULT_LENGTH = 240;    // Steps, matches the original fixed P-Lock buffer
+
+    explicit PLockSequencer(int numLanes);
+
+    // Play and record into another pattern; must be called before use
+    void setPattern(const PLockPattern& pattern);
+    const PLockPattern& getPattern() const { return pattern; }
+
+    // Playhead, in steps. advance() moves it by elapsed time, setPosition() follows an external clock
+    void advance(float seconds);
+    void setPosition(double steps);
+    double getPosition() const { return position; }
+    int getStep(int lane) const; // Current step of a lane
+
+    float getStepRate() const { return stepsPerSecond; }
+    void setStepRate(float steps) { stepsPerSecond = ofClamp(steps, 1.0f, 240.0f); }
+
+    // Per-lane configuration
+    int getNumLanes() const { return numLanes; }
+    int getLength(int lane) const { return lengths[lane]; }
+    void setLength(int lane, int steps); // Also the pattern's chain length, the longest lane
+    bool isInterpolated(int lane) const { return interpolate[lane] != 0; }
+    void setInterpolated(int lane, bool enabled) { interpolate[lane] = enabled ? 1 : 0; }
+
+    // Recording writes the current step; steps skipped since the last frame are filled too
+    void record(int lane, float value);
+    void fillFromCurrent(); // Every lane holds its current value on all steps
+    void clear();           // Current pattern only, in the bank too
+    void resetPlayback();   // Smoothing and record state; the pattern's steps stay
+    bool hasData(int lane) const;
+
+    // Direct step access for persistence
+    float getStepValue(int lane, int step) const { return steps[lane * MAX_STEPS + step]; }
+    void setStepValue(int lane, int step, float value) { steps[lane * MAX_STEPS + step] = value; }
+
+    // Compute all lane outputs for this frame
+    void evaluate();
+    float getValue(int lane) const { return smoothed[lane]; }
+    const float* getValues() const { return smoothed.data(); } // getNumLanes() contiguous values
+
+    float getSmoothFactor() const { return smoothFactor; }
+    void setSmoothFactor(float factor) { smoothFactor = ofClamp(factor, 0.0f, 0.99f); }
+
+private:
+    void updatePatternLength(); // info->length from the lane lengths
+
+    int numLanes;
+    double position = 0.0;      // Global playhead in steps
+    double lastAdvance = 0.0;   // Steps moved by the last advance, bounds gap filling when recording
+    float stepsPerSecond = 30.0f;
+    float smoothFactor = 0.5f;
+
+    // Structure of arrays, indexed by lane. The first three point into the bound pattern
+    PLockPattern pattern;
+    float* steps = nullptr;             // numLanes * MAX_STEPS, lane-major
+    int32_t* lengths = nullptr;
+    int32_t* interpolate = nullptr;
+    std::vector<int> lastRecordedStep;  // -1 = nothing recorded yet
+    std::vector<float> value0;          // Scratch for evaluate(): neighbouring steps and blend
+    std::vector<float> value1;
+    std::vector<float> blend;
+    std::vector<float> smoothed;
+};
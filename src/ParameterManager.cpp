@@ -1,21 +1,28 @@
 #include "ParameterManager.h"
 
+// Vector unit for evaluate(); the scalar loop is the fallback and reference
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define PARAMETER_EVAL_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define PARAMETER_EVAL_NEON 1
+#endif
+
 ParameterManager::ParameterManager() {
-    // Initialize P-Lock arrays with zeros
-    for (int i = 0; i < P_LOCK_NUMBER; i++) {
-        pLockSmoothedValues[i] = 0.0f;
-        for (int j = 0; j < P_LOCK_SIZE; j++) {
-            pLockValues[i][j] = 0.0f;
-        }
+    initializeEvaluationGains();
+    initializeModulationRoutes();
+    bindPattern(0); // In-memory bank until setup() maps the file
 
+    for (int i = 0; i < P_LOCK_NUMBER; i++) {
         // Initialize state tracking arrays
         midiActiveState[i] = false;
         vMidiActiveState[i] = false;
         lfoAmpActiveState[i] = false;
         lfoRateActiveState[i] = false;
     }
-    // Initialize audio offsets to zero
-    resetToDefaults(); // Call reset to ensure audio offsets are zeroed initially
+    // Start from default parameter values
+    resetToDefaults();
 }
 
 // Helper function to initialize parameter maps
@@ -44,6 +51,11 @@ void ParameterManager::initializeParameterMaps() {
         "videoReactiveMode", "lfoAmpMode", "lfoRateMode"
         // Note: Video device settings are not included as controllable parameters here
     };
+    // Keep in sync with the ParamId enum in ParameterManager.h
+    if (parameterIds.size() != PARAM_COUNT) {
+        ofLogError("ParameterManager") << "Parameter ID list (" << parameterIds.size()
+                                       << ") does not match ParamId enum (" << PARAM_COUNT << ")";
+    }
 
     // Initialize maps with defaults
     for (const auto& id : parameterIds) {
@@ -58,28 +70,167 @@ void ParameterManager::initializeParameterMaps() {
 
 void ParameterManager::setup() {
     initializeParameterMaps(); // Initialize IDs and default mappings first
-    // Try to load settings from XML, this will overwrite defaults if mappings exist
-    if (!loadSettings()) {
-        // If loading fails (e.g., file not found), reset ensures defaults are set
-        resetToDefaults();
-    }
+    // Map the P-Lock pattern bank before settings, which may import older XML locks into it
+    patternBank.open(ofToDataPath(patternFile));
+    importXmlLocks = patternBank.wasCreated();
+    bindPattern(currentPattern);
+    presets.load(ofToDataPath(presetFile));
+    // Settings are applied afterwards with loadFromXml() from the app's SettingsStore document
 }
 
 void ParameterManager::update() {
+    // Preset morph first so P-Locks and MIDI act on this frame's base values
+    updatePresetMorph();
+
     // Update P-Lock system (automated parameter changes)
     updatePLocks();
 }
 
+void ParameterManager::initializeEvaluationGains() {
+    // Same combine rules as the individual getters
+    for (int i = PARAM_LUMAKEY_VALUE; i < PARAM_VIDEO_REACTIVE_MODE; i++) {
+        evalAddGain[i] = 1.0f; // Additive P-Lock
+    }
+    evalAddGain[PARAM_HUE] = evalAddGain[PARAM_SATURATION] = evalAddGain[PARAM_BRIGHTNESS] = 0.0f;
+    evalMulGain[PARAM_HUE] = evalMulGain[PARAM_SATURATION] = evalMulGain[PARAM_BRIGHTNESS] = 1.0f;
+    evalAddGain[PARAM_Z_DISPLACE] = 0.0f;
+    evalMulGain[PARAM_Z_DISPLACE] = 1.0f;
+    evalAddGain[PARAM_HUE_MODULATION] = 0.0f;
+    evalMulGain[PARAM_HUE_MODULATION] = -1.0f;
+    evalAddGain[PARAM_DELAY_AMOUNT] = P_LOCK_SIZE - 1.0f; // Delay locks are stored normalized
+}
+
+void ParameterManager::evaluate() {
+    // The built-in LFOs follow the X/Y/Z/rotate LFO controls, as modulated last frame
+    static const int lfoControls[4][2] = {
+        { PARAM_X_LFO_RATE, PARAM_X_LFO_AMP }, { PARAM_Y_LFO_RATE, PARAM_Y_LFO_AMP },
+        { PARAM_Z_LFO_RATE, PARAM_Z_LFO_AMP }, { PARAM_ROTATE_LFO_RATE, PARAM_ROTATE_LFO_AMP }
+    };
+    for (int i = 0; i < 4; i++) {
+        ModulationMatrix::Lfo& lfo = modulation.getLfo(i);
+        lfo.rate = getEffectiveParameterValue(lfoControls[i][0]);
+        lfo.level = getEffectiveParameterValue(lfoControls[i][1]);
+        lfo.sync = lfoSyncEnabled;
+    }
+    modulation.process(ofGetElapsedTimef(), ofGetElapsedTimeMicros(), ofGetLastFrameTime(), transport);
+
+    // Gather this frame's inputs; toggles pass through with zero gains
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        evalBase[i] = getParameterValue(i);
+    }
+    evalBase[PARAM_DELAY_AMOUNT] = getBaseDelayAmount();
+    std::copy(sequencer.getValues(), sequencer.getValues() + PARAM_COUNT, evalLock);
+    std::copy(modulation.getOffsets(), modulation.getOffsets() + PARAM_COUNT, evalModOffset);
+    std::copy(modulation.getScales(), modulation.getScales() + PARAM_COUNT, evalModScale);
+
+    // Combine every parameter at once
+#if defined(PARAMETER_EVAL_SSE)
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int i = 0; i < EVAL_COUNT; i += 4) {
+        __m128 lock = _mm_load_ps(evalLock + i);
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm_load_ps(evalBase + i), _mm_load_ps(evalModOffset + i)),
+                                _mm_mul_ps(lock, _mm_load_ps(evalAddGain + i)));
+        __m128 scale = _mm_mul_ps(_mm_add_ps(one, _mm_mul_ps(lock, _mm_load_ps(evalMulGain + i))),
+                                  _mm_load_ps(evalModScale + i));
+        _mm_store_ps(effectiveValues + i, _mm_mul_ps(sum, scale));
+    }
+#elif defined(PARAMETER_EVAL_NEON)
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    for (int i = 0; i < EVAL_COUNT; i += 4) {
+        float32x4_t lock = vld1q_f32(evalLock + i);
+        float32x4_t sum = vmlaq_f32(vaddq_f32(vld1q_f32(evalBase + i), vld1q_f32(evalModOffset + i)),
+                                    lock, vld1q_f32(evalAddGain + i));
+        float32x4_t scale = vmulq_f32(vmlaq_f32(one, lock, vld1q_f32(evalMulGain + i)), vld1q_f32(evalModScale + i));
+        vst1q_f32(effectiveValues + i, vmulq_f32(sum, scale));
+    }
+#else
+    for (int i = 0; i < EVAL_COUNT; i++) {
+        float sum = evalBase[i] + evalModOffset[i] + evalLock[i] * evalAddGain[i];
+        effectiveValues[i] = sum * (1.0f + evalLock[i] * evalMulGain[i]) * evalModScale[i];
+    }
+#endif
+    // Delay stays fractional; the mixer blends the two history frames either side of it
+}
+
+void ParameterManager::initializeModulationRoutes() {
+    // The original hard-wired LFOs: displacement and rotation add, zoom scales
+    modulation.removeRoutes(ModulationMatrix::GROUP_BUILTIN);
+    modulation.addRoute(ModulationMatrix::GROUP_BUILTIN, ModulationMatrix::SOURCE_LFO_1, PARAM_X_DISPLACE, 0.01f);
+    modulation.addRoute(ModulationMatrix::GROUP_BUILTIN, ModulationMatrix::SOURCE_LFO_1 + 1, PARAM_Y_DISPLACE, 0.01f);
+    modulation.addRoute(ModulationMatrix::GROUP_BUILTIN, ModulationMatrix::SOURCE_LFO_1 + 2, PARAM_Z_DISPLACE, 0.05f, true);
+    modulation.addRoute(ModulationMatrix::GROUP_BUILTIN, ModulationMatrix::SOURCE_LFO_1 + 3, PARAM_ROTATE, 0.314159265f);
+}
+
+void ParameterManager::storePreset(int slot) {
+    float snapshot[PARAM_COUNT];
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        snapshot[i] = getParameterValue(i);
+    }
+    presets.store(slot, snapshot);
+    currentPreset = slot;
+    ofLogNotice("ParameterManager") << "Stored preset " << slot;
+}
+
+void ParameterManager::recallPreset(int slot) {
+    recallPreset(slot, presetMorphTime);
+}
+
+void ParameterManager::recallPreset(int slot, float morphSeconds) {
+    const float* snapshot = presets.get(slot);
+    if (!snapshot) {
+        ofLogNotice("ParameterManager") << "Preset " << slot << " is empty";
+        return;
+    }
+    std::memcpy(morphTo, snapshot, sizeof(morphTo));
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        morphFrom[i] = getParameterValue(i); // Morph from wherever we are, including mid-morph
+    }
+    currentPreset = slot;
+
+    // Switches can't be interpolated, so they change straight away
+    applyPresetValues(morphTo, true);
+    if (morphSeconds > 0.0f) {
+        morphActive = true;
+        morphElapsed = 0.0f;
+        morphDuration = morphSeconds;
+    } else {
+        morphActive = false;
+        applyPresetValues(morphTo, false);
+    }
+}
+
+void ParameterManager::updatePresetMorph() {
+    if (!morphActive) {
+        return;
+    }
+    morphElapsed += ofGetLastFrameTime();
+    float t = std::min(1.0f, morphElapsed / morphDuration);
+    float eased = t * t * (3.0f - 2.0f * t); // Smoothstep, no jump in speed at either end
+
+    float values[PARAM_COUNT];
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        values[i] = morphFrom[i] + (morphTo[i] - morphFrom[i]) * eased;
+    }
+    applyPresetValues(values, false);
+
+    if (t >= 1.0f) {
+        morphActive = false;
+    }
+}
+
+void ParameterManager::applyPresetValues(const float* values, bool toggles) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+        if (isToggleParameter(i) == toggles) {
+            setParameterValue(i, values[i], false); // A recall isn't a performance gesture
+        }
+    }
+}
+
 void ParameterManager::startRecording() {
     recordingEnabled = true;
 
     // Copy current P-Lock values to all steps
-    for (int i = 0; i < P_LOCK_NUMBER; i++) {
-        float currentValue = pLockValues[i][currentStep];
-        for (int j = 0; j < P_LOCK_SIZE; j++) {
-            pLockValues[i][j] = currentValue;
-        }
-    }
+    sequencer.fillFromCurrent();
 }
 
 void ParameterManager::stopRecording() {
@@ -87,44 +238,55 @@ void ParameterManager::stopRecording() {
 }
 
 void ParameterManager::clearAllLocks() {
-    for (int i = 0; i < P_LOCK_NUMBER; i++) {
-        pLockSmoothedValues[i] = 0.0f;
-        for (int j = 0; j < P_LOCK_SIZE; j++) {
-            pLockValues[i][j] = 0.0f;
-        }
+    sequencer.clear(); // Current pattern only
+}
+
+void ParameterManager::selectPattern(int index) {
+    if (index < 0 || index >= patternBank.getNumPatterns() || index == currentPattern) {
+        return;
     }
+    bindPattern(index);
+    patternStartPosition = sequencer.getPosition(); // A manual switch restarts the chain count
 }
 
-void ParameterManager::updatePLocks() {
-    // Apply smoothing to all parameters
-    for (int i = 0; i < P_LOCK_NUMBER; i++) {
-        // Apply smoothing formula: smoothed = current * (1-factor) + previous * factor
-        pLockSmoothedValues[i] = pLockValues[i][currentStep] * (1.0f - pLockSmoothFactor)
-                              + pLockSmoothedValues[i] * pLockSmoothFactor;
+void ParameterManager::bindPattern(int index) {
+    currentPattern = ofClamp(index, 0, patternBank.getNumPatterns() - 1);
+    sequencer.setPattern(patternBank.getPattern(currentPattern));
+}
 
-        // Eliminate very small values to prevent jitter
-        if (abs(pLockSmoothedValues[i]) < 0.01) {
-            pLockSmoothedValues[i] = 0.0f;
-        }
+void ParameterManager::setPatternChain(int index, int next, int repeats) {
+    if (index < 0 || index >= patternBank.getNumPatterns()) {
+        return;
     }
+    PLockPattern::Info& info = *patternBank.getPattern(index).info;
+    info.chainNext = (next >= 0 && next < patternBank.getNumPatterns()) ? next : -1;
+    info.chainRepeats = std::max(1, repeats);
+}
 
-    // Increment step if recording is enabled
+void ParameterManager::updatePLocks() {
+    // Advance the playhead by time (or transport position) while recording is enabled
     if (recordingEnabled) {
-        currentStep = (currentStep + 1) % P_LOCK_SIZE;
-    }
-}
+        if (pLockSyncEnabled) {
+            // A default-length lane spans pLockSyncBars; holds while the transport is stopped
+            double stepsPerBeat = PLockSequencer::DEFAULT_LENGTH / (pLockSyncBars * 4.0);
+            sequencer.setPosition(transport.getBeatPosition(ofGetElapsedTimeMicros()) * stepsPerBeat);
+        } else {
+            sequencer.advance(ofGetLastFrameTime());
+        }
 
-bool ParameterManager::loadSettings() {
-    if (XML.load(ofToDataPath(settingsFile))) { // Use load() instead of deprecated loadFile()
-        loadFromXml(XML);
-        return true;
+        // Follow the pattern chain once this pattern has played its repeats
+        const PLockPattern::Info& info = *sequencer.getPattern().info;
+        double chainSteps = std::max(1, info.length) * std::max(1, info.chainRepeats);
+        if (sequencer.getPosition() < patternStartPosition) {
+            patternStartPosition = sequencer.getPosition(); // Transport jumped back
+        } else if (info.chainNext >= 0 && sequencer.getPosition() - patternStartPosition >= chainSteps) {
+            patternStartPosition += chainSteps;
+            bindPattern(info.chainNext);
+        }
     }
-    return false;
-}
 
-bool ParameterManager::saveSettings() {
-    saveToXml(XML);
-    return XML.save(ofToDataPath(settingsFile)); // Use save() instead of deprecated saveFile()
+    // Interpolate and smooth every lane
+    sequencer.evaluate();
 }
 
 void ParameterManager::resetToDefaults() {
@@ -157,7 +319,7 @@ void ParameterManager::resetToDefaults() {
     hueModulation = 1.0f;
     hueOffset = 0.0f;
     hueLFO = 0.0f;
-    delayAmount = 0;
+    delayAmount = 0.0f;
     zFrequency = 0.03f;
     xFrequency = 0.015f;
     yFrequency = 0.02f;
@@ -189,32 +351,11 @@ void ParameterManager::resetToDefaults() {
     vHueOffset = 0.0f;
     vHueLFO = 0.0f;
 
-    // Reset Audio Offsets
-    audioLumakeyValueOffset = 0.0f;
-    audioMixOffset = 0.0f;
-    audioHueOffset = 0.0f;
-    audioSaturationOffset = 0.0f;
-    audioBrightnessOffset = 0.0f;
-    audioTemporalFilterMixOffset = 0.0f;
-    audioTemporalFilterResonanceOffset = 0.0f;
-    audioSharpenAmountOffset = 0.0f;
-    audioXDisplaceOffset = 0.0f;
-    audioYDisplaceOffset = 0.0f;
-    audioZDisplaceOffset = 0.0f;
-    audioRotateOffset = 0.0f;
-    audioHueModulationOffset = 0.0f;
-    audioHueOffsetOffset = 0.0f;
-    audioHueLFOOffset = 0.0f;
-    audioDelayAmountOffset = 0;
-    audioZFrequencyOffset = 0.0f;
-    audioXFrequencyOffset = 0.0f;
-    audioYFrequencyOffset = 0.0f;
-
     // Mode flags
     videoReactiveMode = false;
     lfoAmpMode = false;
     lfoRateMode = false;
-    clearAllLocks();
+    clearAllLocks(); // Otherwise the active pattern overrides the reset values on its next step; the other patterns stay
 
     // Reset mappings to defaults
     for (const auto& id : parameterIds) {
@@ -227,14 +368,14 @@ void ParameterManager::resetToDefaults() {
 }
 
 void ParameterManager::recordParameter(int paramIndex, float value) {
-    if (recordingEnabled && paramIndex >= 0 && paramIndex < P_LOCK_NUMBER) {
-        pLockValues[paramIndex][currentStep] = value;
+    if (recordingEnabled && paramIndex >= 0 && paramIndex < PARAM_COUNT && !isToggleParameter(paramIndex)) {
+        sequencer.record(paramIndex, value);
     }
 }
 
 float ParameterManager::getPLockValue(int paramIndex) const {
-    if (paramIndex >= 0 && paramIndex < P_LOCK_NUMBER) {
-        return pLockSmoothedValues[paramIndex];
+    if (paramIndex >= 0 && paramIndex < PARAM_COUNT) {
+        return sequencer.getValue(paramIndex);
     }
     return 0.0f;
 }
@@ -260,30 +401,18 @@ void ParameterManager::loadFromXml(ofxXmlSettings& xml) {
     videoHeight = xml.getValue("video:height", videoHeight);
     videoFrameRate = xml.getValue("video:frameRate", videoFrameRate);
 
+    // Load transport sync settings
+    lfoSyncEnabled = xml.getValue("sync:lfo", lfoSyncEnabled ? 1 : 0) != 0;
+    pLockSyncEnabled = xml.getValue("sync:plocks", pLockSyncEnabled ? 1 : 0) != 0;
+    setPLockSyncBars(xml.getValue("sync:plockBars", pLockSyncBars));
+    setDelaySyncBeats(xml.getValue("sync:delayBeats", delaySyncBeats));
+    setDelayTimeMs(xml.getValue("delay:timeMs", delayTimeMs));
+    transport.setInternalBpm(xml.getValue("sync:bpm", transport.getInternalBpm()));
+    setPresetMorphTime(xml.getValue("presets:morphTime", presetMorphTime));
+
     // Load P-Lock data if available
-    if (xml.tagExists("plocks")) {
-        xml.pushTag("plocks");
-        pLockSmoothFactor = xml.getValue("smoothFactor", pLockSmoothFactor);
-        if (xml.tagExists("locks")) {
-            xml.pushTag("locks");
-            for (int i = 0; i < P_LOCK_NUMBER; i++) {
-                std::string lockTag = "lock" + ofToString(i);
-                if (xml.tagExists(lockTag)) {
-                    xml.pushTag(lockTag);
-                    std::string valuesStr = xml.getValue("values", "");
-                    if (!valuesStr.empty()) {
-                        std::vector<std::string> values = ofSplitString(valuesStr, ",");
-                        for (int j = 0; j < std::min((int)values.size(), P_LOCK_SIZE); j++) {
-                            pLockValues[i][j] = ofToFloat(values[j]);
-                        }
-                    }
-                    xml.popTag(); // pop lockTag
-                }
-            }
-            xml.popTag(); // pop locks
-        }
-        xml.popTag(); // pop plocks
-    }
+    loadPLocksFromXml(xml);
+    modulation.loadFromXml(xml, parameterIds);
 
     // --- Load Parameters and Mappings ---
     int numParamTags = xml.getNumTags("param");
@@ -356,8 +485,7 @@ void ParameterManager::loadFromXml(ofxXmlSettings& xml) {
                 else if (id == "vHueModulation") setVHueModulation(ofToFloat(valueStr));
                 else if (id == "vHueOffset") setVHueOffset(ofToFloat(valueStr));
                 else if (id == "vHueLFO") setVHueLFO(ofToFloat(valueStr));
-                // Ints
-                else if (id == "delayAmount") setDelayAmount(ofToInt(valueStr), false);
+                else if (id == "delayAmount") setDelayAmount(ofToFloat(valueStr), false);
                 // Bools (Toggles & Modes)
                 else if (id == "hueInvert") setHueInverted(ofToBool(valueStr));
                 else if (id == "saturationInvert") setSaturationInverted(ofToBool(valueStr));
@@ -407,6 +535,15 @@ void ParameterManager::saveToXml(ofxXmlSettings& xml) const {
     xml.setValue("video:height", videoHeight);
     xml.setValue("video:frameRate", videoFrameRate);
 
+    // Save transport sync settings
+    xml.setValue("sync:lfo", lfoSyncEnabled ? 1 : 0);
+    xml.setValue("sync:plocks", pLockSyncEnabled ? 1 : 0);
+    xml.setValue("sync:plockBars", pLockSyncBars);
+    xml.setValue("sync:delayBeats", delaySyncBeats);
+    xml.setValue("delay:timeMs", delayTimeMs);
+    xml.setValue("sync:bpm", transport.getInternalBpm());
+    xml.setValue("presets:morphTime", presetMorphTime);
+
     // Remove old <param> tags before saving new ones
     while(xml.getNumTags("param") > 0) {
         xml.removeTag("param", 0);
@@ -487,6 +624,69 @@ void ParameterManager::saveToXml(ofxXmlSettings& xml) const {
     }
 
     // Save P-Lock data
+    savePLocksToXml(xml);
+    modulation.saveToXml(xml, parameterIds);
+
+    xml.popTag(); // pop paramManager
+}
+
+void ParameterManager::loadPLocksFromXml(ofxXmlSettings& xml) {
+    if (!xml.tagExists("plocks")) {
+        return;
+    }
+    xml.pushTag("plocks");
+    sequencer.setSmoothFactor(xml.getValue("smoothFactor", sequencer.getSmoothFactor()));
+    sequencer.setStepRate(xml.getValue("stepRate", sequencer.getStepRate()));
+    selectPattern(xml.getValue("pattern", currentPattern));
+
+    // Recordings live in the pattern bank; older settings files carried them inline
+    if (!importXmlLocks) {
+        xml.popTag(); // pop plocks
+        return;
+    }
+    importXmlLocks = false;
+    ofLogNotice("ParameterManager") << "Importing P-Locks from settings into pattern " << currentPattern;
+    sequencer.clear();
+    if (xml.tagExists("lanes")) {
+        xml.pushTag("lanes");
+        int numLanes = xml.getNumTags("lane");
+        for (int i = 0; i < numLanes; i++) {
+            std::string id = xml.getAttribute("lane", "param", std::string(""), i);
+            int lane = findParameterIndex(id);
+            if (lane < 0) {
+                ofLogWarning("ParameterManager::loadFromXml") << "Skipping P-Lock lane for unknown parameter: " << id;
+                continue;
+            }
+            sequencer.setLength(lane, xml.getAttribute("lane", "length", PLockSequencer::DEFAULT_LENGTH, i));
+            sequencer.setInterpolated(lane, xml.getAttribute("lane", "interpolate", 1, i) != 0);
+            std::vector<std::string> values = ofSplitString(xml.getAttribute("lane", "values", std::string(""), i), ",");
+            for (int j = 0; j < std::min((int)values.size(), sequencer.getLength(lane)); j++) {
+                sequencer.setStepValue(lane, j, ofToFloat(values[j]));
+            }
+        }
+        xml.popTag(); // pop lanes
+    } else if (xml.tagExists("locks")) {
+        // Original format: 17 fixed buffers of P_LOCK_SIZE frames, lock i = LUMAKEY_VALUE + i, lock 15 = delay
+        xml.pushTag("locks");
+        for (int i = 0; i < P_LOCK_NUMBER; i++) {
+            int lane = i < 15 ? PARAM_LUMAKEY_VALUE + i : (i == 15 ? PARAM_DELAY_AMOUNT : -1);
+            std::string lockTag = "lock" + ofToString(i);
+            if (lane < 0 || !xml.tagExists(lockTag)) {
+                continue;
+            }
+            xml.pushTag(lockTag);
+            std::vector<std::string> values = ofSplitString(xml.getValue("values", ""), ",");
+            for (int j = 0; j < std::min((int)values.size(), P_LOCK_SIZE); j++) {
+                sequencer.setStepValue(lane, j, ofToFloat(values[j]));
+            }
+            xml.popTag(); // pop lockTag
+        }
+        xml.popTag(); // pop locks
+    }
+    xml.popTag(); // pop plocks
+}
+
+void ParameterManager::savePLocksToXml(ofxXmlSettings& xml) const {
     // Ensure plocks tag exists and is clean before saving
     if (xml.tagExists("plocks")) {
          // If it exists, remove it first to avoid duplicate data or merging issues
@@ -496,57 +696,16 @@ void ParameterManager::saveToXml(ofxXmlSettings& xml) const {
     xml.addTag("plocks");
     xml.pushTag("plocks"); // Push into the newly added plocks tag
 
-    xml.setValue("smoothFactor", pLockSmoothFactor); // Save smooth factor inside plocks
+    xml.setValue("smoothFactor", sequencer.getSmoothFactor()); // Save smooth factor inside plocks
+    xml.setValue("stepRate", sequencer.getStepRate());
+    xml.setValue("pattern", currentPattern);
 
-    xml.addTag("locks");
-    xml.pushTag("locks");
-
-    for (int i = 0; i < P_LOCK_NUMBER; i++) {
-        std::string lockTag = "lock" + ofToString(i);
-        xml.addTag(lockTag);
-        xml.pushTag(lockTag);
-
-        std::string valuesStr = "";
-        for (int j = 0; j < P_LOCK_SIZE; j++) {
-            valuesStr += ofToString(pLockValues[i][j]);
-            if (j < P_LOCK_SIZE - 1) {
-                valuesStr += ",";
-            }
-        }
+    // Step data is in the pattern bank file, not the XML; see snapshotPatternBank()
 
-        xml.setValue("values", valuesStr);
-        xml.popTag(); // pop lockTag
-    }
-
-    xml.popTag(); // pop locks
     xml.popTag(); // pop plocks
-
-    xml.popTag(); // pop paramManager
 }
 
 
-// --- Audio Reactivity Offset Setters Implementation ---
-void ParameterManager::setAudioLumakeyValueOffset(float offset) { audioLumakeyValueOffset = offset; }
-void ParameterManager::setAudioMixOffset(float offset) { audioMixOffset = offset; }
-void ParameterManager::setAudioHueOffset(float offset) { audioHueOffset = offset; }
-void ParameterManager::setAudioSaturationOffset(float offset) { audioSaturationOffset = offset; }
-void ParameterManager::setAudioBrightnessOffset(float offset) { audioBrightnessOffset = offset; }
-void ParameterManager::setAudioTemporalFilterMixOffset(float offset) { audioTemporalFilterMixOffset = offset; }
-void ParameterManager::setAudioTemporalFilterResonanceOffset(float offset) { audioTemporalFilterResonanceOffset = offset; }
-void ParameterManager::setAudioSharpenAmountOffset(float offset) { audioSharpenAmountOffset = offset; }
-void ParameterManager::setAudioXDisplaceOffset(float offset) { audioXDisplaceOffset = offset; }
-void ParameterManager::setAudioYDisplaceOffset(float offset) { audioYDisplaceOffset = offset; }
-void ParameterManager::setAudioZDisplaceOffset(float offset) { audioZDisplaceOffset = offset; }
-void ParameterManager::setAudioRotateOffset(float offset) { audioRotateOffset = offset; }
-void ParameterManager::setAudioHueModulationOffset(float offset) { audioHueModulationOffset = offset; }
-void ParameterManager::setAudioHueOffsetOffset(float offset) { audioHueOffsetOffset = offset; }
-void ParameterManager::setAudioHueLFOOffset(float offset) { audioHueLFOOffset = offset; }
-void ParameterManager::setAudioDelayAmountOffset(int offset) { audioDelayAmountOffset = offset; }
-void ParameterManager::setAudioZFrequencyOffset(float offset) { audioZFrequencyOffset = offset; }
-void ParameterManager::setAudioXFrequencyOffset(float offset) { audioXFrequencyOffset = offset; }
-void ParameterManager::setAudioYFrequencyOffset(float offset) { audioYFrequencyOffset = offset; }
-
-
 // --- Mapping Getters Implementation ---
 int ParameterManager::getMidiChannel(const std::string& paramId) const {
     if (midiChannels.count(paramId)) {
@@ -573,6 +732,173 @@ const std::vector<std::string>& ParameterManager::getAllParameterIds() const {
     return parameterIds;
 }
 
+int ParameterManager::findParameterIndex(const std::string& paramId) const {
+    auto it = std::find(parameterIds.begin(), parameterIds.end(), paramId);
+    if (it == parameterIds.end()) {
+        return -1;
+    }
+    return static_cast<int>(it - parameterIds.begin());
+}
+
+bool ParameterManager::isToggleParameter(int paramIndex) const {
+    return (paramIndex >= PARAM_HUE_INVERT && paramIndex <= PARAM_WET_MODE_ENABLED) ||
+           (paramIndex >= PARAM_VIDEO_REACTIVE_MODE && paramIndex <= PARAM_LFO_RATE_MODE);
+}
+
+float ParameterManager::getEffectiveParameterValue(int paramIndex) const {
+    switch (paramIndex) {
+        case PARAM_LUMAKEY_VALUE: return getLumakeyValue();
+        case PARAM_MIX: return getMix();
+        case PARAM_HUE: return getHue();
+        case PARAM_SATURATION: return getSaturation();
+        case PARAM_BRIGHTNESS: return getBrightness();
+        case PARAM_TEMPORAL_FILTER_MIX: return getTemporalFilterMix();
+        case PARAM_TEMPORAL_FILTER_RESONANCE: return getTemporalFilterResonance();
+        case PARAM_SHARPEN_AMOUNT: return getSharpenAmount();
+        case PARAM_X_DISPLACE: return getXDisplace();
+        case PARAM_Y_DISPLACE: return getYDisplace();
+        case PARAM_Z_DISPLACE: return getZDisplace();
+        case PARAM_ROTATE: return getRotate();
+        case PARAM_HUE_MODULATION: return getHueModulation();
+        case PARAM_HUE_OFFSET: return getHueOffset();
+        case PARAM_HUE_LFO: return getHueLFO();
+        case PARAM_Z_FREQUENCY: return getZFrequency();
+        case PARAM_X_FREQUENCY: return getXFrequency();
+        case PARAM_Y_FREQUENCY: return getYFrequency();
+        case PARAM_DELAY_AMOUNT: return getDelayAmount();
+        default:
+            // Toggles aren't modulated; LFO and video-reactive parameters add their P-Lock
+            if (isToggleParameter(paramIndex)) {
+                return getParameterValue(paramIndex);
+            }
+            return (getParameterValue(paramIndex) + modulation.getOffset(paramIndex) + getPLockValue(paramIndex)) *
+                   modulation.getScale(paramIndex);
+    }
+}
+
+float ParameterManager::getParameterValue(int paramIndex) const {
+    switch (paramIndex) {
+        case PARAM_HUE_INVERT: return hueInvert ? 1.0f : 0.0f;
+        case PARAM_SATURATION_INVERT: return saturationInvert ? 1.0f : 0.0f;
+        case PARAM_BRIGHTNESS_INVERT: return brightnessInvert ? 1.0f : 0.0f;
+        case PARAM_HORIZONTAL_MIRROR: return horizontalMirror ? 1.0f : 0.0f;
+        case PARAM_VERTICAL_MIRROR: return verticalMirror ? 1.0f : 0.0f;
+        case PARAM_LUMAKEY_INVERT: return lumakeyInvert ? 1.0f : 0.0f;
+        case PARAM_TOROID_ENABLED: return toroidEnabled ? 1.0f : 0.0f;
+        case PARAM_MIRROR_MODE_ENABLED: return mirrorModeEnabled ? 1.0f : 0.0f;
+        case PARAM_WET_MODE_ENABLED: return wetModeEnabled ? 1.0f : 0.0f;
+        case PARAM_LUMAKEY_VALUE: return lumakeyValue;
+        case PARAM_MIX: return mix;
+        case PARAM_HUE: return hue;
+        case PARAM_SATURATION: return saturation;
+        case PARAM_BRIGHTNESS: return brightness;
+        case PARAM_TEMPORAL_FILTER_MIX: return temporalFilterMix;
+        case PARAM_TEMPORAL_FILTER_RESONANCE: return temporalFilterResonance;
+        case PARAM_SHARPEN_AMOUNT: return sharpenAmount;
+        case PARAM_X_DISPLACE: return xDisplace;
+        case PARAM_Y_DISPLACE: return yDisplace;
+        case PARAM_Z_DISPLACE: return zDisplace;
+        case PARAM_ROTATE: return rotate;
+        case PARAM_HUE_MODULATION: return hueModulation;
+        case PARAM_HUE_OFFSET: return hueOffset;
+        case PARAM_HUE_LFO: return hueLFO;
+        case PARAM_Z_FREQUENCY: return zFrequency;
+        case PARAM_X_FREQUENCY: return xFrequency;
+        case PARAM_Y_FREQUENCY: return yFrequency;
+        case PARAM_DELAY_AMOUNT: return delayAmount;
+        case PARAM_X_LFO_AMP: return xLfoAmp;
+        case PARAM_X_LFO_RATE: return xLfoRate;
+        case PARAM_Y_LFO_AMP: return yLfoAmp;
+        case PARAM_Y_LFO_RATE: return yLfoRate;
+        case PARAM_Z_LFO_AMP: return zLfoAmp;
+        case PARAM_Z_LFO_RATE: return zLfoRate;
+        case PARAM_ROTATE_LFO_AMP: return rotateLfoAmp;
+        case PARAM_ROTATE_LFO_RATE: return rotateLfoRate;
+        case PARAM_V_LUMAKEY_VALUE: return vLumakeyValue;
+        case PARAM_V_MIX: return vMix;
+        case PARAM_V_HUE: return vHue;
+        case PARAM_V_SATURATION: return vSaturation;
+        case PARAM_V_BRIGHTNESS: return vBrightness;
+        case PARAM_V_TEMPORAL_FILTER_MIX: return vTemporalFilterMix;
+        case PARAM_V_TEMPORAL_FILTER_RESONANCE: return vTemporalFilterResonance;
+        case PARAM_V_SHARPEN_AMOUNT: return vSharpenAmount;
+        case PARAM_V_X_DISPLACE: return vXDisplace;
+        case PARAM_V_Y_DISPLACE: return vYDisplace;
+        case PARAM_V_Z_DISPLACE: return vZDisplace;
+        case PARAM_V_ROTATE: return vRotate;
+        case PARAM_V_HUE_MODULATION: return vHueModulation;
+        case PARAM_V_HUE_OFFSET: return vHueOffset;
+        case PARAM_V_HUE_LFO: return vHueLFO;
+        case PARAM_VIDEO_REACTIVE_MODE: return videoReactiveMode ? 1.0f : 0.0f;
+        case PARAM_LFO_AMP_MODE: return lfoAmpMode ? 1.0f : 0.0f;
+        case PARAM_LFO_RATE_MODE: return lfoRateMode ? 1.0f : 0.0f;
+        default: return 0.0f;
+    }
+}
+
+void ParameterManager::setParameterValue(int paramIndex, float value, bool recordable) {
+    bool enabled = value >= 0.5f;
+    switch (paramIndex) {
+        case PARAM_HUE_INVERT: setHueInverted(enabled); break;
+        case PARAM_SATURATION_INVERT: setSaturationInverted(enabled); break;
+        case PARAM_BRIGHTNESS_INVERT: setBrightnessInverted(enabled); break;
+        case PARAM_HORIZONTAL_MIRROR: setHorizontalMirrorEnabled(enabled); break;
+        case PARAM_VERTICAL_MIRROR: setVerticalMirrorEnabled(enabled); break;
+        case PARAM_LUMAKEY_INVERT: setLumakeyInverted(enabled); break;
+        case PARAM_TOROID_ENABLED: setToroidEnabled(enabled); break;
+        case PARAM_MIRROR_MODE_ENABLED: setMirrorModeEnabled(enabled); break;
+        case PARAM_WET_MODE_ENABLED: setWetModeEnabled(enabled); break;
+        case PARAM_LUMAKEY_VALUE: setLumakeyValue(value, recordable); break;
+        case PARAM_MIX: setMix(value, recordable); break;
+        case PARAM_HUE: setHue(value, recordable); break;
+        case PARAM_SATURATION: setSaturation(value, recordable); break;
+        case PARAM_BRIGHTNESS: setBrightness(value, recordable); break;
+        case PARAM_TEMPORAL_FILTER_MIX: setTemporalFilterMix(value, recordable); break;
+        case PARAM_TEMPORAL_FILTER_RESONANCE: setTemporalFilterResonance(value, recordable); break;
+        case PARAM_SHARPEN_AMOUNT: setSharpenAmount(value, recordable); break;
+        case PARAM_X_DISPLACE: setXDisplace(value, recordable); break;
+        case PARAM_Y_DISPLACE: setYDisplace(value, recordable); break;
+        case PARAM_Z_DISPLACE: setZDisplace(value, recordable); break;
+        case PARAM_ROTATE: setRotate(value, recordable); break;
+        case PARAM_HUE_MODULATION: setHueModulation(value, recordable); break;
+        case PARAM_HUE_OFFSET: setHueOffset(value, recordable); break;
+        case PARAM_HUE_LFO: setHueLFO(value, recordable); break;
+        case PARAM_Z_FREQUENCY: setZFrequency(value, recordable); break;
+        case PARAM_X_FREQUENCY: setXFrequency(value, recordable); break;
+        case PARAM_Y_FREQUENCY: setYFrequency(value, recordable); break;
+        case PARAM_DELAY_AMOUNT: setDelayAmount(value, recordable); break;
+        case PARAM_X_LFO_AMP: setXLfoAmp(value, recordable); break;
+        case PARAM_X_LFO_RATE: setXLfoRate(value, recordable); break;
+        case PARAM_Y_LFO_AMP: setYLfoAmp(value, recordable); break;
+        case PARAM_Y_LFO_RATE: setYLfoRate(value, recordable); break;
+        case PARAM_Z_LFO_AMP: setZLfoAmp(value, recordable); break;
+        case PARAM_Z_LFO_RATE: setZLfoRate(value, recordable); break;
+        case PARAM_ROTATE_LFO_AMP: setRotateLfoAmp(value, recordable); break;
+        case PARAM_ROTATE_LFO_RATE: setRotateLfoRate(value, recordable); break;
+        case PARAM_V_LUMAKEY_VALUE: setVLumakeyValue(value, recordable); break;
+        case PARAM_V_MIX: setVMix(value, recordable); break;
+        case PARAM_V_HUE: setVHue(value, recordable); break;
+        case PARAM_V_SATURATION: setVSaturation(value, recordable); break;
+        case PARAM_V_BRIGHTNESS: setVBrightness(value, recordable); break;
+        case PARAM_V_TEMPORAL_FILTER_MIX: setVTemporalFilterMix(value, recordable); break;
+        case PARAM_V_TEMPORAL_FILTER_RESONANCE: setVTemporalFilterResonance(value, recordable); break;
+        case PARAM_V_SHARPEN_AMOUNT: setVSharpenAmount(value, recordable); break;
+        case PARAM_V_X_DISPLACE: setVXDisplace(value, recordable); break;
+        case PARAM_V_Y_DISPLACE: setVYDisplace(value, recordable); break;
+        case PARAM_V_Z_DISPLACE: setVZDisplace(value, recordable); break;
+        case PARAM_V_ROTATE: setVRotate(value, recordable); break;
+        case PARAM_V_HUE_MODULATION: setVHueModulation(value, recordable); break;
+        case PARAM_V_HUE_OFFSET: setVHueOffset(value, recordable); break;
+        case PARAM_V_HUE_LFO: setVHueLFO(value, recordable); break;
+        case PARAM_VIDEO_REACTIVE_MODE: setVideoReactiveEnabled(enabled); break;
+        case PARAM_LFO_AMP_MODE: setLfoAmpModeEnabled(enabled); break;
+        case PARAM_LFO_RATE_MODE: setLfoRateModeEnabled(enabled); break;
+        default:
+            ofLogWarning("ParameterManager") << "setParameterValue: invalid parameter index " << paramIndex;
+            break;
+    }
+}
+
 
 // --- Toggle state getters/setters (Implementation remains the same) ---
 bool ParameterManager::isHueInverted() const { return hueInvert; }
@@ -602,235 +928,254 @@ void ParameterManager::setMirrorModeEnabled(bool enabled) { mirrorModeEnabled =
 bool ParameterManager::isWetModeEnabled() const { return wetModeEnabled; }
 void ParameterManager::setWetModeEnabled(bool enabled) { wetModeEnabled = enabled; }
 
-// Parameter getters/setters (Updated to include audio offsets)
-float ParameterManager::getLumakeyValue() const { return lumakeyValue + audioLumakeyValueOffset + getPLockValue(PLockIndex::LUMAKEY_VALUE); }
+// Parameter getters/setters (Getters include modulation matrix output)
+float ParameterManager::getLumakeyValue() const { return (lumakeyValue + modulation.getOffset(PARAM_LUMAKEY_VALUE) + getPLockValue(PARAM_LUMAKEY_VALUE)) * modulation.getScale(PARAM_LUMAKEY_VALUE); }
 void ParameterManager::setLumakeyValue(float value, bool recordable) {
     lumakeyValue = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::LUMAKEY_VALUE, value);
+        recordParameter(PARAM_LUMAKEY_VALUE, value);
     }
 }
 
-float ParameterManager::getMix() const { return mix + audioMixOffset + getPLockValue(PLockIndex::MIX); }
+float ParameterManager::getMix() const { return (mix + modulation.getOffset(PARAM_MIX) + getPLockValue(PARAM_MIX)) * modulation.getScale(PARAM_MIX); }
 void ParameterManager::setMix(float value, bool recordable) {
     mix = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::MIX, value);
+        recordParameter(PARAM_MIX, value);
     }
 }
 
 // Note: P-Lock for Hue, Sat, Bright, ZDisplace, HueMod is multiplicative in original code.
-// Keeping that logic for P-Lock, but adding audio offset additively.
-float ParameterManager::getHue() const { return (hue + audioHueOffset) * (1.0f + getPLockValue(PLockIndex::HUE)); }
+// Keeping that logic for P-Lock; modulation offsets add, modulation scales multiply the result.
+float ParameterManager::getHue() const { return ((hue + modulation.getOffset(PARAM_HUE)) * (1.0f + getPLockValue(PARAM_HUE))) * modulation.getScale(PARAM_HUE); }
 void ParameterManager::setHue(float value, bool recordable) {
     hue = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::HUE, value);
+        recordParameter(PARAM_HUE, value);
     }
 }
 
-float ParameterManager::getSaturation() const { return (saturation + audioSaturationOffset) * (1.0f + getPLockValue(PLockIndex::SATURATION)); }
+float ParameterManager::getSaturation() const { return ((saturation + modulation.getOffset(PARAM_SATURATION)) * (1.0f + getPLockValue(PARAM_SATURATION))) * modulation.getScale(PARAM_SATURATION); }
 void ParameterManager::setSaturation(float value, bool recordable) {
     saturation = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::SATURATION, value);
+        recordParameter(PARAM_SATURATION, value);
     }
 }
 
-float ParameterManager::getBrightness() const { return (brightness + audioBrightnessOffset) * (1.0f + getPLockValue(PLockIndex::BRIGHTNESS)); }
+float ParameterManager::getBrightness() const { return ((brightness + modulation.getOffset(PARAM_BRIGHTNESS)) * (1.0f + getPLockValue(PARAM_BRIGHTNESS))) * modulation.getScale(PARAM_BRIGHTNESS); }
 void ParameterManager::setBrightness(float value, bool recordable) {
     brightness = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::BRIGHTNESS, value);
+        recordParameter(PARAM_BRIGHTNESS, value);
     }
 }
 
-float ParameterManager::getTemporalFilterMix() const { return temporalFilterMix + audioTemporalFilterMixOffset + getPLockValue(PLockIndex::TEMPORAL_FILTER_MIX); }
+float ParameterManager::getTemporalFilterMix() const { return (temporalFilterMix + modulation.getOffset(PARAM_TEMPORAL_FILTER_MIX) + getPLockValue(PARAM_TEMPORAL_FILTER_MIX)) * modulation.getScale(PARAM_TEMPORAL_FILTER_MIX); }
 void ParameterManager::setTemporalFilterMix(float value, bool recordable) {
     temporalFilterMix = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::TEMPORAL_FILTER_MIX, value);
+        recordParameter(PARAM_TEMPORAL_FILTER_MIX, value);
     }
 }
 
-float ParameterManager::getTemporalFilterResonance() const { return temporalFilterResonance + audioTemporalFilterResonanceOffset + getPLockValue(PLockIndex::TEMPORAL_FILTER_RESONANCE); }
+float ParameterManager::getTemporalFilterResonance() const { return (temporalFilterResonance + modulation.getOffset(PARAM_TEMPORAL_FILTER_RESONANCE) + getPLockValue(PARAM_TEMPORAL_FILTER_RESONANCE)) * modulation.getScale(PARAM_TEMPORAL_FILTER_RESONANCE); }
 void ParameterManager::setTemporalFilterResonance(float value, bool recordable) {
     temporalFilterResonance = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::TEMPORAL_FILTER_RESONANCE, value);
+        recordParameter(PARAM_TEMPORAL_FILTER_RESONANCE, value);
     }
 }
 
-float ParameterManager::getSharpenAmount() const { return sharpenAmount + audioSharpenAmountOffset + getPLockValue(PLockIndex::SHARPEN_AMOUNT); }
+float ParameterManager::getSharpenAmount() const { return (sharpenAmount + modulation.getOffset(PARAM_SHARPEN_AMOUNT) + getPLockValue(PARAM_SHARPEN_AMOUNT)) * modulation.getScale(PARAM_SHARPEN_AMOUNT); }
 void ParameterManager::setSharpenAmount(float value, bool recordable) {
     sharpenAmount = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::SHARPEN_AMOUNT, value);
+        recordParameter(PARAM_SHARPEN_AMOUNT, value);
     }
 }
 
-float ParameterManager::getXDisplace() const { return xDisplace + audioXDisplaceOffset + getPLockValue(PLockIndex::X_DISPLACE); }
+float ParameterManager::getXDisplace() const { return (xDisplace + modulation.getOffset(PARAM_X_DISPLACE) + getPLockValue(PARAM_X_DISPLACE)) * modulation.getScale(PARAM_X_DISPLACE); }
 void ParameterManager::setXDisplace(float value, bool recordable) {
     xDisplace = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::X_DISPLACE, value);
+        recordParameter(PARAM_X_DISPLACE, value);
     }
 }
 
-float ParameterManager::getYDisplace() const { return yDisplace + audioYDisplaceOffset + getPLockValue(PLockIndex::Y_DISPLACE); }
+float ParameterManager::getYDisplace() const { return (yDisplace + modulation.getOffset(PARAM_Y_DISPLACE) + getPLockValue(PARAM_Y_DISPLACE)) * modulation.getScale(PARAM_Y_DISPLACE); }
 void ParameterManager::setYDisplace(float value, bool recordable) {
     yDisplace = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::Y_DISPLACE, value);
+        recordParameter(PARAM_Y_DISPLACE, value);
     }
 }
 
-float ParameterManager::getZDisplace() const { return (zDisplace + audioZDisplaceOffset) * (1.0f + getPLockValue(PLockIndex::Z_DISPLACE)); }
+float ParameterManager::getZDisplace() const { return ((zDisplace + modulation.getOffset(PARAM_Z_DISPLACE)) * (1.0f + getPLockValue(PARAM_Z_DISPLACE))) * modulation.getScale(PARAM_Z_DISPLACE); }
 void ParameterManager::setZDisplace(float value, bool recordable) {
     zDisplace = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::Z_DISPLACE, value);
+        recordParameter(PARAM_Z_DISPLACE, value);
     }
 }
 
-// Frequency getters/setters - Additive audio offset, no P-Lock
+// Frequency getters/setters - Additive modulation and P-Lock
 float ParameterManager::getZFrequency() const {
-    return zFrequency + audioZFrequencyOffset;
+    return (zFrequency + modulation.getOffset(PARAM_Z_FREQUENCY) + getPLockValue(PARAM_Z_FREQUENCY)) * modulation.getScale(PARAM_Z_FREQUENCY);
 }
 
 void ParameterManager::setZFrequency(float value, bool recordable) {
     zFrequency = value;
-    // No P-Lock recording for frequency
+    if (recordable) {
+        recordParameter(PARAM_Z_FREQUENCY, value);
+    }
 }
 
 float ParameterManager::getXFrequency() const {
-    return xFrequency + audioXFrequencyOffset;
+    return (xFrequency + modulation.getOffset(PARAM_X_FREQUENCY) + getPLockValue(PARAM_X_FREQUENCY)) * modulation.getScale(PARAM_X_FREQUENCY);
 }
 
 void ParameterManager::setXFrequency(float value, bool recordable) {
     xFrequency = value;
-    // No P-Lock recording for frequency
+    if (recordable) {
+        recordParameter(PARAM_X_FREQUENCY, value);
+    }
 }
 
 float ParameterManager::getYFrequency() const {
-    return yFrequency + audioYFrequencyOffset;
+    return (yFrequency + modulation.getOffset(PARAM_Y_FREQUENCY) + getPLockValue(PARAM_Y_FREQUENCY)) * modulation.getScale(PARAM_Y_FREQUENCY);
 }
 
 void ParameterManager::setYFrequency(float value, bool recordable) {
     yFrequency = value;
-    // No P-Lock recording for frequency
+    if (recordable) {
+        recordParameter(PARAM_Y_FREQUENCY, value);
+    }
 }
 
-float ParameterManager::getRotate() const { return rotate + audioRotateOffset + getPLockValue(PLockIndex::ROTATE); }
+float ParameterManager::getRotate() const { return (rotate + modulation.getOffset(PARAM_ROTATE) + getPLockValue(PARAM_ROTATE)) * modulation.getScale(PARAM_ROTATE); }
 void ParameterManager::setRotate(float value, bool recordable) {
     rotate = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::ROTATE, value);
+        recordParameter(PARAM_ROTATE, value);
     }
 }
 
-float ParameterManager::getHueModulation() const { return (hueModulation + audioHueModulationOffset) * (1.0f - getPLockValue(PLockIndex::HUE_MODULATION)); }
+float ParameterManager::getHueModulation() const { return ((hueModulation + modulation.getOffset(PARAM_HUE_MODULATION)) * (1.0f - getPLockValue(PARAM_HUE_MODULATION))) * modulation.getScale(PARAM_HUE_MODULATION); }
 void ParameterManager::setHueModulation(float value, bool recordable) {
     hueModulation = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::HUE_MODULATION, value);
+        recordParameter(PARAM_HUE_MODULATION, value);
     }
 }
 
-float ParameterManager::getHueOffset() const { return hueOffset + audioHueOffsetOffset + getPLockValue(PLockIndex::HUE_OFFSET); }
+float ParameterManager::getHueOffset() const { return (hueOffset + modulation.getOffset(PARAM_HUE_OFFSET) + getPLockValue(PARAM_HUE_OFFSET)) * modulation.getScale(PARAM_HUE_OFFSET); }
 void ParameterManager::setHueOffset(float value, bool recordable) {
     hueOffset = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::HUE_OFFSET, value);
+        recordParameter(PARAM_HUE_OFFSET, value);
     }
 }
 
-float ParameterManager::getHueLFO() const { return hueLFO + audioHueLFOOffset + getPLockValue(PLockIndex::HUE_LFO); }
+float ParameterManager::getHueLFO() const { return (hueLFO + modulation.getOffset(PARAM_HUE_LFO) + getPLockValue(PARAM_HUE_LFO)) * modulation.getScale(PARAM_HUE_LFO); }
 void ParameterManager::setHueLFO(float value, bool recordable) {
     hueLFO = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::HUE_LFO, value);
+        recordParameter(PARAM_HUE_LFO, value);
+    }
+}
+
+float ParameterManager::getBaseDelayAmount() const {
+    if (delaySyncBeats > 0.0f) {
+        // Note length in frames at the current tempo
+        float frameRate = ofGetTargetFrameRate() > 0 ? ofGetTargetFrameRate() : ofGetFrameRate();
+        return transport.beatsToFrames(delaySyncBeats, frameRate, ofGetElapsedTimeMicros());
     }
+    return delayAmount;
+}
+
+float ParameterManager::getDelayAmount() const {
+    float frames = getBaseDelayAmount() + modulation.getOffset(PARAM_DELAY_AMOUNT) + getPLockValue(PARAM_DELAY_AMOUNT) * (P_LOCK_SIZE - 1.0f);
+    return frames * modulation.getScale(PARAM_DELAY_AMOUNT);
 }
 
-int ParameterManager::getDelayAmount() const { return delayAmount + audioDelayAmountOffset + (int)(getPLockValue(PLockIndex::DELAY_AMOUNT) * (P_LOCK_SIZE - 1.0f)); }
-void ParameterManager::setDelayAmount(int value, bool recordable) {
+void ParameterManager::setDelayAmount(float value, bool recordable) {
     delayAmount = value; // Set the base value
     if (recordable) {
-        recordParameter(PLockIndex::DELAY_AMOUNT, static_cast<float>(value) / (P_LOCK_SIZE - 1.0f));
+        recordParameter(PARAM_DELAY_AMOUNT, value / (P_LOCK_SIZE - 1.0f));
     }
 }
 
 // LFO getters/setters
-float ParameterManager::getXLfoAmp() const { return xLfoAmp; }
-void ParameterManager::setXLfoAmp(float value) { xLfoAmp = value; }
+float ParameterManager::getXLfoAmp() const { return xLfoAmp + getPLockValue(PARAM_X_LFO_AMP); }
+void ParameterManager::setXLfoAmp(float value, bool recordable) { xLfoAmp = value; if (recordable) recordParameter(PARAM_X_LFO_AMP, value); }
 
-float ParameterManager::getXLfoRate() const { return xLfoRate; }
-void ParameterManager::setXLfoRate(float value) { xLfoRate = value; }
+float ParameterManager::getXLfoRate() const { return xLfoRate + getPLockValue(PARAM_X_LFO_RATE); }
+void ParameterManager::setXLfoRate(float value, bool recordable) { xLfoRate = value; if (recordable) recordParameter(PARAM_X_LFO_RATE, value); }
 
-float ParameterManager::getYLfoAmp() const { return yLfoAmp; }
-void ParameterManager::setYLfoAmp(float value) { yLfoAmp = value; }
+float ParameterManager::getYLfoAmp() const { return yLfoAmp + getPLockValue(PARAM_Y_LFO_AMP); }
+void ParameterManager::setYLfoAmp(float value, bool recordable) { yLfoAmp = value; if (recordable) recordParameter(PARAM_Y_LFO_AMP, value); }
 
-float ParameterManager::getYLfoRate() const { return yLfoRate; }
-void ParameterManager::setYLfoRate(float value) { yLfoRate = value; }
+float ParameterManager::getYLfoRate() const { return yLfoRate + getPLockValue(PARAM_Y_LFO_RATE); }
+void ParameterManager::setYLfoRate(float value, bool recordable) { yLfoRate = value; if (recordable) recordParameter(PARAM_Y_LFO_RATE, value); }
 
-float ParameterManager::getZLfoAmp() const { return zLfoAmp; }
-void ParameterManager::setZLfoAmp(float value) { zLfoAmp = value; }
+float ParameterManager::getZLfoAmp() const { return zLfoAmp + getPLockValue(PARAM_Z_LFO_AMP); }
+void ParameterManager::setZLfoAmp(float value, bool recordable) { zLfoAmp = value; if (recordable) recordParameter(PARAM_Z_LFO_AMP, value); }
 
-float ParameterManager::getZLfoRate() const { return zLfoRate; }
-void ParameterManager::setZLfoRate(float value) { zLfoRate = value; }
+float ParameterManager::getZLfoRate() const { return zLfoRate + getPLockValue(PARAM_Z_LFO_RATE); }
+void ParameterManager::setZLfoRate(float value, bool recordable) { zLfoRate = value; if (recordable) recordParameter(PARAM_Z_LFO_RATE, value); }
 
-float ParameterManager::getRotateLfoAmp() const { return rotateLfoAmp; }
-void ParameterManager::setRotateLfoAmp(float value) { rotateLfoAmp = value; }
+float ParameterManager::getRotateLfoAmp() const { return rotateLfoAmp + getPLockValue(PARAM_ROTATE_LFO_AMP); }
+void ParameterManager::setRotateLfoAmp(float value, bool recordable) { rotateLfoAmp = value; if (recordable) recordParameter(PARAM_ROTATE_LFO_AMP, value); }
 
-float ParameterManager::getRotateLfoRate() const { return rotateLfoRate; }
-void ParameterManager::setRotateLfoRate(float value) { rotateLfoRate = value; }
+float ParameterManager::getRotateLfoRate() const { return rotateLfoRate + getPLockValue(PARAM_ROTATE_LFO_RATE); }
+void ParameterManager::setRotateLfoRate(float value, bool recordable) { rotateLfoRate = value; if (recordable) recordParameter(PARAM_ROTATE_LFO_RATE, value); }
 
 // Video reactivity getters/setters
-float ParameterManager::getVLumakeyValue() const { return vLumakeyValue; }
-void ParameterManager::setVLumakeyValue(float value) { vLumakeyValue = value; }
+float ParameterManager::getVLumakeyValue() const { return vLumakeyValue + getPLockValue(PARAM_V_LUMAKEY_VALUE); }
+void ParameterManager::setVLumakeyValue(float value, bool recordable) { vLumakeyValue = value; if (recordable) recordParameter(PARAM_V_LUMAKEY_VALUE, value); }
 
-float ParameterManager::getVMix() const { return vMix; }
-void ParameterManager::setVMix(float value) { vMix = value; }
+float ParameterManager::getVMix() const { return vMix + getPLockValue(PARAM_V_MIX); }
+void ParameterManager::setVMix(float value, bool recordable) { vMix = value; if (recordable) recordParameter(PARAM_V_MIX, value); }
 
-float ParameterManager::getVHue() const { return vHue; }
-void ParameterManager::setVHue(float value) { vHue = value; }
+float ParameterManager::getVHue() const { return vHue + getPLockValue(PARAM_V_HUE); }
+void ParameterManager::setVHue(float value, bool recordable) { vHue = value; if (recordable) recordParameter(PARAM_V_HUE, value); }
 
-float ParameterManager::getVSaturation() const { return vSaturation; }
-void ParameterManager::setVSaturation(float value) { vSaturation = value; }
+float ParameterManager::getVSaturation() const { return vSaturation + getPLockValue(PARAM_V_SATURATION); }
+void ParameterManager::setVSaturation(float value, bool recordable) { vSaturation = value; if (recordable) recordParameter(PARAM_V_SATURATION, value); }
 
-float ParameterManager::getVBrightness() const { return vBrightness; }
-void ParameterManager::setVBrightness(float value) { vBrightness = value; }
+float ParameterManager::getVBrightness() const { return vBrightness + getPLockValue(PARAM_V_BRIGHTNESS); }
+void ParameterManager::setVBrightness(float value, bool recordable) { vBrightness = value; if (recordable) recordParameter(PARAM_V_BRIGHTNESS, value); }
 
-float ParameterManager::getVTemporalFilterMix() const { return vTemporalFilterMix; }
-void ParameterManager::setVTemporalFilterMix(float value) { vTemporalFilterMix = value; }
+float ParameterManager::getVTemporalFilterMix() const { return vTemporalFilterMix + getPLockValue(PARAM_V_TEMPORAL_FILTER_MIX); }
+void ParameterManager::setVTemporalFilterMix(float value, bool recordable) { vTemporalFilterMix = value; if (recordable) recordParameter(PARAM_V_TEMPORAL_FILTER_MIX, value); }
 
-float ParameterManager::getVTemporalFilterResonance() const { return vTemporalFilterResonance; }
-void ParameterManager::setVTemporalFilterResonance(float value) { vTemporalFilterResonance = value; }
+float ParameterManager::getVTemporalFilterResonance() const { return vTemporalFilterResonance + getPLockValue(PARAM_V_TEMPORAL_FILTER_RESONANCE); }
+void ParameterManager::setVTemporalFilterResonance(float value, bool recordable) { vTemporalFilterResonance = value; if (recordable) recordParameter(PARAM_V_TEMPORAL_FILTER_RESONANCE, value); }
 
-float ParameterManager::getVSharpenAmount() const { return vSharpenAmount; }
-void ParameterManager::setVSharpenAmount(float value) { vSharpenAmount = value; }
+float ParameterManager::getVSharpenAmount() const { return vSharpenAmount + getPLockValue(PARAM_V_SHARPEN_AMOUNT); }
+void ParameterManager::setVSharpenAmount(float value, bool recordable) { vSharpenAmount = value; if (recordable) recordParameter(PARAM_V_SHARPEN_AMOUNT, value); }
 
-float ParameterManager::getVXDisplace() const { return vXDisplace; }
-void ParameterManager::setVXDisplace(float value) { vXDisplace = value; }
+float ParameterManager::getVXDisplace() const { return vXDisplace + getPLockValue(PARAM_V_X_DISPLACE); }
+void ParameterManager::setVXDisplace(float value, bool recordable) { vXDisplace = value; if (recordable) recordParameter(PARAM_V_X_DISPLACE, value); }
 
-float ParameterManager::getVYDisplace() const { return vYDisplace; }
-void ParameterManager::setVYDisplace(float value) { vYDisplace = value; }
+float ParameterManager::getVYDisplace() const { return vYDisplace + getPLockValue(PARAM_V_Y_DISPLACE); }
+void ParameterManager::setVYDisplace(float value, bool recordable) { vYDisplace = value; if (recordable) recordParameter(PARAM_V_Y_DISPLACE, value); }
 
-float ParameterManager::getVZDisplace() const { return vZDisplace; }
-void ParameterManager::setVZDisplace(float value) { vZDisplace = value; }
+float ParameterManager::getVZDisplace() const { return vZDisplace + getPLockValue(PARAM_V_Z_DISPLACE); }
+void ParameterManager::setVZDisplace(float value, bool recordable) { vZDisplace = value; if (recordable) recordParameter(PARAM_V_Z_DISPLACE, value); }
 
-float ParameterManager::getVRotate() const { return vRotate; }
-void ParameterManager::setVRotate(float value) { vRotate = value; }
+float ParameterManager::getVRotate() const { return vRotate + getPLockValue(PARAM_V_ROTATE); }
+void ParameterManager::setVRotate(float value, bool recordable) { vRotate = value; if (recordable) recordParameter(PARAM_V_ROTATE, value); }
 
-float ParameterManager::getVHueModulation() const { return vHueModulation; }
-void ParameterManager::setVHueModulation(float value) { vHueModulation = value; }
+float ParameterManager::getVHueModulation() const { return vHueModulation + getPLockValue(PARAM_V_HUE_MODULATION); }
+void ParameterManager::setVHueModulation(float value, bool recordable) { vHueModulation = value; if (recordable) recordParameter(PARAM_V_HUE_MODULATION, value); }
 
-float ParameterManager::getVHueOffset() const { return vHueOffset; }
-void ParameterManager::setVHueOffset(float value) { vHueOffset = value; }
+float ParameterManager::getVHueOffset() const { return vHueOffset + getPLockValue(PARAM_V_HUE_OFFSET); }
+void ParameterManager::setVHueOffset(float value, bool recordable) { vHueOffset = value; if (recordable) recordParameter(PARAM_V_HUE_OFFSET, value); }
 
-float ParameterManager::getVHueLFO() const { return vHueLFO; }
-void ParameterManager::setVHueLFO(float value) { vHueLFO = value; }
+float ParameterManager::getVHueLFO() const { return vHueLFO + getPLockValue(PARAM_V_HUE_LFO); }
+void ParameterManager::setVHueLFO(float value, bool recordable) { vHueLFO = value; if (recordable) recordParameter(PARAM_V_HUE_LFO, value); }
 
 // Mode getters/setters
 bool ParameterManager::isVideoReactiveEnabled() const { return videoReactiveMode; }
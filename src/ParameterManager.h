@@ -2,6 +2,10 @@
 
 #include "ofMain.h"
 #include "ofxXmlSettings.h"
+#include "Transport.h"
+#include "PLockSequencer.h"
+#include "ModulationMatrix.h"
+#include "PresetBank.h"
 
 /**
  * @class ParameterManager
@@ -36,21 +40,40 @@ public:
     // Core methods
     void setup();
     void update();
+    void evaluate(); // Once per frame after MIDI, audio and P-Lock updates; fills the effective snapshot
 
     // P-Lock system
     void startRecording();
     void stopRecording();
-    void clearAllLocks();
+    void clearAllLocks(); // Erases the current pattern, in plocks.bin too; on an explicit request or a reset only
     void updatePLocks();
 
-    // Settings management
-    bool loadSettings();
-    bool saveSettings();
+    // Settings management (the document itself is owned by the app's SettingsStore)
     void resetToDefaults();
 
-    // Get current P-Lock values (for smooth transitions)
+    // Get current P-Lock values (for smooth transitions), indexed by ParamId
     float getPLockValue(int paramIndex) const;
 
+    // Pattern banks (persisted in plocks.bin); switching only swaps pointers
+    void selectPattern(int index);
+    int getCurrentPattern() const { return currentPattern; }
+    int getNumPatterns() const { return patternBank.getNumPatterns(); }
+    void setPatternChain(int index, int next, int repeats); // next = -1 loops the pattern
+
+    // Presets: snapshots of every base value, recalled instantly or morphed over time
+    void storePreset(int slot);
+    void recallPreset(int slot); // Morphs over getPresetMorphTime()
+    void recallPreset(int slot, float morphSeconds);
+    int getCurrentPreset() const { return currentPreset; } // -1 = none recalled
+    bool isPresetMorphing() const { return morphActive; }
+    float getPresetMorphTime() const { return presetMorphTime; }
+    void setPresetMorphTime(float seconds) { presetMorphTime = std::max(0.0f, seconds); }
+    PresetBank& getPresetBank() { return presets; }
+
+    // Lane lengths, step rate and interpolation
+    PLockSequencer& getSequencer() { return sequencer; }
+    const PLockSequencer& getSequencer() const { return sequencer; }
+
     // Toggle state getters/setters
     bool isHueInverted() const;
     void setHueInverted(bool enabled);
@@ -102,30 +125,7 @@ public:
     int getOscPort() const { return oscPort; }
     void setOscPort(int port) { oscPort = port; }
 
-    // --- Audio Reactivity Offset Setters ---
-    // These methods allow AudioReactivityManager to set the calculated offset
-    void setAudioLumakeyValueOffset(float offset);
-    void setAudioMixOffset(float offset);
-    void setAudioHueOffset(float offset);
-    void setAudioSaturationOffset(float offset);
-    void setAudioBrightnessOffset(float offset);
-    void setAudioTemporalFilterMixOffset(float offset);
-    void setAudioTemporalFilterResonanceOffset(float offset);
-    void setAudioSharpenAmountOffset(float offset);
-    void setAudioXDisplaceOffset(float offset);
-    void setAudioYDisplaceOffset(float offset);
-    void setAudioZDisplaceOffset(float offset);
-    void setAudioRotateOffset(float offset);
-    void setAudioHueModulationOffset(float offset);
-    void setAudioHueOffsetOffset(float offset); // Renamed to avoid clash with base param name
-    void setAudioHueLFOOffset(float offset);
-    void setAudioDelayAmountOffset(int offset);
-    // Frequency offsets (if needed in future, currently not mapped in default settings)
-    void setAudioZFrequencyOffset(float offset);
-    void setAudioXFrequencyOffset(float offset);
-    void setAudioYFrequencyOffset(float offset);
-
-    // Parameter getters (These will combine base + audio offset + P-Lock)
+    // Parameter getters (These combine base + modulation + P-Lock)
     float getLumakeyValue() const;
     float getMix() const;
     float getHue() const;
@@ -144,7 +144,7 @@ public:
     float getHueModulation() const;
     float getHueOffset() const;
     float getHueLFO() const;
-    int getDelayAmount() const;
+    float getDelayAmount() const; // Frames; fractions blend two adjacent history frames
 
     // Base Parameter setters (Only set the base value)
     void setLumakeyValue(float value, bool recordable = true);
@@ -165,57 +165,57 @@ public:
     void setHueModulation(float value, bool recordable = true);
     void setHueOffset(float value, bool recordable = true);
     void setHueLFO(float value, bool recordable = true);
-    void setDelayAmount(int value, bool recordable = true);
+    void setDelayAmount(float value, bool recordable = true);
 
     // LFO getters/setters (These remain separate)
     float getXLfoAmp() const;
-    void setXLfoAmp(float value);
+    void setXLfoAmp(float value, bool recordable = true);
     float getXLfoRate() const;
-    void setXLfoRate(float value);
+    void setXLfoRate(float value, bool recordable = true);
     float getYLfoAmp() const;
-    void setYLfoAmp(float value);
+    void setYLfoAmp(float value, bool recordable = true);
     float getYLfoRate() const;
-    void setYLfoRate(float value);
+    void setYLfoRate(float value, bool recordable = true);
     float getZLfoAmp() const;
-    void setZLfoAmp(float value);
+    void setZLfoAmp(float value, bool recordable = true);
     float getZLfoRate() const;
-    void setZLfoRate(float value);
+    void setZLfoRate(float value, bool recordable = true);
     float getRotateLfoAmp() const;
-    void setRotateLfoAmp(float value);
+    void setRotateLfoAmp(float value, bool recordable = true);
     float getRotateLfoRate() const;
-    void setRotateLfoRate(float value);
+    void setRotateLfoRate(float value, bool recordable = true);
 
     // Video reactivity getters/setters (Keep for now, maybe remove later?)
     float getVLumakeyValue() const;
-    void setVLumakeyValue(float value);
+    void setVLumakeyValue(float value, bool recordable = true);
     float getVMix() const;
-    void setVMix(float value);
+    void setVMix(float value, bool recordable = true);
     float getVHue() const;
-    void setVHue(float value);
+    void setVHue(float value, bool recordable = true);
     float getVSaturation() const;
-    void setVSaturation(float value);
+    void setVSaturation(float value, bool recordable = true);
     float getVBrightness() const;
-    void setVBrightness(float value);
+    void setVBrightness(float value, bool recordable = true);
     float getVTemporalFilterMix() const;
-    void setVTemporalFilterMix(float value);
+    void setVTemporalFilterMix(float value, bool recordable = true);
     float getVTemporalFilterResonance() const;
-    void setVTemporalFilterResonance(float value);
+    void setVTemporalFilterResonance(float value, bool recordable = true);
     float getVSharpenAmount() const;
-    void setVSharpenAmount(float value);
+    void setVSharpenAmount(float value, bool recordable = true);
     float getVXDisplace() const;
-    void setVXDisplace(float value);
+    void setVXDisplace(float value, bool recordable = true);
     float getVYDisplace() const;
-    void setVYDisplace(float value);
+    void setVYDisplace(float value, bool recordable = true);
     float getVZDisplace() const;
-    void setVZDisplace(float value);
+    void setVZDisplace(float value, bool recordable = true);
     float getVRotate() const;
-    void setVRotate(float value);
+    void setVRotate(float value, bool recordable = true);
     float getVHueModulation() const;
-    void setVHueModulation(float value);
+    void setVHueModulation(float value, bool recordable = true);
     float getVHueOffset() const;
-    void setVHueOffset(float value);
+    void setVHueOffset(float value, bool recordable = true);
     float getVHueLFO() const;
-    void setVHueLFO(float value);
+    void setVHueLFO(float value, bool recordable = true);
 
     // Mode getters/setters
     bool isVideoReactiveEnabled() const;
@@ -227,9 +227,31 @@ public:
     bool isLfoRateModeEnabled() const;
     void setLfoRateModeEnabled(bool enabled);
 
+    // Transport sync (MIDI clock or internal tempo)
+    Transport& getTransport() { return transport; }
+    const Transport& getTransport() const { return transport; }
+    bool isLfoSyncEnabled() const { return lfoSyncEnabled; }
+    void setLfoSyncEnabled(bool enabled) { lfoSyncEnabled = enabled; }
+    bool isPLockSyncEnabled() const { return pLockSyncEnabled; }
+    void setPLockSyncEnabled(bool enabled) { pLockSyncEnabled = enabled; }
+    int getPLockSyncBars() const { return pLockSyncBars; }
+    void setPLockSyncBars(int bars) { pLockSyncBars = std::max(1, bars); }
+    float getDelaySyncBeats() const { return delaySyncBeats; }
+    void setDelaySyncBeats(float beats) { delaySyncBeats = std::max(0.0f, beats); } // 0 = free, 0.5 = 1/8 note
+    // Delay as a time instead of a frame count, matched against the history frame timestamps
+    float getDelayTimeMs() const { return delayTimeMs; }
+    void setDelayTimeMs(float ms) { delayTimeMs = std::max(0.0f, ms); } // 0 = use delayAmount
+
+    // LFOs, envelopes, audio and image sources routed onto any parameter.
+    // Audio bands are routed by AudioReactivityManager, LFOs 1-4 follow the X/Y/Z/rotate LFO controls
+    ModulationMatrix& getModulation() { return modulation; }
+    const ModulationMatrix& getModulation() const { return modulation; }
+
     // XML settings
     void loadFromXml(ofxXmlSettings& xml);
     void saveToXml(ofxXmlSettings& xml) const;
+    // Pattern bank contents to write in the background; false when the bank is mapped (already persisted)
+    bool snapshotPatternBank(std::string& path, std::string& bytes) const { return patternBank.snapshot(path, bytes); }
 
     // Mapping Getters
     int getMidiChannel(const std::string& paramId) const;
@@ -237,19 +259,48 @@ public:
     std::string getOscAddress(const std::string& paramId) const;
     const std::vector<std::string>& getAllParameterIds() const;
 
+    // Indices into getAllParameterIds(); order must match initializeParameterMaps()
+    enum ParamId {
+        // Toggles
+        PARAM_HUE_INVERT = 0, PARAM_SATURATION_INVERT, PARAM_BRIGHTNESS_INVERT, PARAM_HORIZONTAL_MIRROR,
+        PARAM_VERTICAL_MIRROR, PARAM_LUMAKEY_INVERT, PARAM_TOROID_ENABLED, PARAM_MIRROR_MODE_ENABLED,
+        PARAM_WET_MODE_ENABLED,
+        // Effect Parameters (Float)
+        PARAM_LUMAKEY_VALUE, PARAM_MIX, PARAM_HUE, PARAM_SATURATION, PARAM_BRIGHTNESS,
+        PARAM_TEMPORAL_FILTER_MIX, PARAM_TEMPORAL_FILTER_RESONANCE, PARAM_SHARPEN_AMOUNT,
+        PARAM_X_DISPLACE, PARAM_Y_DISPLACE, PARAM_Z_DISPLACE, PARAM_ROTATE, PARAM_HUE_MODULATION,
+        PARAM_HUE_OFFSET, PARAM_HUE_LFO, PARAM_Z_FREQUENCY, PARAM_X_FREQUENCY, PARAM_Y_FREQUENCY,
+        // Effect Parameters (Int)
+        PARAM_DELAY_AMOUNT,
+        // LFO Parameters
+        PARAM_X_LFO_AMP, PARAM_X_LFO_RATE, PARAM_Y_LFO_AMP, PARAM_Y_LFO_RATE, PARAM_Z_LFO_AMP, PARAM_Z_LFO_RATE,
+        PARAM_ROTATE_LFO_AMP, PARAM_ROTATE_LFO_RATE,
+        // Video Reactivity Parameters
+        PARAM_V_LUMAKEY_VALUE, PARAM_V_MIX, PARAM_V_HUE, PARAM_V_SATURATION, PARAM_V_BRIGHTNESS,
+        PARAM_V_TEMPORAL_FILTER_MIX, PARAM_V_TEMPORAL_FILTER_RESONANCE, PARAM_V_SHARPEN_AMOUNT,
+        PARAM_V_X_DISPLACE, PARAM_V_Y_DISPLACE, PARAM_V_Z_DISPLACE, PARAM_V_ROTATE, PARAM_V_HUE_MODULATION,
+        PARAM_V_HUE_OFFSET, PARAM_V_HUE_LFO,
+        // Mode Flags (Toggles)
+        PARAM_VIDEO_REACTIVE_MODE, PARAM_LFO_AMP_MODE, PARAM_LFO_RATE_MODE,
+        PARAM_COUNT
+    };
+
+    // Index-based access for table-driven controllers (MIDI mapping, presets)
+    int findParameterIndex(const std::string& paramId) const; // -1 if unknown
+    bool isToggleParameter(int paramIndex) const;
+    float getParameterValue(int paramIndex) const; // Base value, toggles as 0/1
+    float getEffectiveParameterValue(int paramIndex) const; // Including modulation and P-Lock
+
+    // Per-frame snapshot from evaluate(): base + P-Lock + modulation matrix.
+    // The render path reads these so every consumer sees the same values within a frame
+    float getEffective(int paramIndex) const { return effectiveValues[paramIndex]; }
+    const float* getEffectiveValues() const { return effectiveValues; }
+    void setParameterValue(int paramIndex, float value, bool recordable = true);
+
 private:
     // Helper Functions
     void initializeParameterMaps(); // Declaration added
 
-    // Enum for P-Lock indices for clarity and safety
-    enum PLockIndex {
-        LUMAKEY_VALUE = 0, MIX = 1, HUE = 2, SATURATION = 3, BRIGHTNESS = 4,
-        TEMPORAL_FILTER_MIX = 5, TEMPORAL_FILTER_RESONANCE = 6, SHARPEN_AMOUNT = 7,
-        X_DISPLACE = 8, Y_DISPLACE = 9, Z_DISPLACE = 10, ROTATE = 11,
-        HUE_MODULATION = 12, HUE_OFFSET = 13, HUE_LFO = 14, DELAY_AMOUNT = 15,
-        UNUSED_16 = 16
-    };
-
     // Parameter Info & Mappings
     std::vector<std::string> parameterIds;
     std::map<std::string, int> midiChannels;
@@ -257,23 +308,64 @@ private:
     std::map<std::string, std::string> oscAddresses;
 
     // P-Lock system constants
-    static inline const int P_LOCK_SIZE = 240;
-    static inline const int P_LOCK_NUMBER = 17;
+    static inline const int P_LOCK_SIZE = 240;   // Original buffer length; delay locks are stored / (P_LOCK_SIZE - 1)
+    static inline const int P_LOCK_NUMBER = 17;  // Lanes in the original <plocks><locks> format
 
     // P-Lock system variables
     bool recordingEnabled = false;
-    int currentStep = 0;
-    float pLockValues[P_LOCK_NUMBER][P_LOCK_SIZE];
-    float pLockSmoothedValues[P_LOCK_NUMBER];
-    float pLockSmoothFactor = 0.5f;
+    PLockSequencer sequencer{PARAM_COUNT}; // One lane per parameter, indexed by ParamId
+    PLockPatternBank patternBank{PARAM_COUNT, PLockSequencer::MAX_STEPS, PLockSequencer::DEFAULT_LENGTH};
+    std::string patternFile = "plocks.bin";
+    int currentPattern = 0;
+    double patternStartPosition = 0.0; // Sequencer position where the current pattern (chain link) began
+    bool importXmlLocks = false;       // New bank file: take over locks from an older settings.xml once
+    void bindPattern(int index);
+
+    // Batched evaluation: effective = (base + modOffset + lock * addGain) * (1 + lock * mulGain) * modScale.
+    // Arrays are padded to a multiple of 8 and aligned so evaluate() runs in whole SIMD blocks
+    static constexpr int EVAL_COUNT = (PARAM_COUNT + 7) & ~7;
+    alignas(32) float evalBase[EVAL_COUNT] = {};
+    alignas(32) float evalModOffset[EVAL_COUNT] = {};
+    alignas(32) float evalModScale[EVAL_COUNT] = {};
+    alignas(32) float evalLock[EVAL_COUNT] = {};
+    alignas(32) float evalAddGain[EVAL_COUNT] = {};
+    alignas(32) float evalMulGain[EVAL_COUNT] = {};
+    alignas(32) float effectiveValues[EVAL_COUNT] = {};
+    void initializeEvaluationGains();
+    float getBaseDelayAmount() const; // delayAmount, or the tempo-synced length
+
+    // Read / write the <plocks> settings; lanes in XML are only imported into a new bank
+    void loadPLocksFromXml(ofxXmlSettings& xml);
+    void savePLocksToXml(ofxXmlSettings& xml) const;
+
+    // Presets (persisted in presets.bin) and the morph in progress
+    PresetBank presets{PARAM_COUNT};
+    std::string presetFile = "presets.bin";
+    int currentPreset = -1;
+    float presetMorphTime = 0.0f; // Seconds, 0 = instant recall
+    bool morphActive = false;
+    float morphElapsed = 0.0f;
+    float morphDuration = 0.0f;
+    float morphFrom[PARAM_COUNT] = {};
+    float morphTo[PARAM_COUNT] = {};
+    void updatePresetMorph();
+    void applyPresetValues(const float* values, bool toggles); // Toggles or continuous parameters, never recorded
+
+    // Modulation sources and routes, one destination per parameter
+    ModulationMatrix modulation{PARAM_COUNT};
+    void initializeModulationRoutes(); // LFOs 1-4 onto displacement, zoom and rotate
+
+    // Transport and sync options
+    Transport transport;
+    bool lfoSyncEnabled = false;
+    bool pLockSyncEnabled = false;
+    int pLockSyncBars = 4;         // P-Lock loop length when synced (4/4 bars)
+    float delaySyncBeats = 0.0f;   // Delay length in beats, 0 = use delayAmount
+    float delayTimeMs = 0.0f;      // Delay length in milliseconds, 0 = use delayAmount
 
     // Record parameter value to P-Lock helper
     void recordParameter(int paramIndex, float value);
 
-    // XML settings
-    ofxXmlSettings XML;
-    std::string settingsFile = "settings.xml";
-
     // Video device settings
     std::string videoDevicePath = "/dev/video0";
     int videoDeviceID = 0;
@@ -309,7 +401,7 @@ private:
     float hueModulation = 1.0f;
     float hueOffset = 0.0f; // Base value for hue offset
     float hueLFO = 0.0f;
-    int delayAmount = 0;
+    float delayAmount = 0.0f;
     float zFrequency = 0.03f;
     float xFrequency = 0.015f;
     float yFrequency = 0.02f;
@@ -341,28 +433,6 @@ private:
     float vHueOffset = 0.0f;
     float vHueLFO = 0.0f;
 
-    // --- Audio Reactivity Offset Storage ---
-    // Stores the offset calculated by AudioReactivityManager
-    float audioLumakeyValueOffset = 0.0f;
-    float audioMixOffset = 0.0f;
-    float audioHueOffset = 0.0f;
-    float audioSaturationOffset = 0.0f;
-    float audioBrightnessOffset = 0.0f;
-    float audioTemporalFilterMixOffset = 0.0f;
-    float audioTemporalFilterResonanceOffset = 0.0f;
-    float audioSharpenAmountOffset = 0.0f;
-    float audioXDisplaceOffset = 0.0f;
-    float audioYDisplaceOffset = 0.0f;
-    float audioZDisplaceOffset = 0.0f;
-    float audioRotateOffset = 0.0f;
-    float audioHueModulationOffset = 0.0f;
-    float audioHueOffsetOffset = 0.0f; // Offset for the hueOffset parameter
-    float audioHueLFOOffset = 0.0f;
-    int   audioDelayAmountOffset = 0;
-    float audioZFrequencyOffset = 0.0f;
-    float audioXFrequencyOffset = 0.0f;
-    float audioYFrequencyOffset = 0.0f;
-
     // Mode flags
     bool videoReactiveMode = false;
     bool lfoAmpMode = false;
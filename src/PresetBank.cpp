@@ -0,0 +1,100 @@
+#include "PresetBank.h"
+
+PresetBank::PresetBank(int numValues)
+    : numValues(numValues),
+      values(NUM_PRESETS * numValues, 0.0f),
+      used(NUM_PRESETS, 0) {
+    static_assert(sizeof(FileHeader) == 32, "Preset header must stay 32 bytes");
+}
+
+bool PresetBank::load(const std::string& path) {
+    filePath = path;
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        ofLogNotice("PresetBank") << "No preset file at " << path << ", starting empty";
+        return false;
+    }
+
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "NPPR", 4) != 0 || header.version != FILE_VERSION ||
+        header.numPresets != static_cast<uint32_t>(NUM_PRESETS) ||
+        header.numValues != static_cast<uint32_t>(numValues)) {
+        file.close();
+        setAside(path, "doesn't match this build");
+        return false;
+    }
+
+    std::vector<uint8_t> fileUsed(NUM_PRESETS);
+    std::vector<float> fileValues(NUM_PRESETS * numValues);
+    if (!file.read(reinterpret_cast<char*>(fileUsed.data()), fileUsed.size()) ||
+        !file.read(reinterpret_cast<char*>(fileValues.data()), fileValues.size() * sizeof(float))) {
+        file.close();
+        setAside(path, "is truncated");
+        return false;
+    }
+    used.swap(fileUsed);
+    values.swap(fileValues);
+
+    ofLogNotice("PresetBank") << "Loaded " << std::count(used.begin(), used.end(), 1) << " presets from " << path;
+    return true;
+}
+
+void PresetBank::setAside(const std::string& path, const std::string& reason) {
+    // The next store() rewrites the file, so keep the user's presets for recovery first
+    std::string backup = path + "." + ofGetTimestampString("%Y%m%d-%H%M%S") + ".bak";
+    if (std::rename(path.c_str(), backup.c_str()) != 0) {
+        ofLogError("PresetBank") << path << " " << reason << " and couldn't be moved aside; "
+                                 << "leaving it untouched, presets won't be saved this session";
+        filePath.clear();
+        return;
+    }
+    ofLogError("PresetBank") << path << " " << reason << "; moved to " << backup << ", starting empty";
+}
+
+std::string PresetBank::serialize() const {
+    FileHeader header = {};
+    std::memcpy(header.magic, "NPPR", 4);
+    header.version = FILE_VERSION;
+    header.numPresets = NUM_PRESETS;
+    header.numValues = numValues;
+
+    // Header, slot flags, then every slot's values
+    std::string data;
+    data.reserve(sizeof(header) + used.size() + values.size() * sizeof(float));
+    data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    data.append(reinterpret_cast<const char*>(used.data()), used.size());
+    data.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+    return data;
+}
+
+bool PresetBank::takeDirty() {
+    bool wasDirty = dirty;
+    dirty = false;
+    return wasDirty && !filePath.empty();
+}
+
+bool PresetBank::isUsed(int slot) const {
+    return isValidSlot(slot) && used[slot] != 0;
+}
+
+const float* PresetBank::get(int slot) const {
+    return isUsed(slot) ? values.data() + slot * numValues : nullptr;
+}
+
+void PresetBank::store(int slot, const float* source) {
+    if (!isValidSlot(slot)) {
+        return;
+    }
+    std::memcpy(values.data() + slot * numValues, source, numValues * sizeof(float));
+    used[slot] = 1;
+    dirty = true;
+}
+
+void PresetBank::clear(int slot) {
+    if (!isValidSlot(slot)) {
+        return;
+    }
+    used[slot] = 0;
+    dirty = true;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ofMain.h"
+
+/**
+ * @class PresetBank
+ * @brief Fixed slots of full parameter snapshots, kept in one binary file
+ *
+ * Each slot is a packed float array indexed by ParameterManager::ParamId, so
+ * storing and recalling are plain copies. The file is read once at startup;
+ * after a store the bank is marked dirty and serialize() provides the bytes
+ * to write, which the app hands to its background writer.
+ */
+class PresetBank {
+public:
+    static const int NUM_PRESETS = 32;
+
+    explicit PresetBank(int numValues);
+
+    bool load(const std::string& path); // Whole file in one read; a missing or incompatible file leaves the bank empty
+                                        // (an incompatible one is renamed to <path>.<time>.bak first)
+    std::string serialize() const;
+    const std::string& getPath() const { return filePath; }
+
+    // True once after each change, for the app's background save; never when there's no file to write
+    bool takeDirty();
+
+    int getNumValues() const { return numValues; }
+    bool isUsed(int slot) const;
+    const float* get(int slot) const; // numValues floats, nullptr if the slot is empty
+    void store(int slot, const float* values);
+    void clear(int slot);
+
+private:
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t numPresets;
+        uint32_t numValues;
+        uint32_t reserved[4]; // Pad to 32 bytes
+    };
+
+    static const uint32_t FILE_VERSION = 1;
+
+    bool isValidSlot(int slot) const { return slot >= 0 && slot < NUM_PRESETS; }
+    void setAside(const std::string& path, const std::string& reason); // Clears filePath if the rename fails
+
+    int numValues;
+    std::vector<float> values;  // NUM_PRESETS * numValues
+    std::vector<uint8_t> used;  // Per slot
+    std::string filePath;
+    bool dirty = false;
+};
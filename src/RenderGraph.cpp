@@ -0,0 +1,304 @@
+#include "RenderGraph.h"
+#include <climits>
+
+RenderGraph::RenderGraph(RenderTargetPool* pool)
+    : pool(pool) {
+}
+
+void RenderGraph::beginFrame() {
+    resources.clear();
+    passes.clear();
+}
+
+RenderGraph::Resource RenderGraph::importTarget(const std::string& name, const std::shared_ptr<ofFbo>& fbo,
+                                                const ofFboSettings& settings) {
+    for (size_t i = 0; i < resources.size(); i++) {
+        if (resources[i].imported && resources[i].fbo == fbo) {
+            return (Resource)i;
+        }
+    }
+    ResourceEntry entry;
+    entry.name = name;
+    entry.settings = settings;
+    entry.imported = true;
+    entry.fbo = fbo;
+    resources.push_back(entry);
+    return (Resource)resources.size() - 1;
+}
+
+RenderGraph::Resource RenderGraph::createTarget(const std::string& name, const ofFboSettings& settings) {
+    ResourceEntry entry;
+    entry.name = name;
+    entry.settings = settings;
+    resources.push_back(entry);
+    return (Resource)resources.size() - 1;
+}
+
+int RenderGraph::addPass(const std::string& name, const std::vector<Resource>& reads, Resource write, std::function<void()> run) {
+    Pass pass;
+    pass.name = name;
+    for (Resource resource : reads) {
+        if (resource != NONE) {
+            pass.reads.push_back(resource);
+        }
+    }
+    pass.write = write;
+    pass.run = std::move(run);
+    passes.push_back(pass);
+    if (write != NONE) {
+        resources[write].writer = (int)passes.size() - 1;
+    }
+    return (int)passes.size() - 1;
+}
+
+int RenderGraph::addCopyPass(const std::string& name, Resource from, Resource to) {
+    int index = addPass(name, {from}, to, [this, from, to] {
+        ofFbo& target = getTarget(to);
+        target.begin();
+        ofClear(0, 0, 0, 255);
+        getTarget(from).draw(0, 0);
+        target.end();
+    });
+    passes[index].copyFrom = from;
+    return index;
+}
+
+void RenderGraph::setNeutral(int pass, Resource source) {
+    passes[pass].neutralSource = source;
+}
+
+void RenderGraph::retain(Resource resource) {
+    resources[resource].retained = true;
+}
+
+void RenderGraph::execute() {
+    // Neutral passes first: they decide what the copies and readers actually see
+    for (Pass& pass : passes) {
+        if (pass.neutralSource != NONE && pass.write != NONE) {
+            pass.state = PASS_NEUTRAL;
+            resources[pass.write].alias = pass.neutralSource;
+        }
+    }
+    elideCopies();
+    cullUnused();
+    allocateTransients();
+
+    timings.clear();
+    for (Pass& pass : passes) {
+        PassTiming timing;
+        timing.name = pass.name;
+        timing.state = pass.state;
+        if (pass.state == PASS_RAN) {
+            uint64_t start = ofGetElapsedTimeMicros();
+            pass.run();
+            if (finishPasses) {
+                glFinish();
+            }
+            timing.ms = (ofGetElapsedTimeMicros() - start) / 1000.0f;
+        }
+        timings.push_back(timing);
+    }
+    releaseTransients();
+}
+
+ofFbo& RenderGraph::getTarget(Resource resource) {
+    Resource physical = resolve(resource);
+    if (physical == NONE || !resources[physical].fbo) {
+        static ofFbo missing; // Drawing into or from it does nothing
+        ofLogError("RenderGraph") << "No target for " << (resource != NONE ? resources[resource].name : "NONE");
+        return missing;
+    }
+    return *resources[physical].fbo;
+}
+
+std::shared_ptr<ofFbo> RenderGraph::getRetained(Resource resource) const {
+    Resource physical = resolve(resource);
+    return physical != NONE ? resources[physical].fbo : nullptr;
+}
+
+void RenderGraph::releaseRetained() {
+    for (auto& fbo : retainedTargets) {
+        if (pool) pool->release(fbo);
+    }
+    retainedTargets.clear();
+}
+
+float RenderGraph::getTotalMs() const {
+    float total = 0.0f;
+    for (const PassTiming& timing : timings) {
+        total += timing.ms;
+    }
+    return total;
+}
+
+std::string RenderGraph::getPassStateName(PassState state) {
+    switch (state) {
+        case PASS_NEUTRAL: return "neutral";
+        case PASS_ELIDED: return "elided";
+        case PASS_UNUSED: return "unused";
+        default: return "ran";
+    }
+}
+
+RenderGraph::Resource RenderGraph::resolve(Resource resource) const {
+    while (resource != NONE && resources[resource].alias != NONE) {
+        resource = resources[resource].alias;
+    }
+    return resource;
+}
+
+bool RenderGraph::isCompatible(const ofFboSettings& a, const ofFboSettings& b) {
+    return a.width == b.width && a.height == b.height && a.internalformat == b.internalformat &&
+           a.numColorbuffers == b.numColorbuffers && a.numSamples == b.numSamples &&
+           a.useDepth == b.useDepth && a.useStencil == b.useStencil;
+}
+
+bool RenderGraph::readsBetween(Resource target, int first, int last) const {
+    for (int i = std::max(first, 0); i <= last && i < (int)passes.size(); i++) {
+        if (passes[i].state != PASS_RAN) {
+            continue;
+        }
+        for (Resource read : passes[i].reads) {
+            if (resolve(read) == target) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void RenderGraph::elideCopies() {
+    for (int i = 0; i < (int)passes.size(); i++) {
+        Pass& copy = passes[i];
+        if (copy.copyFrom == NONE || copy.state != PASS_RAN) {
+            continue;
+        }
+        Resource from = resolve(copy.copyFrom);
+        Resource to = resolve(copy.write);
+        if (from == NONE || to == NONE || from == to) {
+            continue;
+        }
+        const ResourceEntry& source = resources[from];
+        const ResourceEntry& destination = resources[to];
+        if (source.imported || source.writer < 0 || !destination.imported ||
+            !isCompatible(source.settings, destination.settings)) {
+            continue;
+        }
+        // Rendering into the destination early is only safe if nothing from the producer
+        // up to the copy still reads its old contents, and nothing else writes it
+        bool otherWriter = false;
+        for (int j = 0; j < (int)passes.size(); j++) {
+            otherWriter = otherWriter || (j != i && passes[j].state == PASS_RAN && resolve(passes[j].write) == to);
+        }
+        if (otherWriter || readsBetween(to, source.writer, i - 1)) {
+            continue;
+        }
+        resources[from].alias = to;
+        copy.state = PASS_ELIDED;
+    }
+}
+
+void RenderGraph::cullUnused() {
+    std::vector<bool> needed(resources.size(), false);
+    for (size_t i = 0; i < resources.size(); i++) {
+        if (resources[i].imported || resources[i].retained) {
+            Resource physical = resolve((Resource)i);
+            needed[physical] = true;
+        }
+    }
+    for (int i = (int)passes.size() - 1; i >= 0; i--) {
+        Pass& pass = passes[i];
+        if (pass.state != PASS_RAN) {
+            continue;
+        }
+        Resource written = resolve(pass.write);
+        if (written == NONE || !needed[written]) {
+            pass.state = PASS_UNUSED;
+            continue;
+        }
+        for (Resource read : pass.reads) {
+            needed[resolve(read)] = true;
+        }
+    }
+}
+
+void RenderGraph::allocateTransients() {
+    // Lifetime of each transient, from the first running pass that touches it to the last
+    std::vector<int> firstUse(resources.size(), INT_MAX);
+    std::vector<int> lastUse(resources.size(), -1);
+    for (int i = 0; i < (int)passes.size(); i++) {
+        if (passes[i].state != PASS_RAN) {
+            continue;
+        }
+        std::vector<Resource> touched = passes[i].reads;
+        touched.push_back(passes[i].write);
+        for (Resource resource : touched) {
+            Resource physical = resolve(resource);
+            if (physical != NONE && !resources[physical].imported) {
+                firstUse[physical] = std::min(firstUse[physical], i);
+                lastUse[physical] = std::max(lastUse[physical], i);
+            }
+        }
+    }
+    for (size_t i = 0; i < resources.size(); i++) {
+        if (resources[i].retained) {
+            lastUse[resolve((Resource)i)] = INT_MAX;
+        }
+    }
+
+    std::vector<Resource> order;
+    for (size_t i = 0; i < resources.size(); i++) {
+        if (!resources[i].imported && resources[i].alias == NONE && lastUse[i] >= 0) {
+            order.push_back((Resource)i);
+        }
+    }
+    std::sort(order.begin(), order.end(), [&](Resource a, Resource b) { return firstUse[a] < firstUse[b]; });
+
+    // Greedy: a target whose last use is before this one's first use is free to take over
+    physicalTargets.clear();
+    transientBytes = 0;
+    for (Resource resource : order) {
+        ResourceEntry& entry = resources[resource];
+        PhysicalTarget* target = nullptr;
+        for (PhysicalTarget& candidate : physicalTargets) {
+            if (candidate.lastUse < firstUse[resource] && isCompatible(candidate.settings, entry.settings)) {
+                target = &candidate;
+                break;
+            }
+        }
+        if (!target) {
+            PhysicalTarget fresh;
+            fresh.settings = entry.settings;
+            if (pool) {
+                fresh.fbo = pool->acquireFbo(entry.settings);
+            } else {
+                fresh.fbo = std::make_shared<ofFbo>();
+                fresh.fbo->allocate(entry.settings);
+            }
+            transientBytes += MemoryTracker::getFboBytes(entry.settings);
+            physicalTargets.push_back(fresh);
+            target = &physicalTargets.back();
+        }
+        target->lastUse = lastUse[resource];
+        target->retained = target->retained || lastUse[resource] == INT_MAX;
+        entry.fbo = target->fbo;
+    }
+}
+
+void RenderGraph::releaseTransients() {
+    // Last frame's retained targets were read this frame (e.g. as the previous output); now they can go
+    releaseRetained();
+    for (PhysicalTarget& target : physicalTargets) {
+        if (target.retained) {
+            retainedTargets.push_back(target.fbo);
+        } else if (pool) {
+            pool->release(target.fbo);
+        }
+    }
+    for (ResourceEntry& entry : resources) {
+        bool kept = std::find(retainedTargets.begin(), retainedTargets.end(), entry.fbo) != retainedTargets.end();
+        if (!entry.imported && !kept) {
+            entry.fbo.reset(); // Only the pool holds it now
+        }
+    }
+}
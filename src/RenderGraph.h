@@ -0,0 +1,112 @@
+#pragma once
+
+#include "ofMain.h"
+#include "RenderTargetPool.h"
+
+/**
+ * @class RenderGraph
+ * @brief Per-frame render passes with culling and aliasing of transient targets
+ *
+ * Passes are declared every frame with the targets they read and the one
+ * they write; execute() then works out what has to run:
+ *  - a pass marked neutral for this frame's parameters is skipped, and
+ *    whatever reads its output reads its source instead;
+ *  - a copy into an imported target is elided when the pass producing the
+ *    source can render into the destination directly without a hazard;
+ *  - a pass whose output nothing reads is dropped.
+ *
+ * Transient targets come from the RenderTargetPool and share one physical
+ * FBO when their settings match and their lifetimes don't overlap. Passes
+ * must overwrite every pixel of a transient they write. Imported targets
+ * (history slots) belong to the caller; writing one always counts as used.
+ *
+ * Render thread only.
+ */
+class RenderGraph {
+public:
+    typedef int Resource;
+    static const Resource NONE = -1;
+
+    enum PassState {
+        PASS_RAN = 0,
+        PASS_NEUTRAL, // Wouldn't change its source this frame
+        PASS_ELIDED,  // Copy folded into the pass that produced the source
+        PASS_UNUSED   // Nothing reads what it writes
+    };
+
+    struct PassTiming {
+        std::string name;
+        PassState state = PASS_RAN;
+        float ms = 0.0f; // Submission time; includes the GPU work with setFinishPasses(true)
+    };
+
+    explicit RenderGraph(RenderTargetPool* pool = nullptr);
+    void setRenderTargetPool(RenderTargetPool* pool) { this->pool = pool; }
+
+    // Building a frame
+    void beginFrame(); // Forget last frame's passes; its retained targets live until execute() ends
+    Resource importTarget(const std::string& name, const std::shared_ptr<ofFbo>& fbo, const ofFboSettings& settings); // Same FBO, same resource
+    Resource createTarget(const std::string& name, const ofFboSettings& settings);
+    int addPass(const std::string& name, const std::vector<Resource>& reads, Resource write, std::function<void()> run);
+    int addCopyPass(const std::string& name, Resource from, Resource to);
+    void setNeutral(int pass, Resource source); // Skip the pass; readers of its output read source
+    void retain(Resource resource);             // Keep the target until the next execute() ends
+    void execute();
+
+    ofFbo& getTarget(Resource resource); // In a pass: the physical target after aliasing
+    std::shared_ptr<ofFbo> getRetained(Resource resource) const; // After execute()
+    void releaseRetained(); // Back to the pool, e.g. before the targets are reallocated
+
+    const std::vector<PassTiming>& getTimings() const { return timings; } // Last execute(), in declaration order
+    float getTotalMs() const;
+    size_t getTransientBytes() const { return transientBytes; } // Physical transient targets last frame
+    int getTransientTargetCount() const { return (int)physicalTargets.size(); }
+    void setFinishPasses(bool finish) { finishPasses = finish; } // glFinish after each pass, for profiling
+    bool isFinishingPasses() const { return finishPasses; }
+    static std::string getPassStateName(PassState state);
+
+private:
+    struct ResourceEntry {
+        std::string name;
+        ofFboSettings settings;
+        bool imported = false;
+        bool retained = false;
+        Resource alias = NONE;      // Set by a neutral pass or an elided copy: this resource is that one
+        int writer = -1;            // Pass index
+        std::shared_ptr<ofFbo> fbo; // Imported, or the physical target once allocated
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<Resource> reads;
+        Resource write = NONE;
+        Resource copyFrom = NONE; // Copy passes only
+        Resource neutralSource = NONE;
+        std::function<void()> run;
+        PassState state = PASS_RAN;
+    };
+
+    struct PhysicalTarget {
+        std::shared_ptr<ofFbo> fbo;
+        ofFboSettings settings;
+        int lastUse = -1; // Pass index; INT_MAX when retained
+        bool retained = false;
+    };
+
+    Resource resolve(Resource resource) const;
+    static bool isCompatible(const ofFboSettings& a, const ofFboSettings& b);
+    bool readsBetween(Resource target, int first, int last) const; // A running pass in [first, last] reads target
+    void elideCopies();
+    void cullUnused();
+    void allocateTransients();
+    void releaseTransients(); // After the passes ran; retained ones replace last frame's
+
+    RenderTargetPool* pool;
+    std::vector<ResourceEntry> resources;
+    std::vector<Pass> passes;
+    std::vector<PhysicalTarget> physicalTargets;
+    std::vector<std::shared_ptr<ofFbo>> retainedTargets; // From the pool, held for one more frame
+    std::vector<PassTiming> timings;
+    size_t transientBytes = 0;
+    bool finishPasses = false;
+};
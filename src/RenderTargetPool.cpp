@@ -0,0 +1,191 @@
+#include "RenderTargetPool.h"
+
+RenderTargetPool::RenderTargetPool(MemoryTracker* memory)
+    : memory(memory) {
+#if defined(TARGET_LINUX) && (defined(__arm__) || defined(__aarch64__))
+    maxIdleBytes = 16 * 1024 * 1024; // Pi GPU memory is shared and small
+#else
+    maxIdleBytes = 64 * 1024 * 1024;
+#endif
+}
+
+bool RenderTargetPool::Key::operator==(const Key& other) const {
+    return texture == other.texture && width == other.width && height == other.height &&
+           internalFormat == other.internalFormat && numColorbuffers == other.numColorbuffers &&
+           numSamples == other.numSamples && depth == other.depth && stencil == other.stencil;
+}
+
+RenderTargetPool::Key RenderTargetPool::makeKey(const ofFboSettings& settings) {
+    return Key{false, settings.width, settings.height, settings.internalformat, settings.numColorbuffers,
+               settings.numSamples, settings.useDepth, settings.useStencil};
+}
+
+std::shared_ptr<ofFbo> RenderTargetPool::acquireFbo(const ofFboSettings& settings) {
+    Key key = makeKey(settings);
+    std::shared_ptr<ofFbo> fbo;
+
+    int index = takeIdle(key);
+    if (index >= 0) {
+        fbo = idle[index].fbo;
+        stats.idleBytes -= idle[index].bytes;
+        idle.erase(idle.begin() + index);
+        stats.idle = (int)idle.size();
+        stats.hits++;
+        updateTracker();
+    } else {
+        stats.misses++;
+        makeRoom(MemoryTracker::getFboBytes(settings));
+        fbo = std::make_shared<ofFbo>();
+        fbo->allocate(settings);
+    }
+    liveKeys[fbo.get()] = key;
+    stats.live = (int)liveKeys.size();
+    return fbo;
+}
+
+std::shared_ptr<ofTexture> RenderTargetPool::acquireTexture(int width, int height, int internalFormat) {
+    Key key{true, width, height, internalFormat, 1, 0, false, false};
+    std::shared_ptr<ofTexture> texture;
+
+    int index = takeIdle(key);
+    if (index >= 0) {
+        texture = idle[index].texture;
+        stats.idleBytes -= idle[index].bytes;
+        idle.erase(idle.begin() + index);
+        stats.idle = (int)idle.size();
+        stats.hits++;
+        updateTracker();
+    } else {
+        stats.misses++;
+        makeRoom(MemoryTracker::getTextureBytes(width, height, internalFormat));
+        texture = std::make_shared<ofTexture>();
+        texture->allocate(width, height, internalFormat);
+    }
+    liveKeys[texture.get()] = key;
+    stats.live = (int)liveKeys.size();
+    return texture;
+}
+
+void RenderTargetPool::release(std::shared_ptr<ofFbo>& fbo) {
+    if (!fbo) {
+        return;
+    }
+    Key key;
+    // Only targets this pool handed out, with their acquire key, can be reused
+    if (takeLiveKey(fbo.get(), key) && fbo->isAllocated()) {
+        addIdle(IdleTarget{key, fbo, nullptr, 0});
+    }
+    fbo.reset();
+}
+
+void RenderTargetPool::release(std::shared_ptr<ofTexture>& texture) {
+    if (!texture) {
+        return;
+    }
+    Key key;
+    // A texture reallocated by its owner (e.g. to a new NDI sender size) no longer matches its key
+    if (takeLiveKey(texture.get(), key) && texture->isAllocated() &&
+        (int)texture->getWidth() == key.width && (int)texture->getHeight() == key.height) {
+        addIdle(IdleTarget{key, nullptr, texture, 0});
+    }
+    texture.reset();
+}
+
+void RenderTargetPool::setMaxIdleBytes(size_t bytes) {
+    maxIdleBytes = bytes;
+    trim(maxIdleBytes);
+    updateTracker();
+}
+
+void RenderTargetPool::trim(size_t keepBytes) {
+    while (!idle.empty() && stats.idleBytes > keepBytes) {
+        evict(0);
+    }
+}
+
+float RenderTargetPool::getHitRate() const {
+    uint64_t requests = stats.hits + stats.misses;
+    return requests > 0 ? (float)stats.hits / requests : 0.0f;
+}
+
+void RenderTargetPool::logStats() const {
+    ofLogNotice("RenderTargetPool") << "Render targets: " << stats.hits << " hits, " << stats.misses << " misses ("
+                                    << ofToString(getHitRate() * 100.0f, 0) << "%), " << stats.live << " live, "
+                                    << stats.idle << " idle (" << MemoryTracker::toMegabytes(stats.idleBytes) << " MB), "
+                                    << stats.evictions << " evicted";
+}
+
+void RenderTargetPool::loadFromXml(ofxXmlSettings& xml) {
+    setMaxIdleBytes((size_t)(xml.getValue("renderPool:maxIdleMB", (double)MemoryTracker::toMegabytes(maxIdleBytes)) * 1024 * 1024));
+}
+
+void RenderTargetPool::saveToXml(ofxXmlSettings& xml) const {
+    xml.setValue("renderPool:maxIdleMB", MemoryTracker::toMegabytes(maxIdleBytes));
+}
+
+bool RenderTargetPool::takeLiveKey(const void* target, Key& key) {
+    auto it = liveKeys.find(target);
+    if (it == liveKeys.end()) {
+        return false;
+    }
+    key = it->second;
+    liveKeys.erase(it);
+    stats.live = (int)liveKeys.size();
+    stats.releases++;
+    return true;
+}
+
+void RenderTargetPool::addIdle(IdleTarget target) {
+    if (target.key.texture) {
+        target.bytes = MemoryTracker::getTextureBytes(target.key.width, target.key.height, target.key.internalFormat);
+    } else {
+        ofFboSettings settings;
+        settings.width = target.key.width;
+        settings.height = target.key.height;
+        settings.internalformat = target.key.internalFormat;
+        settings.numColorbuffers = target.key.numColorbuffers;
+        settings.numSamples = target.key.numSamples;
+        settings.useDepth = target.key.depth;
+        settings.useStencil = target.key.stencil;
+        target.bytes = MemoryTracker::getFboBytes(settings);
+    }
+    stats.idleBytes += target.bytes;
+    idle.push_back(std::move(target));
+    stats.idle = (int)idle.size();
+    trim(maxIdleBytes);
+    updateTracker();
+}
+
+int RenderTargetPool::takeIdle(const Key& key) {
+    // Newest first: it's the most likely to be the one just released for this purpose
+    for (int i = (int)idle.size() - 1; i >= 0; i--) {
+        if (idle[i].key == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void RenderTargetPool::makeRoom(size_t bytes) {
+    if (!memory) {
+        return;
+    }
+    // Idle targets count against the budget, so they go before a new allocation is refused
+    while (!idle.empty() && memory->getAvailable(MemoryTracker::GPU) < bytes) {
+        evict(0);
+        updateTracker();
+    }
+}
+
+void RenderTargetPool::evict(int index) {
+    stats.idleBytes -= idle[index].bytes;
+    idle.erase(idle.begin() + index); // Last reference, so the GL objects are freed here
+    stats.idle = (int)idle.size();
+    stats.evictions++;
+}
+
+void RenderTargetPool::updateTracker() {
+    if (memory) {
+        memory->track("pool.idle", "pool", MemoryTracker::GPU, stats.idleBytes);
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxXmlSettings.h"
+#include "MemoryTracker.h"
+
+/**
+ * @class RenderTargetPool
+ * @brief Reuses FBOs and textures across resizes and buffer-length changes
+ *
+ * Owners acquire render targets by size and format and release them when
+ * they are done instead of destroying them. Released targets stay allocated
+ * on an idle list and satisfy the next request with the same key, so a
+ * resize back and forth or a change of the delay-buffer length doesn't free
+ * and reallocate GPU memory. Idle memory is capped, oldest first, and is
+ * also given back when the MemoryTracker budget needs the room.
+ *
+ * Render thread only.
+ */
+class RenderTargetPool {
+public:
+    struct Stats {
+        uint64_t hits = 0;      // Requests served from the idle list
+        uint64_t misses = 0;    // Requests that allocated
+        uint64_t releases = 0;
+        uint64_t evictions = 0; // Idle targets freed by the cap or the memory budget
+        int live = 0;           // Acquired and not yet released
+        int idle = 0;
+        size_t idleBytes = 0;
+    };
+
+    explicit RenderTargetPool(MemoryTracker* memory = nullptr);
+
+    std::shared_ptr<ofFbo> acquireFbo(const ofFboSettings& settings);
+    std::shared_ptr<ofTexture> acquireTexture(int width, int height, int internalFormat);
+
+    // Back to the idle list; the pointer is reset. Targets not from this pool are just dropped
+    void release(std::shared_ptr<ofFbo>& fbo);
+    void release(std::shared_ptr<ofTexture>& texture);
+
+    void setMaxIdleBytes(size_t bytes);
+    size_t getMaxIdleBytes() const { return maxIdleBytes; }
+    void trim(size_t keepBytes); // Free idle targets, oldest first, until at most keepBytes remain
+
+    const Stats& getStats() const { return stats; }
+    float getHitRate() const; // 0..1
+    void logStats() const;
+
+    // <renderPool> settings
+    void loadFromXml(ofxXmlSettings& xml);
+    void saveToXml(ofxXmlSettings& xml) const;
+
+private:
+    struct Key {
+        bool texture = false;
+        int width = 0;
+        int height = 0;
+        int internalFormat = 0;
+        int numColorbuffers = 1;
+        int numSamples = 0;
+        bool depth = false;
+        bool stencil = false;
+        bool operator==(const Key& other) const;
+    };
+
+    struct IdleTarget {
+        Key key;
+        std::shared_ptr<ofFbo> fbo;
+        std::shared_ptr<ofTexture> texture;
+        size_t bytes;
+    };
+
+    static Key makeKey(const ofFboSettings& settings);
+    bool takeLiveKey(const void* target, Key& key); // False if the pool didn't hand it out
+    void addIdle(IdleTarget target);
+    int takeIdle(const Key& key); // Index into idle, -1 if none matches
+    void makeRoom(size_t bytes);  // Evict idle targets the memory budget needs
+    void evict(int index);
+    void updateTracker();
+
+    MemoryTracker* memory;
+    std::vector<IdleTarget> idle; // Oldest first
+    std::map<const void*, Key> liveKeys; // Acquired targets and the key they were acquired with
+    Stats stats;
+    size_t maxIdleBytes;
+};
@@ -0,0 +1,184 @@
+#include "SettingsStore.h"
+#include <cstdio>
+
+SettingsStore::SettingsStore(const std::string& path)
+    : path(path) {
+}
+
+SettingsStore::~SettingsStore() {
+    stop();
+}
+
+void SettingsStore::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    thread = std::thread(&SettingsStore::threadLoop, this);
+}
+
+void SettingsStore::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false; // The worker writes anything still pending before it exits
+    }
+    condition.notify_all();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+bool SettingsStore::load() {
+    std::lock_guard<std::mutex> documentLock(documentMutex);
+    document.clear();
+    if (!ofFile::doesFileExist(path, false)) {
+        return false;
+    }
+    if (!document.loadFile(path)) {
+        ofLogWarning("SettingsStore") << "Could not parse " << path;
+        return false;
+    }
+    ofLogNotice("SettingsStore") << "Loaded " << path;
+    return true;
+}
+
+void SettingsStore::requestSave() {
+    uint64_t now = ofGetElapsedTimeMillis();
+    if (!savePending) {
+        firstRequestMillis = now;
+        savePending = true;
+    }
+    lastRequestMillis = now;
+}
+
+void SettingsStore::update() {
+    if (!savePending) {
+        return;
+    }
+    uint64_t now = ofGetElapsedTimeMillis();
+    if (now - lastRequestMillis >= DEBOUNCE_MILLIS || now - firstRequestMillis >= MAX_DELAY_MILLIS) {
+        gather(false); // Retried next frame if the previous save is still being serialized
+    }
+}
+
+void SettingsStore::saveNow() {
+    gather(true);
+
+    if (!running) {
+        // No worker (not started or already stopped): serialize and write on this thread
+        serialize();
+        std::map<std::string, std::string> writes;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            writes.swap(pendingWrites);
+        }
+        for (const auto& write : writes) {
+            writeFile(write.first, write.second);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return pendingWrites.empty() && !serializePending && !writing; });
+}
+
+void SettingsStore::writeAsync(const std::string& filePath, std::string data) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingWrites[filePath] = std::move(data); // Replaces an older version not yet written
+    }
+    condition.notify_all();
+}
+
+bool SettingsStore::gather(bool wait) {
+    std::unique_lock<std::mutex> documentLock(documentMutex, std::defer_lock);
+    if (wait) {
+        documentLock.lock();
+    } else if (!documentLock.try_lock()) {
+        return false;
+    }
+
+    savePending = false;
+    if (writer) {
+        writer(document);
+    }
+    documentLock.unlock();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        serializePending = true;
+    }
+    condition.notify_all();
+    return true;
+}
+
+void SettingsStore::serialize() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!serializePending) {
+            return;
+        }
+        serializePending = false;
+    }
+
+    std::string text;
+    {
+        std::lock_guard<std::mutex> documentLock(documentMutex);
+        document.copyXmlToString(text);
+    }
+    writeAsync(path, std::move(text));
+}
+
+void SettingsStore::threadLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        condition.wait(lock, [this] { return !pendingWrites.empty() || serializePending || !running; });
+        if (pendingWrites.empty() && !serializePending) {
+            break; // Stopped with nothing left to write
+        }
+
+        writing = true;
+        lock.unlock();
+        serialize(); // Unlocked first: the writer takes documentMutex, then mutex
+        lock.lock();
+
+        std::map<std::string, std::string> writes;
+        writes.swap(pendingWrites);
+        lock.unlock();
+
+        for (const auto& write : writes) {
+            writeFile(write.first, write.second);
+        }
+
+        lock.lock();
+        writing = false;
+        condition.notify_all();
+    }
+}
+
+bool SettingsStore::writeFile(const std::string& filePath, const std::string& text) const {
+    // Write beside the target, then rename over it so readers see the old or the new file, never half of one
+    std::string tempPath = filePath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        file << text;
+        file.flush();
+        if (!file) {
+            ofLogError("SettingsStore") << "Failed to write " << tempPath;
+            return false;
+        }
+    }
+#ifdef TARGET_WIN32
+    std::remove(filePath.c_str()); // rename() doesn't replace an existing file on Windows
+#endif
+    if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        ofLogError("SettingsStore") << "Failed to replace " << filePath;
+        return false;
+    }
+    saveCount++;
+    ofLogNotice("SettingsStore") << "Saved " << filePath;
+    return true;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxXmlSettings.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class SettingsStore
+ * @brief settings.xml parsed once and saved in the background
+ *
+ * The file is parsed into one in-memory document at startup and every
+ * manager reads its section from that document. Saving is requested rather
+ * than performed: requests are debounced, the writer callback copies plain
+ * values into the document on the render thread when one is due, and a
+ * worker thread serializes it, writes the text to a temporary file and
+ * renames it over settings.xml, so a crash mid-save never leaves a
+ * truncated file.
+ */
+class SettingsStore {
+public:
+    using Writer = std::function<void(ofxXmlSettings& xml)>;
+
+    explicit SettingsStore(const std::string& path);
+    ~SettingsStore();
+
+    void start();
+    void stop(); // Waits for a pending write to finish
+
+    // Parse the file into the document; false if missing or unreadable
+    bool load();
+    ofxXmlSettings& getDocument() { return document; }
+
+    // Called on the render thread to copy manager state into the document
+    void setWriter(Writer writer) { this->writer = std::move(writer); }
+
+    void requestSave();   // Debounced; returns immediately
+    void update();        // Render thread, once per frame: starts a due save
+    void saveNow();       // Gather and write immediately, blocking until the file is on disk
+
+    // Other data files (presets) written atomically on the same worker
+    void writeAsync(const std::string& filePath, std::string data);
+
+    bool isSavePending() const { return savePending; }
+    uint64_t getSaveCount() const { return saveCount; }
+
+private:
+    static const uint64_t DEBOUNCE_MILLIS = 500;   // Quiet time before a save starts
+    static const uint64_t MAX_DELAY_MILLIS = 5000; // Upper bound while requests keep coming
+
+    bool gather(bool wait); // Render thread: writer -> document; false if the worker still has it
+    void serialize();       // Document -> text -> pendingWrites
+    void threadLoop();
+    bool writeFile(const std::string& filePath, const std::string& text) const;
+
+    std::string path;
+    ofxXmlSettings document;
+    std::mutex documentMutex; // Held by the writer and while the worker serializes
+    Writer writer;
+
+    // Debounce state, render thread only
+    bool savePending = false;
+    uint64_t firstRequestMillis = 0;
+    uint64_t lastRequestMillis = 0;
+
+    // Hand-off to the worker
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::map<std::string, std::string> pendingWrites; // Path -> contents, latest wins
+    bool serializePending = false; // Document gathered, text not made yet
+    bool writing = false;
+    bool running = false;
+    mutable std::atomic<uint64_t> saveCount{0}; // Completed writes, bumped by the worker
+};
@@ -22,6 +22,18 @@ ofShader& ShaderManager::getSharpenShader() {
     return sharpenShader;
 }
 
+ofShader& ShaderManager::getCompositeShader() {
+    return compositeShader;
+}
+
+ofShader& ShaderManager::getCheckerboardShader() {
+    return checkerboardShader;
+}
+
+ofShader& ShaderManager::getUpscaleShader() {
+    return upscaleShader;
+}
+
 bool ShaderManager::loadShadersForCurrentRenderer() {
     std::string shaderDir = getShaderDirectory();
     
@@ -33,8 +45,14 @@ bool ShaderManager::loadShadersForCurrentRenderer() {
     // Load the shader pairs
     bool mixerLoaded = loadShaderPair(mixerShader, "shader_mixer");
     bool sharpenLoaded = loadShaderPair(sharpenShader, "shaderSharpen");
+    // Optional: split resolution falls back to drawing the loop output scaled up
+    loadShaderPair(compositeShader, "shaderComposite");
+    // Optional: without it the checkerboard tier shades every pixel
+    loadShaderPair(checkerboardShader, "shaderCheckerboard");
+    // Optional: without it the output is stretched to the window bilinearly
+    loadShaderPair(upscaleShader, "shaderUpscale");
     
-    // Success only if both shaders loaded
+    // Success only if both required shaders loaded
     return mixerLoaded && sharpenLoaded;
 }
 
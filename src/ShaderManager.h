@@ -19,6 +19,9 @@ public:
     // Shader access
     ofShader& getMixerShader();
     ofShader& getSharpenShader();
+    ofShader& getCompositeShader();
+    ofShader& getCheckerboardShader();
+    ofShader& getUpscaleShader();
     
     // Load shaders for different GL versions
     bool loadShadersForCurrentRenderer();
@@ -42,6 +45,9 @@ private:
     // Shaders
     ofShader mixerShader;      // Main effect mixer shader
     ofShader sharpenShader;    // Image sharpening shader
+    ofShader compositeShader;  // Full-resolution input over the split-resolution feedback loop
+    ofShader checkerboardShader; // Fills in the half of the mixer output not shaded this frame
+    ofShader upscaleShader;    // Sharp upscaling of the output to the window
     
     // Helper methods
     bool loadShaderPair(ofShader& shader, const std::string& name);
@@ -0,0 +1,216 @@
+#include "StartupGraph.h"
+
+StartupGraph::~StartupGraph() {
+    stop();
+}
+
+void StartupGraph::add(const std::string& name, Thread thread, Task task, const std::vector<std::string>& dependencies) {
+    addChecked(name, thread, [task] { task(); return true; }, dependencies);
+}
+
+void StartupGraph::addChecked(const std::string& name, Thread thread, CheckedTask task, const std::vector<std::string>& dependencies) {
+    Node node;
+    node.name = name;
+    node.thread = thread;
+    node.task = std::move(task);
+    for (const auto& dependency : dependencies) {
+        int index = findNode(dependency);
+        if (index < 0) {
+            ofLogWarning("StartupGraph") << name << " depends on unknown task " << dependency;
+            continue;
+        }
+        node.dependencies.push_back(index);
+    }
+    nodes.push_back(std::move(node));
+    remaining++;
+}
+
+void StartupGraph::runNow(const std::string& name, Task task) {
+    Node node;
+    node.name = name;
+    node.thread = RENDER;
+    node.startMicros = ofGetElapsedTimeMicros();
+    task();
+    node.endMicros = ofGetElapsedTimeMicros();
+    node.state = DONE;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    nodes.push_back(std::move(node));
+}
+
+void StartupGraph::start() {
+    int workerTasks = 0;
+    for (const auto& node : nodes) {
+        if (node.thread == WORKER && node.state == WAITING) {
+            workerTasks++;
+        }
+    }
+    // Tasks mostly wait on devices, not the CPU, so one thread each up to a small cap
+    int threads = std::min(workerTasks, 4);
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(&StartupGraph::workerLoop, this);
+    }
+}
+
+void StartupGraph::update() {
+    if (firstFrameMicros == 0) {
+        // Leave the first frame alone so something is on screen before any render task runs
+        firstFrameMicros = ofGetElapsedTimeMicros();
+        return;
+    }
+
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        index = takeReadyLocked(RENDER);
+    }
+    if (index >= 0) {
+        run(index);
+    }
+
+    if (!timelineLogged && isFinished()) {
+        timelineLogged = true;
+        logTimeline();
+    }
+}
+
+void StartupGraph::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+}
+
+bool StartupGraph::isDone(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    int index = findNode(name);
+    return index < 0 || nodes[index].state == DONE;
+}
+
+bool StartupGraph::isSettled(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    int index = findNode(name);
+    return index < 0 || nodes[index].state == DONE || nodes[index].state == FAILED;
+}
+
+bool StartupGraph::isFinished() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return remaining == 0;
+}
+
+void StartupGraph::logTimeline() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t readyMicros = 0;
+    ofLogNotice("StartupGraph") << "Startup timeline (ms since launch):";
+    for (const auto& node : nodes) {
+        if (node.state == FAILED && node.startMicros == 0) {
+            ofLogNotice("StartupGraph") << "  " << ofToString(node.name, 16, ' ') << "skipped, a dependency failed";
+            continue;
+        }
+        if (node.state != DONE && node.state != FAILED) {
+            ofLogNotice("StartupGraph") << "  " << node.name << " not run";
+            continue;
+        }
+        readyMicros = std::max(readyMicros, node.endMicros);
+        const char* where = node.thread == WORKER ? "worker" : "render";
+        ofLogNotice("StartupGraph") << "  " << ofToString(node.name, 16, ' ')
+                                    << ofToString(node.startMicros / 1000.0, 1, 8, ' ') << " -"
+                                    << ofToString(node.endMicros / 1000.0, 1, 8, ' ') << "  "
+                                    << where << (node.state == FAILED ? "  FAILED" : "");
+    }
+    if (firstFrameMicros > 0) {
+        ofLogNotice("StartupGraph") << "  First frame at " << ofToString(firstFrameMicros / 1000.0, 1) << " ms";
+    }
+    ofLogNotice("StartupGraph") << "  All inputs ready at " << ofToString(readyMicros / 1000.0, 1) << " ms";
+}
+
+int StartupGraph::findNode(const std::string& name) const {
+    for (int i = 0; i < (int)nodes.size(); i++) {
+        if (nodes[i].name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int StartupGraph::takeReadyLocked(Thread thread) {
+    for (int i = 0; i < (int)nodes.size(); i++) {
+        Node& node = nodes[i];
+        if (node.state != WAITING || node.thread != thread) {
+            continue;
+        }
+        bool ready = std::all_of(node.dependencies.begin(), node.dependencies.end(),
+                                 [this](int dependency) { return nodes[dependency].state == DONE; });
+        if (ready) {
+            node.state = RUNNING;
+            node.startMicros = ofGetElapsedTimeMicros();
+            return i;
+        }
+    }
+    return -1;
+}
+
+void StartupGraph::run(int index) {
+    // The task list is fixed once started, so the node can be read without the lock
+    Node& node = nodes[index];
+    bool succeeded = false;
+    try {
+        succeeded = node.task();
+        if (!succeeded) {
+            ofLogError("StartupGraph") << node.name << " failed";
+        }
+    } catch (const std::exception& e) {
+        ofLogError("StartupGraph") << node.name << " failed: " << e.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        node.endMicros = ofGetElapsedTimeMicros();
+        node.state = succeeded ? DONE : FAILED;
+        remaining--;
+        if (!succeeded) {
+            skipDependentsLocked(index);
+        }
+    }
+    condition.notify_all();
+}
+
+void StartupGraph::skipDependentsLocked(int failed) {
+    // Dependencies are always added first, so one pass forward reaches every indirect dependent
+    for (int i = failed + 1; i < (int)nodes.size(); i++) {
+        Node& node = nodes[i];
+        bool blocked = std::any_of(node.dependencies.begin(), node.dependencies.end(),
+                                   [this](int dependency) { return nodes[dependency].state == FAILED; });
+        if (node.state == WAITING && blocked) {
+            node.state = FAILED;
+            remaining--;
+            ofLogWarning("StartupGraph") << node.name << " skipped, a dependency failed";
+        }
+    }
+}
+
+void StartupGraph::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        int index = takeReadyLocked(WORKER);
+        if (index >= 0) {
+            lock.unlock();
+            run(index);
+            lock.lock();
+            continue;
+        }
+        bool workerTasksLeft = std::any_of(nodes.begin(), nodes.end(),
+                                           [](const Node& node) { return node.thread == WORKER && node.state == WAITING; });
+        if (!workerTasksLeft) {
+            break;
+        }
+        condition.wait(lock); // Woken when any task finishes, including render tasks
+    }
+}
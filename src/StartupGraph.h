@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ofMain.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @class StartupGraph
+ * @brief Startup work as named tasks with dependencies, run concurrently
+ *
+ * Worker tasks (device probing, NDI discovery, opening streams) run on a
+ * small thread pool as soon as their dependencies finish. Render tasks
+ * touch GL and run on the render thread from update(), one per frame, so
+ * the first frames are presented while the rest of startup continues.
+ * Every task's start and end are recorded and logged as one timeline when
+ * the graph completes.
+ */
+class StartupGraph {
+public:
+    enum Thread { WORKER, RENDER };
+    using Task = std::function<void()>;
+    using CheckedTask = std::function<bool()>; // False when the task failed
+
+    StartupGraph() = default;
+    ~StartupGraph();
+
+    // Declare tasks before start(); dependencies must already be added. A task fails by
+    // throwing or, for addChecked(), by returning false; its dependents are then skipped
+    void add(const std::string& name, Thread thread, Task task, const std::vector<std::string>& dependencies = {});
+    void addChecked(const std::string& name, Thread thread, CheckedTask task, const std::vector<std::string>& dependencies = {});
+
+    // Run a step on the calling thread now, recorded in the timeline
+    void runNow(const std::string& name, Task task);
+
+    void start();  // Launches the worker pool
+    void update(); // Render thread, once per frame: runs one ready render task
+    void stop();   // Waits for running workers; tasks not yet started are dropped
+
+    bool isDone(const std::string& name) const;    // Ran and succeeded; unknown names count as done
+    bool isSettled(const std::string& name) const; // Done, failed or skipped; unknown names count as settled
+    bool isFinished() const;
+    void logTimeline() const;
+
+private:
+    enum State { WAITING, RUNNING, DONE, FAILED }; // FAILED with no start time = skipped
+
+    struct Node {
+        std::string name;
+        Thread thread;
+        CheckedTask task;
+        std::vector<int> dependencies;
+        State state = WAITING;
+        uint64_t startMicros = 0; // ofGetElapsedTimeMicros(), i.e. since launch
+        uint64_t endMicros = 0;
+    };
+
+    int findNode(const std::string& name) const;
+    int takeReadyLocked(Thread thread); // -1 if none
+    void run(int index);
+    void skipDependentsLocked(int failed); // Dependents of a failed task, and theirs
+    void workerLoop();
+
+    std::vector<Node> nodes;
+    std::vector<std::thread> workers;
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    int remaining = 0;
+    bool stopping = false;
+    bool timelineLogged = false;
+    uint64_t firstFrameMicros = 0;
+};
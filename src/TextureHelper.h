@@ -79,4 +79,96 @@ public:
             return shaderSource;
         }
     }
+
+    /**
+     * Best floating-point colour format the driver claims it can render to
+     *
+     * Desktop GL 3 has both half-float formats in core; legacy GL 2 needs
+     * ARB_texture_float. GLES needs ES 3 with EXT_color_buffer_half_float,
+     * or EXT_color_buffer_float for the packed format. ES 2 always falls
+     * back to 8-bit.
+     *
+     * @param preferPacked Prefer GL_R11F_G11F_B10F (4 bytes, no alpha) over GL_RGBA16F (8 bytes)
+     * @return The internal format, or GL_RGBA8 without float render targets
+     */
+    static GLint getHdrInternalFormat(bool preferPacked) {
+        #if defined(GL_RGBA16F) && defined(GL_R11F_G11F_B10F)
+            #ifdef TARGET_OPENGLES
+                bool es3 = isGLES3();
+                bool fullFloat = es3 && ofGLCheckExtension("GL_EXT_color_buffer_float");
+                if (preferPacked && fullFloat) return GL_R11F_G11F_B10F;
+                if (fullFloat || (es3 && ofGLCheckExtension("GL_EXT_color_buffer_half_float"))) return GL_RGBA16F;
+            #else
+                if (preferPacked && ofIsGLProgrammableRenderer()) return GL_R11F_G11F_B10F;
+                if (ofIsGLProgrammableRenderer() || ofGLCheckExtension("GL_ARB_texture_float")) return GL_RGBA16F;
+            #endif
+        #endif
+        return GL_RGBA8;
+    }
+
+    /**
+     * Whether mipmaps can be generated for the pipeline's non-power-of-two
+     * textures; GLES 2 only allows that with OES_texture_npot
+     */
+    static bool canMipmapNpot() {
+        #ifdef TARGET_OPENGLES
+            return isGLES3() || ofGLCheckExtension("GL_OES_texture_npot");
+        #else
+            return ofIsGLProgrammableRenderer() || ofGLCheckExtension("GL_ARB_texture_non_power_of_two");
+        #endif
+    }
+
+    /**
+     * Whether the mixer shaders in use can choose a mip level themselves:
+     * GL3 has textureLod, the GL2 and ES2 dialects need their texture LOD extension
+     */
+    static bool canSampleLodInFragment() {
+        if (ofIsGLProgrammableRenderer()) {
+            return true;
+        }
+        #ifdef TARGET_OPENGLES
+            return ofGLCheckExtension("GL_EXT_shader_texture_lod");
+        #else
+            return ofGLCheckExtension("GL_ARB_shader_texture_lod");
+        #endif
+    }
+
+    /**
+     * True on an OpenGL ES 3.x context
+     */
+    static bool isGLES3() {
+        #ifdef TARGET_OPENGLES
+            const GLubyte* version = glGetString(GL_VERSION);
+            return version && std::string((const char*)version).find("OpenGL ES 3") != std::string::npos;
+        #else
+            return false;
+        #endif
+    }
+
+    /**
+     * Allocate a tiny FBO to confirm a format is really colour-renderable;
+     * extensions are sometimes advertised without working render targets
+     */
+    static bool canRenderTo(GLint internalFormat) {
+        ofFbo probe;
+        probe.allocate(4, 4, internalFormat);
+        return probe.isAllocated() && probe.checkStatus();
+    }
+
+    /**
+     * Readable name for the formats the pipeline uses
+     */
+    static std::string getFormatName(GLint internalFormat) {
+        switch (internalFormat) {
+            #ifdef GL_RGBA16F
+            case GL_RGBA16F: return "GL_RGBA16F";
+            #endif
+            #ifdef GL_R11F_G11F_B10F
+            case GL_R11F_G11F_B10F: return "GL_R11F_G11F_B10F";
+            #endif
+            case GL_RGB: return "GL_RGB";
+            case GL_RGBA: return "GL_RGBA";
+            default: return internalFormat == GL_RGBA8 ? "GL_RGBA8" : ofToString(internalFormat);
+        }
+    }
 };
@@ -0,0 +1,87 @@
+#include "Transport.h"
+
+void Transport::clock(uint64_t timeMicros) {
+    // A gap past the timeout is the clock pausing, not a tempo
+    if (hasClock && timeMicros > lastClockMicros && timeMicros - lastClockMicros < CLOCK_TIMEOUT_MICROS) {
+        tempo.addInterval(static_cast<double>(timeMicros - lastClockMicros));
+    }
+
+    lastClockMicros = timeMicros;
+    hasClock = true;
+    if (running) {
+        tickCount++;
+    }
+}
+
+void Transport::start() {
+    // The first clock after start is beat 0
+    tickCount = -1;
+    running = true;
+    ofLogNotice("Transport") << "MIDI start";
+}
+
+void Transport::resume() {
+    running = true;
+    ofLogNotice("Transport") << "MIDI continue at beat " << tickCount / static_cast<double>(PPQN);
+}
+
+void Transport::stop() {
+    running = false;
+    ofLogNotice("Transport") << "MIDI stop";
+}
+
+void Transport::setSongPosition(int sixteenths) {
+    // One MIDI beat (sixteenth note) is 6 clocks
+    tickCount = static_cast<int64_t>(sixteenths) * (PPQN / 4) - (running ? 0 : 1);
+}
+
+bool Transport::isRunning() const {
+    return running;
+}
+
+bool Transport::isClockActive(uint64_t nowMicros) const {
+    return hasClock && getMicrosSinceClock(nowMicros) < CLOCK_TIMEOUT_MICROS;
+}
+
+uint64_t Transport::getMicrosSinceClock(uint64_t nowMicros) const {
+    int64_t elapsed = static_cast<int64_t>(nowMicros) - static_cast<int64_t>(lastClockMicros);
+    return static_cast<uint64_t>(std::max<int64_t>(elapsed, 0));
+}
+
+float Transport::getBpm(uint64_t nowMicros) const {
+    if (isClockActive(nowMicros)) {
+        return static_cast<float>(60000000.0 / (tempo.getInterval() * PPQN));
+    }
+    return internalBpm;
+}
+
+double Transport::getBeatPosition(uint64_t nowMicros) const {
+    if (!isClockActive(nowMicros)) {
+        // Free-running internal tempo
+        return nowMicros / 1000000.0 * internalBpm / 60.0;
+    }
+
+    double ticks = static_cast<double>(std::max<int64_t>(tickCount, 0));
+    if (running) {
+        // Interpolate between clocks, never past the next expected tick
+        double fraction = getMicrosSinceClock(nowMicros) / tempo.getInterval();
+        ticks += std::min(fraction, 1.0);
+    }
+    return ticks / PPQN;
+}
+
+float Transport::getSyncedLfoPhase(float rate, uint64_t nowMicros) const {
+    // Quantize rate (0-1, sign = direction) to cycles per beat: off, 4 bars ... 1/16 note
+    static const float CYCLES_PER_BEAT[] = { 0.0f, 0.0625f, 0.125f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f };
+    static const int NUM_DIVISIONS = sizeof(CYCLES_PER_BEAT) / sizeof(CYCLES_PER_BEAT[0]);
+
+    int division = static_cast<int>(ofClamp(std::abs(rate), 0.0f, 1.0f) * (NUM_DIVISIONS - 1) + 0.5f);
+    double cycles = getBeatPosition(nowMicros) * CYCLES_PER_BEAT[division];
+    cycles -= std::floor(cycles); // Keep precision for long sets
+    return static_cast<float>((rate < 0.0f ? -1.0 : 1.0) * cycles * TWO_PI);
+}
+
+int Transport::beatsToFrames(float beats, float frameRate, uint64_t nowMicros) const {
+    float seconds = beats * 60.0f / getBpm(nowMicros);
+    return static_cast<int>(seconds * frameRate + 0.5f);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ClockTempoFilter.h"
+
+/**
+ * @class Transport
+ * @brief Musical time shared by LFOs, P-Lock steps and delay sync
+ *
+ * Follows incoming MIDI clock (24 PPQN), start/stop/continue and song
+ * position. Tempo is estimated from clock timestamps with a one-beat moving
+ * average and outlier rejection (ClockTempoFilter), so USB jitter doesn't wobble synced
+ * modulation. Without an external clock the transport free-runs at an
+ * internal tempo. All methods are called from the render thread.
+ */
+class Transport {
+public:
+    static const int PPQN = 24;
+
+    // MIDI realtime messages, timestamped at arrival
+    void clock(uint64_t timeMicros);
+    void start();
+    void resume(); // MIDI continue
+    void stop();
+    void setSongPosition(int sixteenths);
+
+    // State
+    bool isRunning() const;
+    bool isClockActive(uint64_t nowMicros) const; // External clock seen recently
+    float getBpm(uint64_t nowMicros) const;       // External estimate or internal tempo
+    double getBeatPosition(uint64_t nowMicros) const;
+
+    float getInternalBpm() const { return internalBpm; }
+    void setInternalBpm(float bpm) { internalBpm = ofClamp(bpm, 20.0f, 300.0f); }
+
+    // Helpers for synced consumers
+    float getSyncedLfoPhase(float rate, uint64_t nowMicros) const; // Radians
+    int beatsToFrames(float beats, float frameRate, uint64_t nowMicros) const;
+
+private:
+    static const uint64_t CLOCK_TIMEOUT_MICROS = 1000000; // Fall back to internal tempo after 1 s
+
+    // 0 when the last clock is stamped after nowMicros (read from the queue after now was sampled)
+    uint64_t getMicrosSinceClock(uint64_t nowMicros) const;
+
+    // Jitter filter: moving average over the last beat of clock intervals
+    ClockTempoFilter tempo{60000000.0 / (120.0 * PPQN)};
+
+    uint64_t lastClockMicros = 0;
+    int64_t tickCount = 0;   // Clock ticks since start
+    bool running = false;
+    bool hasClock = false;
+
+    float internalBpm = 120.0f;
+};
@@ -1,5 +1,5 @@
 #include "VideoFeedbackManager.h"
-#include "V4L2Helper.h" 
+#include "V4L2Helper.h"
 #ifdef TARGET_LINUX
 #include <sys/sysinfo.h>
 #endif
@@ -7,24 +7,13 @@
 VideoFeedbackManager::VideoFeedbackManager(ParameterManager* paramManager, ShaderManager* shaderManager)
     : paramManager(paramManager), shaderManager(shaderManager), cameraInitialized(false), currentVideoDeviceIndex(0) { // Initialize members
     frameBufferLength = determineOptimalFrameBufferLength();
-    pastFrames = new ofFbo[frameBufferLength];
-    pastFramesAllocated = new bool[frameBufferLength];
-    for (int i = 0; i < frameBufferLength; i++) {
-        pastFramesAllocated[i] = false;
-    }
-    // List devices early so the list is available for loading settings
-    listVideoDevices(); 
+    pastFrames.resize(frameBufferLength); // Slots are filled lazily from the render target pool
+    frameTimes.assign(frameBufferLength, 0);
+    // Devices are listed by probeCamera() on a startup worker
 }
 
 VideoFeedbackManager::~VideoFeedbackManager() {
-    if (pastFrames) {
-        delete[] pastFrames;
-        pastFrames = nullptr;
-    }
-    if (pastFramesAllocated) {
-        delete[] pastFramesAllocated;
-        pastFramesAllocated = nullptr;
-    }
+    // Render targets are freed with their last reference; the pool may already be gone
     if (cameraInitialized) {
         camera.close();
     }
@@ -33,10 +22,10 @@ VideoFeedbackManager::~VideoFeedbackManager() {
 void VideoFeedbackManager::setup(int width, int height) {
     this->width = width;
     this->height = height;
-    // Load settings first, which might dictate the device to set up
-    // Note: loadFromXml is now called from ofApp after paramManager is loaded
-    // setupCamera will use the device ID potentially loaded from XML via paramManager
-    setupCamera(width, height); 
+    // The camera is opened separately during startup (probeCamera/openCamera/attachCamera)
+    // so device probing doesn't hold up the first frame
+    createFallbackPattern(width, height);
+    renderGraph.setRenderTargetPool(&getRenderTargetPool());
     allocateFbos(width, height);
     for (int i = 0; i < std::min(5, frameBufferLength); i++) {
         allocatePastFrameIfNeeded(i);
@@ -83,33 +72,53 @@ void VideoFeedbackManager::allocateFbos(int width, int height) {
             settings.internalformat = GL_RGBA8; 
         #endif
     }
+    GLint hdrFormat = resolveHdrFormat();
+    if (hdrHistory) {
+        settings.internalformat = hdrFormat; // Before the budget check, which sizes the ring from it
+    }
+    ofFboSettings inputSettings = settings;
+    if (isSplitResolution()) {
+        settings.width = std::max((int)(settings.width * loopScale), 160);
+        settings.height = std::max((int)(settings.height * loopScale), 120);
+    }
+    fitToMemoryBudget(settings, inputSettings, hdrFormat);
+    if (!isSplitResolution()) {
+        inputSettings = settings; // The budget may have scaled everything down
+    }
+    fboWidth = settings.width;
+    fboHeight = settings.height;
     fboSettings = settings;
+    pipelineSettings = settings;
+    pipelineSettings.internalformat = hdrFormat;
+    outputSettings = inputSettings;
+    outputSettings.internalformat = hdrFormat;
 
-    ofLogNotice("VideoFeedbackManager") << "Allocating FBOs with format: "
-                                       << (settings.internalformat == GL_RGBA8 ? "GL_RGBA8" : "GL_RGB"); // Adjust log if GL_RGB is used
+    ofLogNotice("VideoFeedbackManager") << "Allocating FBOs with format: " << TextureHelper::getFormatName(pipelineSettings.internalformat)
+                                       << ", history " << TextureHelper::getFormatName(fboSettings.internalformat);
     
     try {
-        mainFbo.allocate(settings);
-        mainFbo.begin(); ofClear(0, 0, 0, 255); mainFbo.end();
-        aspectRatioFbo.allocate(settings); // Still needed for camera aspect correction
-        aspectRatioFbo.begin(); ofClear(0, 0, 0, 255); aspectRatioFbo.end();
-        dryFrameBuffer.allocate(settings);
-        dryFrameBuffer.begin(); ofClear(0, 0, 0, 255); dryFrameBuffer.end();
-        sharpenFbo.allocate(settings);
-        sharpenFbo.begin(); ofClear(0, 0, 0, 255); sharpenFbo.end();
-        
-        // Re-initialize allocation tracking array if needed
-        if (!pastFramesAllocated) pastFramesAllocated = new bool[frameBufferLength];
-        for (int i = 0; i < frameBufferLength; i++) pastFramesAllocated[i] = false;
-        
-        // Re-allocate pastFrames array if needed
-        if (!pastFrames) pastFrames = new ofFbo[frameBufferLength];
+        // Return the previous targets first so an unchanged size gets the same ones back
+        releaseRenderTargets();
+        frameTimes.assign(frameBufferLength, 0);
+        resetCpuHistory(); // Wrong size now
+        aspectRatioFbo = acquireClearedFbo(inputSettings); // Still needed for camera aspect correction
+        // The mixer, sharpen and composite targets are the render graph's, acquired per frame
+        if (memory) {
+            memory->track("video.aspectRatio", "video", MemoryTracker::GPU, MemoryTracker::getFboBytes(inputSettings));
+            memory->release("video.graph");
+            memory->releasePrefix("video.pastFrame."); // Reallocated lazily at the new size
+        }
         
         int preAllocateCount = std::min(5, frameBufferLength);
         for (int i = 0; i < preAllocateCount; i++) allocatePastFrameIfNeeded(i);
+        restartHistoryWarmup();
         
         ofLogNotice("VideoFeedbackManager") << "FBOs allocated with "
                                            << fboWidth << "x" << fboHeight << " resolution";
+        if (isSplitResolution()) {
+            ofLogNotice("VideoFeedbackManager") << "Split resolution: feedback loop at " << fboWidth << "x" << fboHeight
+                                               << ", output at " << outputSettings.width << "x" << outputSettings.height;
+        }
     } catch (std::exception& e) {
         ofLogError("VideoFeedbackManager") << "Error allocating FBOs: " << e.what();
     }
@@ -119,16 +128,28 @@ void VideoFeedbackManager::allocateFbos(int width, int height) {
 
 // Renamed function to match header declaration
 void VideoFeedbackManager::processMainPipeline(const ofTexture& inputTexture) {
+    if (backend == BACKEND_CPU) {
+        checkerboardActive = false;
+        processCpuPipeline(inputTexture, getDelayTap());
+        return;
+    }
+
     // Pre-allocate frames we'll need for this frame
-    int delayAmount = ofClamp(paramManager->getDelayAmount(), 0, frameBufferLength - 1);
-    int delayIndex = ((frameBufferLength + currentFrameIndex - delayAmount) % frameBufferLength);
+    DelayTap delayTap = getDelayTap();
+    int delayIndex = delayTap.index;
     int temporalIndex = ((frameBufferLength + currentFrameIndex - 1) % frameBufferLength);
     int storeIndex = ((frameBufferLength + currentFrameIndex - 1) % frameBufferLength);
     
     // Ensure needed frames are allocated
     allocatePastFrameIfNeeded(delayIndex);
+    if (delayTap.fraction > 0.0f) allocatePastFrameIfNeeded(delayTap.olderIndex);
     allocatePastFrameIfNeeded(temporalIndex);
     allocatePastFrameIfNeeded(storeIndex);
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        if (echoTaps[i].enabled && frameBufferLength > 0) {
+            allocatePastFrameIfNeeded(getEchoTapSlot(i));
+        }
+    }
     
     // Safety checks before processing
     if (!paramManager || !shaderManager) {
@@ -137,161 +158,304 @@ void VideoFeedbackManager::processMainPipeline(const ofTexture& inputTexture) {
     }
     if (!inputTexture.isAllocated()) {
         ofLogError("VideoFeedbackManager") << "Input texture not allocated! Cannot process pipeline.";
-        if(mainFbo.isAllocated()) { mainFbo.begin(); ofClear(255,0,0,255); mainFbo.end(); }
-        if(sharpenFbo.isAllocated()) { sharpenFbo.begin(); ofClear(255,0,0,255); sharpenFbo.end(); }
+        if(isAllocated(compositeFbo)) { compositeFbo->begin(); ofClear(255,0,0,255); compositeFbo->end(); }
         return;
     }
     
+    // A zoomed-out feedback tap is read through its own mip chain, built before the mixer pass
+    feedbackMipmapActive = needsFeedbackMipmaps(paramManager->getEffectiveValues()) &&
+                           delayIndex >= 0 && delayIndex < frameBufferLength && isAllocated(pastFrames[delayIndex]);
+    if (feedbackMipmapActive && !isAllocated(feedbackMipFbo)) {
+        feedbackMipFbo = acquireClearedFbo(fboSettings);
+        if (memory) {
+            memory->track("video.feedbackMips", "video", MemoryTracker::GPU, MemoryTracker::getFboBytes(fboSettings) * 4 / 3);
+        }
+    }
+
     // Get shader with validation
     ofShader& mixerShader = shaderManager->getMixerShader();
     if (!mixerShader.isLoaded()) {
         ofLogError("VideoFeedbackManager") << "Mixer shader not loaded!";
         return;
     }
+    ofShader& sharpenShader = shaderManager->getSharpenShader();
     
-    // Main processing FBO
-    mainFbo.begin();
-    ofClear(0, 0, 0, 255);
-    mixerShader.begin();
-    
-    // Draw the provided input texture
-    // Use the dimensions of the mainFbo for drawing
-    inputTexture.draw(0, 0, mainFbo.getWidth(), mainFbo.getHeight());
-    
-    // Get parameters
-    float lumakeyValue = paramManager->getLumakeyValue();
-    float mix = paramManager->getMix();
-    float hue = paramManager->getHue();
-    float saturation = paramManager->getSaturation();
-    float brightness = paramManager->getBrightness();
-    float temporalFilterMix = paramManager->getTemporalFilterMix();
-    float temporalFilterResonance = paramManager->getTemporalFilterResonance();
-    float sharpenAmount = paramManager->getSharpenAmount();
-    float xDisplace = paramManager->getXDisplace();
-    float yDisplace = paramManager->getYDisplace();
-    float zDisplace = paramManager->getZDisplace();
-    float zFrequency = paramManager->getZFrequency();
-    float xFrequency = paramManager->getXFrequency();
-    float yFrequency = paramManager->getYFrequency();
-    float rotate = paramManager->getRotate();
-    float hueModulation = paramManager->getHueModulation();
-    float hueOffset = paramManager->getHueOffset();
-    float hueLFO = paramManager->getHueLFO();
-    float xLfoAmp = paramManager->getXLfoAmp();
-    float xLfoRate = paramManager->getXLfoRate();
-    float yLfoAmp = paramManager->getYLfoAmp();
-    float yLfoRate = paramManager->getYLfoRate();
-    float zLfoAmp = paramManager->getZLfoAmp();
-    float zLfoRate = paramManager->getZLfoRate();
-    float rotateLfoAmp = paramManager->getRotateLfoAmp();
-    float rotateLfoRate = paramManager->getRotateLfoRate();
+    // Read back before the passes run: the store overwrites the temporal slot
+    std::unique_ptr<CpuValidation> validation;
+    if (cpuValidationPending) {
+        cpuValidationPending = false;
+        validation = captureCpuValidation(inputTexture, delayTap);
+    }
+
+    // Get parameters from this frame's snapshot (P-Lock, audio and LFOs already applied)
+    const float* params = paramManager->getEffectiveValues();
+    float lumakeyValue = params[ParameterManager::PARAM_LUMAKEY_VALUE];
+    float mix = params[ParameterManager::PARAM_MIX];
+    float hue = params[ParameterManager::PARAM_HUE];
+    float saturation = params[ParameterManager::PARAM_SATURATION];
+    float brightness = params[ParameterManager::PARAM_BRIGHTNESS];
+    float temporalFilterMix = params[ParameterManager::PARAM_TEMPORAL_FILTER_MIX];
+    float temporalFilterResonance = params[ParameterManager::PARAM_TEMPORAL_FILTER_RESONANCE];
+    float sharpenAmount = params[ParameterManager::PARAM_SHARPEN_AMOUNT];
+    float xDisplace = params[ParameterManager::PARAM_X_DISPLACE];
+    float yDisplace = params[ParameterManager::PARAM_Y_DISPLACE];
+    float zDisplace = params[ParameterManager::PARAM_Z_DISPLACE];
+    float zFrequency = params[ParameterManager::PARAM_Z_FREQUENCY];
+    float xFrequency = params[ParameterManager::PARAM_X_FREQUENCY];
+    float yFrequency = params[ParameterManager::PARAM_Y_FREQUENCY];
+    float rotate = params[ParameterManager::PARAM_ROTATE];
+    float hueModulation = params[ParameterManager::PARAM_HUE_MODULATION];
+    float hueOffset = params[ParameterManager::PARAM_HUE_OFFSET];
+    float hueLFO = params[ParameterManager::PARAM_HUE_LFO];
 
     if (frameBufferLength <= 0) delayIndex = 0;
     if (delayIndex < 0 || delayIndex >= frameBufferLength) delayIndex = 0;
+    bool wetMode = paramManager->isWetModeEnabled();
 
-    // Apply LFO modulation
-    xDisplace += 0.01f * xLfoAmp * sin(ofGetElapsedTimef() * xLfoRate);
-    yDisplace += 0.01f * yLfoAmp * sin(ofGetElapsedTimef() * yLfoRate);
-    zDisplace *= (1.0f + 0.05f * zLfoAmp * sin(ofGetElapsedTimef() * zLfoRate));
-    rotate += 0.314159265f * rotateLfoAmp * sin(ofGetElapsedTimef() * rotateLfoRate);
-
-    try {
-        // Send textures
-        if (pastFrames && delayIndex >= 0 && delayIndex < frameBufferLength && pastFrames[delayIndex].isAllocated()) {
-            mixerShader.setUniformTexture("fb", pastFrames[delayIndex].getTexture(), 1);
-        } else {
-             // Maybe bind a black texture or just don't bind if feedback frame isn't ready?
-             // ofLogWarning("VideoFeedbackManager") << "Feedback texture at index " << delayIndex << " not ready.";
+    // Declare this frame's passes; the graph skips what wouldn't change the picture
+    renderGraph.beginFrame();
+    auto importSlot = [this](int index) {
+        return index >= 0 && index < frameBufferLength && isAllocated(pastFrames[index])
+            ? renderGraph.importTarget("history." + ofToString(index), pastFrames[index], fboSettings)
+            : RenderGraph::NONE;
+    };
+    RenderGraph::Resource feedback = importSlot(delayIndex);
+    RenderGraph::Resource older = delayTap.fraction > 0.0f ? importSlot(delayTap.olderIndex) : RenderGraph::NONE;
+    RenderGraph::Resource temporal = wetMode ? importSlot(temporalIndex)
+        : (isAllocated(sharpenFbo) ? renderGraph.importTarget("previousOutput", sharpenFbo, pipelineSettings) : RenderGraph::NONE);
+    std::vector<RenderGraph::Resource> mixerReads = { feedback, older, temporal };
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        if (echoTaps[i].enabled && echoTaps[i].gain != 0.0f) {
+            mixerReads.push_back(importSlot(getEchoTapSlot(i)));
         }
-        int tempIdx = ((frameBufferLength + currentFrameIndex - 1) % frameBufferLength);
-        if (tempIdx >= 0 && tempIdx < frameBufferLength && pastFrames[tempIdx].isAllocated()) {
-            if (paramManager->isWetModeEnabled()) {
-                mixerShader.setUniformTexture("temporalFilter", pastFrames[tempIdx].getTexture(), 2);
+    }
+    if (feedbackMipmapActive) {
+        RenderGraph::Resource mips = renderGraph.importTarget("feedbackMips", feedbackMipFbo, fboSettings);
+        renderGraph.addPass("mipTap", { feedback, older }, mips, [this, delayTap] { prepareMipmappedTap(delayTap); });
+        mixerReads.push_back(mips);
+    }
+    // Split resolution: the input at loop size, for the mixer and for the composite to take back out
+    RenderGraph::Resource loopInput = RenderGraph::NONE;
+    if (isSplitResolution()) {
+        loopInput = renderGraph.createTarget("loopInput", pipelineSettings);
+        renderGraph.addPass("loopInput", {}, loopInput, [&] {
+            ofFbo& target = renderGraph.getTarget(loopInput);
+            target.begin();
+            inputTexture.draw(0, 0, target.getWidth(), target.getHeight());
+            target.end();
+        });
+        mixerReads.push_back(loopInput);
+    }
+    RenderGraph::Resource mixed = renderGraph.createTarget("mixed", pipelineSettings);
+    RenderGraph::Resource output = renderGraph.createTarget("output", pipelineSettings);
+    // Checkerboard tier: the mixer shades half of each row into a half-width target
+    checkerboardActive = mixerQuality == MIXER_CHECKERBOARD && shaderManager->getCheckerboardShader().isLoaded();
+    RenderGraph::Resource mixerTarget = mixed;
+    if (checkerboardActive) {
+        ofFboSettings halfSettings = pipelineSettings;
+        halfSettings.width = (pipelineSettings.width + 1) / 2;
+        mixerTarget = renderGraph.createTarget("mixedHalf", halfSettings);
+        checkerboardPhase = 1.0f - checkerboardPhase;
+    } else {
+        checkerboardHistory.reset();
+    }
+    RenderGraph::Resource store = importSlot(storeIndex);
+
+    const float shadePhase = checkerboardPhase; // Read by both the mixer and the reconstruction, so they agree on it
+
+    renderGraph.addPass("mixer", mixerReads, mixerTarget, [&] {
+        ofFbo& target = renderGraph.getTarget(mixerTarget);
+        target.begin();
+        ofClear(0, 0, 0, 255);
+        mixerShader.begin();
+        // Everything is set before the draw: OF draws immediately, anything set after applies to the next frame
+        mixerShader.setUniform1i("checkerboard", checkerboardActive ? 1 : 0);
+        mixerShader.setUniform1f("checkerboardPhase", shadePhase);
+        mixerShader.setUniform1f("checkerboardWidth", pipelineSettings.width);
+            // Send textures
+            mixerShader.setUniform1i("fbMipmaps", feedbackMipmapActive ? 1 : 0);
+            if (feedbackMipmapActive) {
+                // The fractional blend is already in the copy
+                mixerShader.setUniformTexture("fb", feedbackMipFbo->getTexture(), 1);
+                mixerShader.setUniformTexture("fbOlder", feedbackMipFbo->getTexture(), 3);
+                mixerShader.setUniform1f("fbDelayFraction", 0.0f);
+                setEchoTapUniforms(mixerShader, pastFrames[delayIndex]->getTexture());
+            } else if (delayIndex >= 0 && delayIndex < frameBufferLength && isAllocated(pastFrames[delayIndex])) {
+                mixerShader.setUniformTexture("fb", pastFrames[delayIndex]->getTexture(), 1);
+                // Fractional delay: the mixer blends towards the next older frame, one extra fetch
+                bool olderReady = delayTap.fraction > 0.0f && isAllocated(pastFrames[delayTap.olderIndex]);
+                const ofFbo& older = olderReady ? *pastFrames[delayTap.olderIndex] : *pastFrames[delayIndex];
+                mixerShader.setUniformTexture("fbOlder", older.getTexture(), 3);
+                mixerShader.setUniform1f("fbDelayFraction", olderReady ? delayTap.fraction : 0.0f);
+                setEchoTapUniforms(mixerShader, pastFrames[delayIndex]->getTexture());
             } else {
-                 if(dryFrameBuffer.isAllocated()) {
-                    mixerShader.setUniformTexture("temporalFilter", dryFrameBuffer.getTexture(), 2);
-                 }
+                mixerShader.setUniform1f("fbDelayFraction", 0.0f);
+                mixerShader.setUniform1i("echoTapCount", 0);
+                 // Maybe bind a black texture or just don't bind if feedback frame isn't ready?
+                 // ofLogWarning("VideoFeedbackManager") << "Feedback texture at index " << delayIndex << " not ready.";
+            }
+            int tempIdx = ((frameBufferLength + currentFrameIndex - 1) % frameBufferLength);
+            if (tempIdx >= 0 && tempIdx < frameBufferLength && isAllocated(pastFrames[tempIdx])) {
+                if (paramManager->isWetModeEnabled()) {
+                    mixerShader.setUniformTexture("temporalFilter", pastFrames[tempIdx]->getTexture(), 2);
+                } else {
+                     // Dry mode: last frame's output, still held by the render graph
+                     if(isAllocated(sharpenFbo)) {
+                        mixerShader.setUniformTexture("temporalFilter", sharpenFbo->getTexture(), 2);
+                     }
+                }
+            } else {
+                // ofLogWarning("VideoFeedbackManager") << "Temporal filter texture at index " << tempIdx << " not ready.";
             }
-        } else {
-            // ofLogWarning("VideoFeedbackManager") << "Temporal filter texture at index " << tempIdx << " not ready.";
-        }
-
-        // Send uniforms
-        mixerShader.setUniform1f("lumakey", lumakeyValue);
-        mixerShader.setUniform1f("fbMix", mix);
-        mixerShader.setUniform1f("fbHue", hue);
-        mixerShader.setUniform1f("fbSaturation", saturation);
-        mixerShader.setUniform1f("fbBright", brightness);
-        mixerShader.setUniform1f("temporalFilterMix", temporalFilterMix);
-        mixerShader.setUniform1f("temporalFilterResonance", temporalFilterResonance);
-        mixerShader.setUniform1f("fbXDisplace", xDisplace);
-        mixerShader.setUniform1f("fbYDisplace", yDisplace);
-        mixerShader.setUniform1f("fbZDisplace", zDisplace);
-        mixerShader.setUniform1f("fbZFrequency", zFrequency);
-        mixerShader.setUniform1f("fbXFrequency", xFrequency);
-        mixerShader.setUniform1f("fbYFrequency", yFrequency);
-        mixerShader.setUniform1f("fbRotate", rotate);
-        mixerShader.setUniform1f("fbHuexMod", hueModulation);
-        mixerShader.setUniform1f("fbHuexOff", hueOffset);
-        mixerShader.setUniform1f("fbHuexLfo", hueLFO);
-        mixerShader.setUniform1i("toroidSwitch", paramManager->isToroidEnabled() ? 1 : 0);
-        mixerShader.setUniform1i("mirrorSwitch", paramManager->isMirrorModeEnabled() ? 1 : 0);
-        mixerShader.setUniform1i("brightInvert", paramManager->isBrightnessInverted() ? 1 : 0);
-        mixerShader.setUniform1i("hueInvert", paramManager->isHueInverted() ? 1 : 0);
-        mixerShader.setUniform1i("saturationInvert", paramManager->isSaturationInverted() ? 1 : 0);
-        mixerShader.setUniform1i("horizontalMirror", paramManager->isHorizontalMirrorEnabled() ? 1 : 0);
-        mixerShader.setUniform1i("verticalMirror", paramManager->isVerticalMirrorEnabled() ? 1 : 0);
-        mixerShader.setUniform1i("lumakeyInvertSwitch", paramManager->isLumakeyInverted() ? 1 : 0);
-        mixerShader.setUniform1f("vLumakey", paramManager->getVLumakeyValue());
-        mixerShader.setUniform1f("vMix", paramManager->getVMix());
-        mixerShader.setUniform1f("vHue", paramManager->getVHue());
-        mixerShader.setUniform1f("vSat", paramManager->getVSaturation());
-        mixerShader.setUniform1f("vBright", paramManager->getVBrightness());
-        mixerShader.setUniform1f("vtemporalFilterMix", paramManager->getVTemporalFilterMix());
-        mixerShader.setUniform1f("vFb1X", paramManager->getVTemporalFilterResonance()); // Mismatch? vFb1X vs vTemporalFilterResonance
-        mixerShader.setUniform1f("vX", paramManager->getVXDisplace());
-        mixerShader.setUniform1f("vY", paramManager->getVYDisplace());
-        mixerShader.setUniform1f("vZ", paramManager->getVZDisplace());
-        mixerShader.setUniform1f("vRotate", paramManager->getVRotate());
-        mixerShader.setUniform1f("vHuexMod", paramManager->getVHueModulation());
-        mixerShader.setUniform1f("vHuexOff", paramManager->getVHueOffset());
-        mixerShader.setUniform1f("vHuexLfo", paramManager->getVHueLFO());
 
-        mixerShader.end();
-        mainFbo.end();
-        
-        // Sharpen processing
-        sharpenFbo.begin();
-        ofShader& sharpenShader = shaderManager->getSharpenShader();
-        if (!sharpenShader.isLoaded()) {
-            ofLogError("VideoFeedbackManager") << "Sharpen shader not loaded!";
-            ofSetColor(255); mainFbo.draw(0, 0); sharpenFbo.end(); return;
+            // Send uniforms
+            mixerShader.setUniform1f("lumakey", lumakeyValue);
+            mixerShader.setUniform1f("fbMix", mix);
+            mixerShader.setUniform1f("fbHue", hue);
+            mixerShader.setUniform1f("fbSaturation", saturation);
+            mixerShader.setUniform1f("fbBright", brightness);
+            mixerShader.setUniform1f("temporalFilterMix", temporalFilterMix);
+            mixerShader.setUniform1f("temporalFilterResonance", temporalFilterResonance);
+            mixerShader.setUniform1f("fbXDisplace", xDisplace);
+            mixerShader.setUniform1f("fbYDisplace", yDisplace);
+            mixerShader.setUniform1f("fbZDisplace", zDisplace);
+            mixerShader.setUniform1f("fbZFrequency", zFrequency);
+            mixerShader.setUniform1f("fbXFrequency", xFrequency);
+            mixerShader.setUniform1f("fbYFrequency", yFrequency);
+            mixerShader.setUniform1f("fbRotate", rotate);
+            mixerShader.setUniform1f("fbHuexMod", hueModulation);
+            mixerShader.setUniform1f("fbHuexOff", hueOffset);
+            mixerShader.setUniform1f("fbHuexLfo", hueLFO);
+            mixerShader.setUniform1i("toroidSwitch", paramManager->isToroidEnabled() ? 1 : 0);
+            mixerShader.setUniform1i("mirrorSwitch", paramManager->isMirrorModeEnabled() ? 1 : 0);
+            mixerShader.setUniform1i("brightInvert", paramManager->isBrightnessInverted() ? 1 : 0);
+            mixerShader.setUniform1i("hueInvert", paramManager->isHueInverted() ? 1 : 0);
+            mixerShader.setUniform1i("saturationInvert", paramManager->isSaturationInverted() ? 1 : 0);
+            mixerShader.setUniform1i("horizontalMirror", paramManager->isHorizontalMirrorEnabled() ? 1 : 0);
+            mixerShader.setUniform1i("verticalMirror", paramManager->isVerticalMirrorEnabled() ? 1 : 0);
+            mixerShader.setUniform1i("lumakeyInvertSwitch", paramManager->isLumakeyInverted() ? 1 : 0);
+            mixerShader.setUniform1f("vLumakey", params[ParameterManager::PARAM_V_LUMAKEY_VALUE]);
+            mixerShader.setUniform1f("vMix", params[ParameterManager::PARAM_V_MIX]);
+            mixerShader.setUniform1f("vHue", params[ParameterManager::PARAM_V_HUE]);
+            mixerShader.setUniform1f("vSat", params[ParameterManager::PARAM_V_SATURATION]);
+            mixerShader.setUniform1f("vBright", params[ParameterManager::PARAM_V_BRIGHTNESS]);
+            mixerShader.setUniform1f("vtemporalFilterMix", params[ParameterManager::PARAM_V_TEMPORAL_FILTER_MIX]);
+            mixerShader.setUniform1f("vFb1X", params[ParameterManager::PARAM_V_TEMPORAL_FILTER_RESONANCE]); // Mismatch? vFb1X vs vTemporalFilterResonance
+            mixerShader.setUniform1f("vX", params[ParameterManager::PARAM_V_X_DISPLACE]);
+            mixerShader.setUniform1f("vY", params[ParameterManager::PARAM_V_Y_DISPLACE]);
+            mixerShader.setUniform1f("vZ", params[ParameterManager::PARAM_V_Z_DISPLACE]);
+            mixerShader.setUniform1f("vRotate", params[ParameterManager::PARAM_V_ROTATE]);
+            mixerShader.setUniform1f("vHuexMod", params[ParameterManager::PARAM_V_HUE_MODULATION]);
+            mixerShader.setUniform1f("vHuexOff", params[ParameterManager::PARAM_V_HUE_OFFSET]);
+            mixerShader.setUniform1f("vHuexLfo", params[ParameterManager::PARAM_V_HUE_LFO]);
+        // Draw last, with every texture and uniform of this frame bound; the input is tex0
+        if (loopInput != RenderGraph::NONE) {
+            renderGraph.getTarget(loopInput).draw(0, 0, target.getWidth(), target.getHeight());
+        } else {
+            inputTexture.draw(0, 0, target.getWidth(), target.getHeight());
         }
+        mixerShader.end();
+        target.end();
+    });
+
+    if (checkerboardActive) {
+        // The other half of the pixels from last frame's result, or from their neighbours at first
+        bool hasPrevious = isAllocated(checkerboardHistory);
+        RenderGraph::Resource previous = hasPrevious
+            ? renderGraph.importTarget("previousMixed", checkerboardHistory, pipelineSettings) : RenderGraph::NONE;
+        renderGraph.addPass("checkerboard", { mixerTarget, previous }, mixed, [&, hasPrevious, previous] {
+            ofFbo& target = renderGraph.getTarget(mixed);
+            ofShader& checkerboardShader = shaderManager->getCheckerboardShader();
+            target.begin();
+            checkerboardShader.begin();
+            if (hasPrevious) {
+                checkerboardShader.setUniformTexture("previousMixed", renderGraph.getTarget(previous).getTexture(), 1);
+            }
+            checkerboardShader.setUniform1i("hasPrevious", hasPrevious ? 1 : 0);
+            checkerboardShader.setUniform1f("checkerboardPhase", shadePhase);
+            checkerboardShader.setUniform2f("fullSize", target.getWidth(), target.getHeight());
+            renderGraph.getTarget(mixerTarget).draw(0, 0, target.getWidth(), target.getHeight());
+            checkerboardShader.end();
+            target.end();
+        });
+        renderGraph.retain(mixed);
+    }
+
+    int sharpenPass = renderGraph.addPass("sharpen", { mixed }, output, [&] {
+        ofFbo& target = renderGraph.getTarget(output);
+        target.begin();
         sharpenShader.begin();
-        mainFbo.draw(0, 0);
         sharpenShader.setUniform1f("sharpenAmount", sharpenAmount);
-        sharpenShader.setUniform1f("vSharpenAmount", paramManager->getVSharpenAmount());
+        sharpenShader.setUniform1f("vSharpenAmount", params[ParameterManager::PARAM_V_SHARPEN_AMOUNT]);
+        renderGraph.getTarget(mixed).draw(0, 0);
         sharpenShader.end();
-        sharpenFbo.end();
-        
-        // Store frame in circular buffer
-        int storeIdx = ((frameBufferLength + currentFrameIndex - 1) % frameBufferLength);
-         if (storeIdx >= 0 && storeIdx < frameBufferLength && pastFrames && pastFrames[storeIdx].isAllocated()) {
-            pastFrames[storeIdx].begin();
-            if (!paramManager->isWetModeEnabled()) {
-                 // In dry mode, store the *input* texture directly (before processing)
-                 if(inputTexture.isAllocated()) { inputTexture.draw(0, 0, pastFrames[storeIdx].getWidth(), pastFrames[storeIdx].getHeight()); } 
-                 else { ofClear(0,0,0,255); }
-                // Update the dry frame buffer for temporal filtering (store processed frame here)
-                if(dryFrameBuffer.isAllocated()) {
-                    dryFrameBuffer.begin(); sharpenFbo.draw(0, 0); dryFrameBuffer.end();
-                }
-            } else {
-                // In wet mode, store the processed output (from sharpenFbo)
-                if(sharpenFbo.isAllocated()) { sharpenFbo.draw(0, 0); } 
-                else { ofClear(0,0,0,255); }
-            }
-            pastFrames[storeIdx].end();
+        target.end();
+    });
+    if (!sharpenShader.isLoaded()) {
+        ofLogError("VideoFeedbackManager") << "Sharpen shader not loaded!";
+        renderGraph.setNeutral(sharpenPass, mixed);
+    } else if (sharpenAmount == 0.0f && params[ParameterManager::PARAM_V_SHARPEN_AMOUNT] == 0.0f) {
+        renderGraph.setNeutral(sharpenPass, mixed); // Nothing subtracted, no boost: only an HSB round trip
+    }
+
+    // Store frame in circular buffer
+    if (store != RenderGraph::NONE) {
+        if (wetMode) {
+            // Elided when sharpen can render straight into the slot
+            renderGraph.addCopyPass("store", output, store);
+        } else {
+            // In dry mode, store the *input* texture directly (before processing)
+            renderGraph.addPass("store", {}, store, [&] {
+                ofFbo& slot = renderGraph.getTarget(store);
+                slot.begin();
+                inputTexture.draw(0, 0, slot.getWidth(), slot.getHeight());
+                slot.end();
+            });
+        }
+    }
+    renderGraph.retain(output); // For draw(), and the next frame's temporal filter in dry mode
+
+    // Split resolution: the full-size input goes back in where the mixer kept it
+    RenderGraph::Resource composite = RenderGraph::NONE;
+    if (isSplitResolution()) {
+        ofShader& compositeShader = shaderManager->getCompositeShader();
+        composite = renderGraph.createTarget("composite", outputSettings);
+        int compositePass = renderGraph.addPass("composite", { output, loopInput }, composite, [&] {
+            ofFbo& target = renderGraph.getTarget(composite);
+            target.begin();
+            compositeShader.begin();
+            compositeShader.setUniformTexture("loopOutput", renderGraph.getTarget(output).getTexture(), 1);
+            compositeShader.setUniformTexture("loopInput", renderGraph.getTarget(loopInput).getTexture(), 2);
+            compositeShader.setUniform1f("fbMix", mix);
+            compositeShader.setUniform1f("vMix", params[ParameterManager::PARAM_V_MIX]);
+            compositeShader.setUniform1f("lumakey", lumakeyValue);
+            compositeShader.setUniform1f("vLumakey", params[ParameterManager::PARAM_V_LUMAKEY_VALUE]);
+            compositeShader.setUniform1i("lumakeyInvertSwitch", paramManager->isLumakeyInverted() ? 1 : 0);
+            compositeShader.setUniform1f("temporalFilterMix", temporalFilterMix);
+            compositeShader.setUniform1f("vtemporalFilterMix", params[ParameterManager::PARAM_V_TEMPORAL_FILTER_MIX]);
+            inputTexture.draw(0, 0, target.getWidth(), target.getHeight());
+            compositeShader.end();
+            target.end();
+        });
+        if (!compositeShader.isLoaded()) {
+            renderGraph.setNeutral(compositePass, output); // Drawn scaled up instead
+        }
+        renderGraph.retain(composite);
+    }
+
+    try {
+        renderGraph.execute();
+        sharpenFbo = renderGraph.getRetained(output);
+        compositeFbo = composite != RenderGraph::NONE ? renderGraph.getRetained(composite) : sharpenFbo;
+        checkerboardHistory = checkerboardActive ? renderGraph.getRetained(mixed) : nullptr;
+        if (store != RenderGraph::NONE) {
+            frameTimes[storeIndex] = ofGetElapsedTimeMicros();
+        }
+        if (memory) {
+            memory->track("video.graph", "video", MemoryTracker::GPU, renderGraph.getTransientBytes());
+        }
+        if (validation) {
+            finishCpuValidation(*validation, delayTap);
         }
     }
     catch (const std::exception& e) {
@@ -300,27 +464,747 @@ void VideoFeedbackManager::processMainPipeline(const ofTexture& inputTexture) {
     catch (...) {
         ofLogError("VideoFeedbackManager") << "Unknown exception in processMainPipeline";
     }
-    // } // End of frameSkip check (optional)
 }
 
-
 void VideoFeedbackManager::draw() {
-    if (sharpenFbo.isAllocated()) {
-        sharpenFbo.draw(0, 0, ofGetWidth(), ofGetHeight());
-    } else {
+    upscaleActive = false;
+    if (backend == BACKEND_CPU && cpuOutputTexture.isAllocated()) {
+        present(cpuOutputTexture);
+    } else if (isAllocated(compositeFbo)) {
+        present(compositeFbo->getTexture());
+    } else if (pipelineSettings.width == 0) { // Otherwise just nothing processed since a reallocation
         ofSetColor(255,0,0); ofDrawRectangle(0,0,ofGetWidth(), ofGetHeight());
         ofSetColor(255); ofDrawBitmapString("Output FBO not allocated", 20, 20);
     }
 }
 
+VideoFeedbackManager::DelayTap VideoFeedbackManager::getDelayTap() const {
+    DelayTap tap;
+    if (frameBufferLength <= 1) {
+        return tap;
+    }
+    float delayTimeMs = paramManager->getDelayTimeMs();
+    if (delayTimeMs <= 0.0f) {
+        float delayFrames = ofClamp(paramManager->getEffective(ParameterManager::PARAM_DELAY_AMOUNT), 0.0f, frameBufferLength - 1.0f);
+        int wholeFrames = (int)delayFrames;
+        tap.index = (frameBufferLength + currentFrameIndex - wholeFrames) % frameBufferLength;
+        tap.olderIndex = (tap.index + frameBufferLength - 1) % frameBufferLength;
+        tap.fraction = delayFrames - wholeFrames;
+        return tap;
+    }
+
+    // The slot stored `age` frames ago is currentFrameIndex - age - 1. Walk back until a frame is
+    // at least delayTimeMs old and blend with the newer neighbour by timestamp, so the delay
+    // holds its length in time whatever the frame rate
+    uint64_t now = ofGetElapsedTimeMicros();
+    double target = delayTimeMs * 1000.0;
+    int newestSlot = (frameBufferLength + currentFrameIndex - 2) % frameBufferLength;
+    tap.index = tap.olderIndex = newestSlot;
+    double newerAge = 0.0;
+    for (int age = 1; age < frameBufferLength; age++) {
+        int slot = (2 * frameBufferLength + currentFrameIndex - age - 1) % frameBufferLength;
+        if (frameTimes[slot] == 0 || frameTimes[slot] > now) {
+            break; // Not stored since the ring was reset
+        }
+        double slotAge = (double)(now - frameTimes[slot]);
+        if (slotAge >= target) {
+            if (age == 1) {
+                tap.index = tap.olderIndex = slot; // Shorter than one frame: the newest there is
+            } else {
+                tap.olderIndex = slot;
+                tap.fraction = (float)((target - newerAge) / std::max(slotAge - newerAge, 1.0));
+            }
+            return tap;
+        }
+        tap.index = tap.olderIndex = slot; // Longer than the history so far: the oldest one
+        newerAge = slotAge;
+    }
+    return tap;
+}
+
+void VideoFeedbackManager::setEchoTapUniforms(ofShader& mixerShader, const ofTexture& idleTexture) {
+    // Samplers must all be bound even when unused, so idle taps get the main feedback frame
+    float gains[MAX_ECHO_TAPS] = {};
+    float zooms[MAX_ECHO_TAPS] = {};
+    float rotations[MAX_ECHO_TAPS] = {};
+    float hueShifts[MAX_ECHO_TAPS] = {};
+    float offsets[MAX_ECHO_TAPS * 2] = {};
+    int count = 0;
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        const EchoTap& tap = echoTaps[i];
+        int index = getEchoTapSlot(i);
+        bool active = tap.enabled && tap.gain != 0.0f && isAllocated(pastFrames[index]);
+        mixerShader.setUniformTexture("echoTap" + ofToString(i), active ? pastFrames[index]->getTexture() : idleTexture, 4 + i);
+        if (!active) {
+            continue;
+        }
+        gains[i] = tap.gain;
+        zooms[i] = tap.zoom;
+        rotations[i] = tap.rotate;
+        hueShifts[i] = tap.hueShift;
+        offsets[i * 2] = tap.xOffset;
+        offsets[i * 2 + 1] = tap.yOffset;
+        count = i + 1; // The shader loops up to the last active tap
+    }
+    mixerShader.setUniform1i("echoTapCount", count);
+    mixerShader.setUniform1fv("echoGain", gains, MAX_ECHO_TAPS);
+    mixerShader.setUniform1fv("echoZoom", zooms, MAX_ECHO_TAPS);
+    mixerShader.setUniform1fv("echoRotate", rotations, MAX_ECHO_TAPS);
+    mixerShader.setUniform1fv("echoHue", hueShifts, MAX_ECHO_TAPS);
+    mixerShader.setUniform2fv("echoOffset", offsets, MAX_ECHO_TAPS);
+}
+
+int VideoFeedbackManager::getEchoTapSlot(int tap) const {
+    int delay = std::max(0, std::min((int)std::round(echoTaps[tap].delayFrames), frameBufferLength - 1));
+    return (frameBufferLength + currentFrameIndex - delay) % frameBufferLength;
+}
+
+int VideoFeedbackManager::getActiveEchoTaps() const {
+    return (int)std::count_if(std::begin(echoTaps), std::end(echoTaps), [](const EchoTap& tap) { return tap.enabled && tap.gain != 0.0f; });
+}
+
+void VideoFeedbackManager::loadEchoTapsFromXml(ofxXmlSettings& xml) {
+    if (!xml.tagExists("echoTaps")) {
+        return;
+    }
+    xml.pushTag("echoTaps");
+    int numTaps = xml.getNumTags("tap");
+    for (int i = 0; i < numTaps; i++) {
+        int index = xml.getAttribute("tap", "index", -1, i);
+        if (index < 0 || index >= MAX_ECHO_TAPS) {
+            continue;
+        }
+        EchoTap& tap = echoTaps[index];
+        tap.enabled = xml.getAttribute("tap", "enabled", 0, i) != 0;
+        tap.delayFrames = std::max(0.0, xml.getAttribute("tap", "delay", (double)tap.delayFrames, i));
+        tap.gain = xml.getAttribute("tap", "gain", (double)tap.gain, i);
+        tap.zoom = xml.getAttribute("tap", "zoom", (double)tap.zoom, i);
+        tap.rotate = xml.getAttribute("tap", "rotate", (double)tap.rotate, i);
+        tap.xOffset = xml.getAttribute("tap", "x", (double)tap.xOffset, i);
+        tap.yOffset = xml.getAttribute("tap", "y", (double)tap.yOffset, i);
+        tap.hueShift = xml.getAttribute("tap", "hue", (double)tap.hueShift, i);
+    }
+    xml.popTag(); // pop echoTaps
+    ofLogNotice("VideoFeedbackManager") << getActiveEchoTaps() << " echo taps active";
+}
+
+void VideoFeedbackManager::saveEchoTapsToXml(ofxXmlSettings& xml) const {
+    if (xml.tagExists("echoTaps")) {
+        xml.removeTag("echoTaps");
+    }
+    xml.addTag("echoTaps");
+    xml.pushTag("echoTaps");
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        const EchoTap& tap = echoTaps[i];
+        int tag = xml.addTag("tap");
+        xml.addAttribute("tap", "index", i, tag);
+        xml.addAttribute("tap", "enabled", tap.enabled ? 1 : 0, tag);
+        xml.addAttribute("tap", "delay", tap.delayFrames, tag);
+        xml.addAttribute("tap", "gain", tap.gain, tag);
+        xml.addAttribute("tap", "zoom", tap.zoom, tag);
+        xml.addAttribute("tap", "rotate", tap.rotate, tag);
+        xml.addAttribute("tap", "x", tap.xOffset, tag);
+        xml.addAttribute("tap", "y", tap.yOffset, tag);
+        xml.addAttribute("tap", "hue", tap.hueShift, tag);
+    }
+    xml.popTag(); // pop echoTaps
+}
+
+GLint VideoFeedbackManager::resolveHdrFormat() {
+    if (hdrMode == HDR_OFF) {
+        return GL_RGBA8;
+    }
+    auto cached = hdrFormatCache.find(hdrMode);
+    if (cached != hdrFormatCache.end()) {
+        return cached->second;
+    }
+    GLint format = TextureHelper::getHdrInternalFormat(hdrMode == HDR_PACKED);
+    if (format != GL_RGBA8 && !TextureHelper::canRenderTo(format)) {
+        ofLogWarning("VideoFeedbackManager") << TextureHelper::getFormatName(format) << " is advertised but not renderable";
+        format = hdrMode == HDR_PACKED ? TextureHelper::getHdrInternalFormat(false) : GL_RGBA8;
+        if (format != GL_RGBA8 && !TextureHelper::canRenderTo(format)) {
+            format = GL_RGBA8;
+        }
+    }
+    if (format == GL_RGBA8) {
+        ofLogWarning("VideoFeedbackManager") << "No float render targets on this GL, HDR " << getHdrModeName(hdrMode)
+                                             << " falls back to GL_RGBA8";
+    }
+    hdrFormatCache[hdrMode] = format;
+    return format;
+}
+
+bool VideoFeedbackManager::needsFeedbackMipmaps(const float* params) const {
+    if (!feedbackMipmaps || feedbackMipmapSupport == 0) {
+        return false;
+    }
+    // The mixer scales feedback coordinates by zDisplace * (1 + vZ * luma): above 1 is a zoom out
+    float maxZoom = params[ParameterManager::PARAM_Z_DISPLACE] * (1.0f + std::abs(params[ParameterManager::PARAM_V_Z_DISPLACE]));
+    return maxZoom > 1.0f;
+}
+
+void VideoFeedbackManager::prepareMipmappedTap(const DelayTap& tap) {
+    feedbackMipFbo->begin();
+    ofPushStyle();
+    ofClear(0, 0, 0, 255);
+    ofSetColor(255);
+    pastFrames[tap.index]->draw(0, 0);
+    if (tap.fraction > 0.0f && isAllocated(pastFrames[tap.olderIndex])) {
+        ofEnableAlphaBlending();
+        ofSetColor(255, 255, 255, tap.fraction * 255.0f);
+        pastFrames[tap.olderIndex]->draw(0, 0);
+    }
+    ofPopStyle();
+    feedbackMipFbo->end();
+
+    ofTexture& texture = feedbackMipFbo->getTexture();
+    texture.generateMipmap();
+    texture.setTextureMinMagFilter(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR);
+}
+
+void VideoFeedbackManager::setFeedbackMipmapsEnabled(bool enabled) {
+    feedbackMipmaps = enabled;
+    if (enabled && feedbackMipmapSupport < 0) {
+        feedbackMipmapSupport = TextureHelper::canMipmapNpot() && TextureHelper::canSampleLodInFragment() ? 1 : 0;
+        if (!feedbackMipmapSupport) {
+            // Without an explicit level the mixer would take the implicit one, which breaks at the wraps
+            ofLogWarning("VideoFeedbackManager") << "Feedback mipmaps need NPOT mipmaps (GLES 3 or OES_texture_npot) and "
+                                                 << "texture LOD in fragment shaders (EXT/ARB_shader_texture_lod), left off";
+        }
+    }
+    if (!enabled) {
+        releaseFeedbackMipFbo();
+    }
+}
+
+void VideoFeedbackManager::releaseFeedbackMipFbo() {
+    if (!feedbackMipFbo) {
+        return;
+    }
+    feedbackMipFbo->getTexture().setTextureMinMagFilter(GL_LINEAR, GL_LINEAR); // Pool targets go back plain
+    getRenderTargetPool().release(feedbackMipFbo);
+    if (memory) memory->release("video.feedbackMips");
+}
+
+void VideoFeedbackManager::setHdrMode(HdrMode mode) {
+    configureTargets(mode, hdrHistory, loopScale);
+}
+
+void VideoFeedbackManager::setHdrHistoryEnabled(bool enabled) {
+    configureTargets(hdrMode, enabled, loopScale);
+}
+
+void VideoFeedbackManager::setLoopScale(float scale) {
+    configureTargets(hdrMode, hdrHistory, scale);
+}
+
+void VideoFeedbackManager::configureTargets(HdrMode mode, bool history, float scale) {
+    scale = ofClamp(scale, 0.25f, 1.0f);
+    // The history format only changes while HDR is on
+    bool changed = mode != hdrMode || scale != loopScale || (history != hdrHistory && mode != HDR_OFF);
+    hdrMode = mode;
+    hdrHistory = history;
+    loopScale = scale;
+    if (changed && pipelineSettings.width > 0) {
+        allocateFbos(width, height);
+    }
+}
+
+std::string VideoFeedbackManager::getHdrModeName(HdrMode mode) {
+    switch (mode) {
+        case HDR_HALF: return "rgba16f";
+        case HDR_PACKED: return "r11g11b10f";
+        default: return "off";
+    }
+}
+
+VideoFeedbackManager::HdrMode VideoFeedbackManager::findHdrMode(const std::string& name) {
+    if (name == "rgba16f") return HDR_HALF;
+    if (name == "r11g11b10f") return HDR_PACKED;
+    return HDR_OFF;
+}
+
+void VideoFeedbackManager::benchmarkFormats(int passes) {
+    // Ping-pong full-frame copies: each pass reads one target and writes the other, so the
+    // traffic is twice the frame size per pass. glFinish brackets the loop so the timing
+    // covers the GPU work rather than just the submission
+    std::vector<GLint> formats = { GL_RGBA8 };
+    #if defined(GL_RGBA16F) && defined(GL_R11F_G11F_B10F)
+        formats.push_back(GL_RGBA16F);
+        formats.push_back(GL_R11F_G11F_B10F);
+    #endif
+    const GLubyte* renderer = glGetString(GL_RENDERER);
+    ofLogNotice("VideoFeedbackManager") << "Format benchmark at " << fboSettings.width << "x" << fboSettings.height << ", "
+                                        << passes << " passes on " << (renderer ? (const char*)renderer : "unknown GL");
+    passes = std::max(passes, 2);
+    for (GLint format : formats) {
+        if (format != GL_RGBA8 && !TextureHelper::canRenderTo(format)) {
+            ofLogNotice("VideoFeedbackManager") << "  " << TextureHelper::getFormatName(format) << ": not renderable";
+            continue;
+        }
+        ofFboSettings settings = fboSettings;
+        settings.internalformat = format;
+        std::shared_ptr<ofFbo> targets[2] = { acquireClearedFbo(settings), acquireClearedFbo(settings) };
+
+        glFinish();
+        uint64_t start = ofGetElapsedTimeMicros();
+        for (int i = 0; i < passes; i++) {
+            targets[(i + 1) % 2]->begin();
+            targets[i % 2]->draw(0, 0);
+            targets[(i + 1) % 2]->end();
+        }
+        glFinish();
+        double seconds = std::max(ofGetElapsedTimeMicros() - start, (uint64_t)1) / 1000000.0;
+
+        double bytes = 2.0 * passes * MemoryTracker::getTextureBytes(settings.width, settings.height, format);
+        ofLogNotice("VideoFeedbackManager") << "  " << ofToString(TextureHelper::getFormatName(format), 20, ' ')
+                                            << ofToString(seconds * 1000.0 / passes, 3) << " ms/pass, "
+                                            << ofToString(bytes / seconds / 1.0e9, 2) << " GB/s";
+        getRenderTargetPool().release(targets[0]);
+        getRenderTargetPool().release(targets[1]);
+    }
+}
+
+void VideoFeedbackManager::processCpuPipeline(const ofTexture& inputTexture, const DelayTap& delayTap) {
+    if (!paramManager || !inputTexture.isAllocated() || pipelineSettings.width <= 0 || frameBufferLength <= 0) {
+        return;
+    }
+    if ((int)cpuFrames.size() != frameBufferLength) {
+        resetCpuHistory();
+    }
+    int w = pipelineSettings.width;
+    int h = pipelineSettings.height;
+    int storeIndex = (frameBufferLength + currentFrameIndex - 1) % frameBufferLength; // Also the temporal filter's slot
+    readInputToPixels(inputTexture, cpuInput);
+
+    CpuFeedbackRenderer::Sources sources;
+    sources.input = &cpuInput;
+    sources.fb = &cpuFrames[delayTap.index];
+    sources.fbOlder = &cpuFrames[delayTap.olderIndex];
+    sources.temporalFilter = paramManager->isWetModeEnabled() ? &cpuFrames[storeIndex] : &cpuDryFrame;
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        if (echoTaps[i].enabled && echoTaps[i].gain != 0.0f) {
+            sources.echoTaps[i] = &cpuFrames[getEchoTapSlot(i)];
+        }
+    }
+
+    uint64_t start = ofGetElapsedTimeMicros();
+    getCpuRenderer().render(sources, makeCpuUniforms(delayTap), w, h, cpuMixed, cpuOutput);
+    cpuRenderMs = (ofGetElapsedTimeMicros() - start) / 1000.0f;
+
+    if (!cpuOutputTexture.isAllocated() || (int)cpuOutputTexture.getWidth() != w || (int)cpuOutputTexture.getHeight() != h) {
+        cpuOutputTexture.allocate(w, h, GL_RGBA8);
+        // Rows are bottom-up, as read back from an FBO, so it's drawn the way an FBO texture is
+        cpuOutputTexture.getTextureData().bFlipTexture = true;
+        if (memory) memory->track("video.cpuOutput", "video", MemoryTracker::GPU, MemoryTracker::getTextureBytes(w, h, GL_RGBA8));
+    }
+    cpuOutputTexture.loadData(cpuOutput);
+
+    // The ring takes the buffers over instead of copying them; what it gives back is reused next frame
+    if (paramManager->isWetModeEnabled()) {
+        std::swap(cpuFrames[storeIndex], cpuOutput);
+    } else {
+        std::swap(cpuFrames[storeIndex], cpuInput);
+        std::swap(cpuDryFrame, cpuOutput);
+    }
+    frameTimes[storeIndex] = ofGetElapsedTimeMicros();
+
+    if (memory) {
+        size_t bytes = cpuDryFrame.size() + cpuInput.size() + cpuMixed.size() + cpuOutput.size();
+        for (const ofPixels& frame : cpuFrames) {
+            bytes += frame.size();
+        }
+        memory->track("video.cpuHistory", "video", MemoryTracker::CPU, bytes);
+    }
+}
+
+CpuFeedbackRenderer& VideoFeedbackManager::getCpuRenderer() {
+    if (!cpuRenderer) {
+        cpuRenderer = std::make_unique<CpuFeedbackRenderer>(cpuThreads);
+    }
+    return *cpuRenderer;
+}
+
+CpuFeedbackRenderer::Uniforms VideoFeedbackManager::makeCpuUniforms(const DelayTap& delayTap) const {
+    const float* params = paramManager->getEffectiveValues();
+    CpuFeedbackRenderer::Uniforms u;
+    u.lumakey = params[ParameterManager::PARAM_LUMAKEY_VALUE];
+    u.fbMix = params[ParameterManager::PARAM_MIX];
+    u.fbHue = params[ParameterManager::PARAM_HUE];
+    u.fbSaturation = params[ParameterManager::PARAM_SATURATION];
+    u.fbBright = params[ParameterManager::PARAM_BRIGHTNESS];
+    u.temporalFilterMix = params[ParameterManager::PARAM_TEMPORAL_FILTER_MIX];
+    u.temporalFilterResonance = params[ParameterManager::PARAM_TEMPORAL_FILTER_RESONANCE];
+    u.fbXDisplace = params[ParameterManager::PARAM_X_DISPLACE];
+    u.fbYDisplace = params[ParameterManager::PARAM_Y_DISPLACE];
+    u.fbZDisplace = params[ParameterManager::PARAM_Z_DISPLACE];
+    u.fbRotate = params[ParameterManager::PARAM_ROTATE];
+    u.fbHuexMod = params[ParameterManager::PARAM_HUE_MODULATION];
+    u.fbHuexOff = params[ParameterManager::PARAM_HUE_OFFSET];
+    u.fbHuexLfo = params[ParameterManager::PARAM_HUE_LFO];
+    u.fbDelayFraction = delayTap.fraction; // Ignored while the older slot is empty, as on the GPU
+    u.toroid = paramManager->isToroidEnabled();
+    u.mirror = paramManager->isMirrorModeEnabled();
+    u.brightInvert = paramManager->isBrightnessInverted();
+    u.hueInvert = paramManager->isHueInverted();
+    u.saturationInvert = paramManager->isSaturationInverted();
+    u.horizontalMirror = paramManager->isHorizontalMirrorEnabled();
+    u.verticalMirror = paramManager->isVerticalMirrorEnabled();
+    u.lumakeyInvert = paramManager->isLumakeyInverted();
+    u.vLumakey = params[ParameterManager::PARAM_V_LUMAKEY_VALUE];
+    u.vMix = params[ParameterManager::PARAM_V_MIX];
+    u.vHue = params[ParameterManager::PARAM_V_HUE];
+    u.vSat = params[ParameterManager::PARAM_V_SATURATION];
+    u.vBright = params[ParameterManager::PARAM_V_BRIGHTNESS];
+    u.vTemporalFilterMix = params[ParameterManager::PARAM_V_TEMPORAL_FILTER_MIX];
+    u.vFb1X = params[ParameterManager::PARAM_V_TEMPORAL_FILTER_RESONANCE];
+    u.vX = params[ParameterManager::PARAM_V_X_DISPLACE];
+    u.vY = params[ParameterManager::PARAM_V_Y_DISPLACE];
+    u.vZ = params[ParameterManager::PARAM_V_Z_DISPLACE];
+    u.vRotate = params[ParameterManager::PARAM_V_ROTATE];
+    u.vHuexMod = params[ParameterManager::PARAM_V_HUE_MODULATION];
+    u.vHuexOff = params[ParameterManager::PARAM_V_HUE_OFFSET];
+    u.vHuexLfo = params[ParameterManager::PARAM_V_HUE_LFO];
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        const EchoTap& tap = echoTaps[i];
+        if (!tap.enabled || tap.gain == 0.0f) {
+            continue;
+        }
+        u.echoGain[i] = tap.gain;
+        u.echoZoom[i] = tap.zoom;
+        u.echoRotate[i] = tap.rotate;
+        u.echoHue[i] = tap.hueShift;
+        u.echoOffset[i * 2] = tap.xOffset;
+        u.echoOffset[i * 2 + 1] = tap.yOffset;
+        u.echoTapCount = i + 1;
+    }
+    u.sharpenAmount = params[ParameterManager::PARAM_SHARPEN_AMOUNT];
+    u.vSharpenAmount = params[ParameterManager::PARAM_V_SHARPEN_AMOUNT];
+    return u;
+}
+
+void VideoFeedbackManager::readInputToPixels(const ofTexture& inputTexture, ofPixels& pixels) {
+    // Through an FBO: it scales like the mixer's draw, and GLES can't read a texture back directly
+    std::shared_ptr<ofFbo> scratch = getRenderTargetPool().acquireFbo(pipelineSettings);
+    scratch->begin();
+    ofClear(0, 0, 0, 255);
+    inputTexture.draw(0, 0, scratch->getWidth(), scratch->getHeight());
+    scratch->end();
+    scratch->readToPixels(pixels);
+    getRenderTargetPool().release(scratch);
+}
+
+std::unique_ptr<VideoFeedbackManager::CpuValidation> VideoFeedbackManager::captureCpuValidation(const ofTexture& inputTexture,
+                                                                                                const DelayTap& delayTap) {
+    if (feedbackMipmapActive) {
+        ofLogNotice("VideoFeedbackManager") << "CPU validation skipped: the mipmapped feedback tap has no CPU equivalent";
+        return nullptr;
+    }
+    auto validation = std::make_unique<CpuValidation>();
+    auto readSlot = [this](int index, ofPixels& pixels) {
+        if (index >= 0 && index < frameBufferLength && isAllocated(pastFrames[index])) {
+            pastFrames[index]->readToPixels(pixels);
+        }
+    };
+    readInputToPixels(inputTexture, validation->input);
+    readSlot(delayTap.index, validation->fb);
+    if (delayTap.fraction > 0.0f) {
+        readSlot(delayTap.olderIndex, validation->fbOlder);
+    }
+    if (paramManager->isWetModeEnabled()) {
+        readSlot((frameBufferLength + currentFrameIndex - 1) % frameBufferLength, validation->temporalFilter);
+    } else if (isAllocated(sharpenFbo)) {
+        sharpenFbo->readToPixels(validation->temporalFilter); // Last frame's output
+    }
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        if (echoTaps[i].enabled && echoTaps[i].gain != 0.0f) {
+            readSlot(getEchoTapSlot(i), validation->echoTaps[i]);
+        }
+    }
+    return validation;
+}
+
+void VideoFeedbackManager::finishCpuValidation(const CpuValidation& validation, const DelayTap& delayTap) {
+    ofPixels gpuOutput;
+    sharpenFbo->readToPixels(gpuOutput);
+
+    CpuFeedbackRenderer::Sources sources;
+    sources.input = &validation.input;
+    sources.fb = &validation.fb;
+    sources.fbOlder = &validation.fbOlder;
+    sources.temporalFilter = &validation.temporalFilter;
+    for (int i = 0; i < MAX_ECHO_TAPS; i++) {
+        sources.echoTaps[i] = &validation.echoTaps[i];
+    }
+    ofPixels mixed;
+    ofPixels cpuResult;
+    CpuFeedbackRenderer& renderer = getCpuRenderer();
+    uint64_t start = ofGetElapsedTimeMicros();
+    renderer.render(sources, makeCpuUniforms(delayTap), (int)gpuOutput.getWidth(), (int)gpuOutput.getHeight(), mixed, cpuResult);
+    float ms = (ofGetElapsedTimeMicros() - start) / 1000.0f;
+
+    int maxError = 0;
+    float meanError = 0.0f;
+    CpuFeedbackRenderer::compare(gpuOutput, cpuResult, maxError, meanError);
+    // A float pipeline format skips the 8-bit step between the passes, so expect slightly more
+    ofLogNotice("VideoFeedbackManager") << "CPU renderer (" << CpuFeedbackRenderer::getSimdName() << ", "
+                                        << renderer.getThreadCount() << " threads) vs GPU: max error " << maxError
+                                        << ", mean " << ofToString(meanError, 2) << " of 255, " << ofToString(ms, 1)
+                                        << " ms on the CPU";
+}
+
+void VideoFeedbackManager::resetCpuHistory() {
+    cpuFrames.clear();
+    cpuDryFrame.clear();
+    cpuInput.clear();
+    cpuMixed.clear();
+    cpuOutput.clear();
+    if (backend == BACKEND_CPU) {
+        cpuFrames.resize(frameBufferLength);
+    } else if (cpuOutputTexture.isAllocated()) {
+        cpuOutputTexture.clear();
+        if (memory) memory->release("video.cpuOutput");
+    }
+    if (memory) memory->release("video.cpuHistory");
+}
+
+void VideoFeedbackManager::setBackend(Backend backend) {
+    if (backend == this->backend) {
+        return;
+    }
+    this->backend = backend;
+    resetCpuHistory();
+    frameTimes.assign(frameBufferLength, 0); // They timed the other backend's ring
+    if (backend == BACKEND_CPU) {
+        ofLogNotice("VideoFeedbackManager") << "CPU backend: " << getCpuRenderer().getThreadCount() << " threads, "
+                                            << CpuFeedbackRenderer::getSimdName();
+    } else {
+        clearFbos(); // Whatever the GPU ring held from before the switch
+        restartHistoryWarmup();
+        ofLogNotice("VideoFeedbackManager") << "GPU backend";
+    }
+}
+
+void VideoFeedbackManager::setCpuThreads(int threads) {
+    threads = std::max(0, threads);
+    if (threads != cpuThreads) {
+        cpuThreads = threads;
+        cpuRenderer.reset(); // Recreated with the new count on next use
+    }
+}
+
+void VideoFeedbackManager::validateCpuRenderer() {
+    if (backend == BACKEND_CPU) {
+        ofLogNotice("VideoFeedbackManager") << "CPU validation needs the GPU backend to compare against";
+        return;
+    }
+    cpuValidationPending = true;
+}
+
+void VideoFeedbackManager::setMixerQuality(MixerQuality quality) {
+    if (quality == mixerQuality) {
+        return;
+    }
+    mixerQuality = quality;
+    checkerboardHistory.reset(); // Nothing to reconstruct from until a checkerboard frame ran
+    ofLogNotice("VideoFeedbackManager") << "Mixer quality: " << getMixerQualityName(quality);
+}
+
+std::string VideoFeedbackManager::getUpscalerName(Upscaler upscaler) {
+    return upscaler == UPSCALE_LANCZOS ? "lanczos" : "bilinear";
+}
+
+VideoFeedbackManager::Upscaler VideoFeedbackManager::findUpscaler(const std::string& name) {
+    return name == "lanczos" ? UPSCALE_LANCZOS : UPSCALE_BILINEAR;
+}
+
+std::string VideoFeedbackManager::getMixerQualityName(MixerQuality quality) {
+    return quality == MIXER_CHECKERBOARD ? "checkerboard" : "full";
+}
+
+VideoFeedbackManager::MixerQuality VideoFeedbackManager::findMixerQuality(const std::string& name) {
+    return name == "checkerboard" ? MIXER_CHECKERBOARD : MIXER_FULL;
+}
+
+std::string VideoFeedbackManager::getBackendName(Backend backend) {
+    return backend == BACKEND_CPU ? "cpu" : "gpu";
+}
+
+VideoFeedbackManager::Backend VideoFeedbackManager::findBackend(const std::string& name) {
+    return name == "cpu" ? BACKEND_CPU : BACKEND_GPU;
+}
+
+void VideoFeedbackManager::allocatePastFrameIfNeeded(int index) {
+    if (index < 0 || index >= frameBufferLength || pastFrames[index]) {
+        return;
+    }
+    if (memory && !memory->reserve("video.pastFrame." + ofToString(index), "video", MemoryTracker::GPU,
+                                   MemoryTracker::getFboBytes(fboSettings))) {
+        return; // Over budget with POLICY_REFUSE: this delay slot stays empty and the mixer skips it
+    }
+    pastFrames[index] = acquireClearedFbo(fboSettings);
+}
+
+void VideoFeedbackManager::warmUpHistory() {
+    if (backend == BACKEND_CPU || historyWarmup == WARMUP_LAZY || warmupVisited >= frameBufferLength) {
+        return;
+    }
+    if (historyWarmup == WARMUP_BUDGETED) {
+        if (!hasSpareFrameTime()) {
+            return; // Try again on a quieter frame
+        }
+        size_t frameBytes = MemoryTracker::getFboBytes(fboSettings);
+        if (memory && memory->getAvailable(MemoryTracker::GPU) < 2 * frameBytes) {
+            warmupVisited = frameBufferLength; // Leave the rest to lazy allocation
+        }
+    }
+
+    int allocated = 0;
+    while (allocated < warmupSlotsPerFrame && warmupVisited < frameBufferLength) {
+        int index = (warmupStart + warmupVisited) % frameBufferLength;
+        warmupVisited++;
+        if (!pastFrames[index]) {
+            allocatePastFrameIfNeeded(index);
+            if (pastFrames[index]) allocated++; // A refused slot doesn't use up this frame's share
+        }
+    }
+
+    if (warmupVisited >= frameBufferLength && !warmupLogged) {
+        warmupLogged = true;
+        ofLogNotice("VideoFeedbackManager") << "History warm-up (" << getHistoryWarmupName(historyWarmup) << "): "
+                                            << getReadyHistorySlots() << " of " << frameBufferLength << " slots ready";
+    }
+}
+
+int VideoFeedbackManager::getReadyHistorySlots() const {
+    return (int)std::count_if(pastFrames.begin(), pastFrames.end(), [](const std::shared_ptr<ofFbo>& frame) { return isAllocated(frame); });
+}
+
+void VideoFeedbackManager::setHistoryWarmup(HistoryWarmup warmup) {
+    historyWarmup = warmup;
+    restartHistoryWarmup();
+}
+
+std::string VideoFeedbackManager::getHistoryWarmupName(HistoryWarmup warmup) {
+    switch (warmup) {
+        case WARMUP_EAGER: return "eager";
+        case WARMUP_LAZY: return "lazy";
+        default: return "budgeted";
+    }
+}
+
+VideoFeedbackManager::HistoryWarmup VideoFeedbackManager::findHistoryWarmup(const std::string& name) {
+    if (name == "eager") return WARMUP_EAGER;
+    if (name == "lazy") return WARMUP_LAZY;
+    return WARMUP_BUDGETED;
+}
+
+void VideoFeedbackManager::restartHistoryWarmup() {
+    // The pipeline stores into currentFrameIndex - 1 next, so start there and stay ahead of it
+    warmupStart = frameBufferLength > 0 ? (frameBufferLength + currentFrameIndex - 1) % frameBufferLength : 0;
+    warmupVisited = 0;
+    warmupLogged = historyWarmup == WARMUP_LAZY;
+}
+
+bool VideoFeedbackManager::hasSpareFrameTime() const {
+    // The work time, not ofGetLastFrameTime(): the frame limiter and vsync pad that to the full period
+    float targetFrameRate = ofGetTargetFrameRate() > 0 ? ofGetTargetFrameRate() : 60.0f;
+    return frameWorkMicros < 0.75f * 1000000.0f / targetFrameRate; // A quarter of the frame left over
+}
+
+RenderTargetPool& VideoFeedbackManager::getRenderTargetPool() {
+    if (!pool) {
+        ownedPool = std::make_unique<RenderTargetPool>(memory);
+        pool = ownedPool.get();
+    }
+    return *pool;
+}
+
+std::shared_ptr<ofFbo> VideoFeedbackManager::acquireClearedFbo(const ofFboSettings& settings) {
+    std::shared_ptr<ofFbo> fbo = getRenderTargetPool().acquireFbo(settings);
+    fbo->begin(); ofClear(0, 0, 0, 255); fbo->end(); // Reused targets hold old content
+    return fbo;
+}
+
+void VideoFeedbackManager::releaseRenderTargets() {
+    RenderTargetPool& targets = getRenderTargetPool();
+    targets.release(aspectRatioFbo);
+    sharpenFbo.reset(); // The render graph's or a history slot, never released from here
+    compositeFbo.reset();
+    checkerboardHistory.reset();
+    renderGraph.releaseRetained();
+    releaseFeedbackMipFbo();
+    for (auto& frame : pastFrames) {
+        targets.release(frame);
+    }
+}
+
+void VideoFeedbackManager::fitToMemoryBudget(ofFboSettings& settings, const ofFboSettings& inputSettings, GLint hdrFormat) {
+    if (!memory || memory->getPolicy() != MemoryTracker::POLICY_DEGRADE) {
+        return;
+    }
+    // Everything under "video." is about to be replaced, so measure against the rest
+    size_t available = memory->getAvailable(MemoryTracker::GPU, "video.");
+    if (available == SIZE_MAX) {
+        return;
+    }
+
+    const int minDelayFrames = 2;  // Current and previous frame for the temporal filter
+    while (true) {
+        size_t frameBytes = MemoryTracker::getFboBytes(settings);
+        // Without split resolution the input side is scaled down with the loop
+        size_t fixedBytes = estimateFixedGpuBytes(settings, isSplitResolution() ? inputSettings : settings, hdrFormat);
+        if (fixedBytes + frameBytes * minDelayFrames <= available) {
+            int affordable = (int)((available - fixedBytes) / frameBytes);
+            if (affordable < frameBufferLength) {
+                ofLogWarning("VideoFeedbackManager") << "GPU budget: delay buffer reduced from " << frameBufferLength
+                                                     << " to " << affordable << " frames";
+                resizeFrameRing(affordable);
+            }
+            return;
+        }
+        if (settings.width <= 160 || settings.height <= 120) {
+            ofLogError("VideoFeedbackManager") << "GPU budget of " << MemoryTracker::toMegabytes(memory->getBudget(MemoryTracker::GPU))
+                                               << " MB is too small even at " << settings.width << "x" << settings.height;
+            return;
+        }
+        settings.width = std::max(settings.width / 2, 160);
+        settings.height = std::max(settings.height / 2, 120);
+        ofLogWarning("VideoFeedbackManager") << "GPU budget: render resolution reduced to " << settings.width << "x" << settings.height;
+    }
+}
+
+size_t VideoFeedbackManager::estimateFixedGpuBytes(const ofFboSettings& loopSettings, const ofFboSettings& inputSettings, GLint hdrFormat) const {
+    // Same formats and sizes allocate() derives for the pipeline and output targets
+    ofFboSettings pipeline = loopSettings;
+    pipeline.internalformat = hdrFormat;
+    size_t pipelineBytes = MemoryTracker::getFboBytes(pipeline);
+
+    size_t bytes = MemoryTracker::getFboBytes(inputSettings); // Aspect ratio
+    bytes += pipelineBytes * 3; // Mixed and output, plus last frame's output still retained
+    if (feedbackMipmaps && feedbackMipmapSupport != 0) {
+        bytes += MemoryTracker::getFboBytes(loopSettings) * 4 / 3; // Mip tap with its chain
+    }
+    if (mixerQuality == MIXER_CHECKERBOARD) {
+        ofFboSettings half = pipeline;
+        half.width = (pipeline.width + 1) / 2;
+        bytes += MemoryTracker::getFboBytes(half) + pipelineBytes; // Half-width mixer target, reconstruction history
+    }
+    if (isSplitResolution()) {
+        ofFboSettings output = inputSettings;
+        output.internalformat = hdrFormat;
+        bytes += pipelineBytes + MemoryTracker::getFboBytes(output) * 2; // Loop-size input, composite and its retained copy
+    }
+    return bytes;
+}
+
 void VideoFeedbackManager::clearFbos() {
-    if(mainFbo.isAllocated()) { mainFbo.begin(); ofClear(0, 0, 0, 255); mainFbo.end(); }
-    if(aspectRatioFbo.isAllocated()) { aspectRatioFbo.begin(); ofClear(0, 0, 0, 255); aspectRatioFbo.end(); }
-    if(dryFrameBuffer.isAllocated()) { dryFrameBuffer.begin(); ofClear(0, 0, 0, 255); dryFrameBuffer.end(); }
-    if(sharpenFbo.isAllocated()) { sharpenFbo.begin(); ofClear(0, 0, 0, 255); sharpenFbo.end(); }
+    if(isAllocated(aspectRatioFbo)) { aspectRatioFbo->begin(); ofClear(0, 0, 0, 255); aspectRatioFbo->end(); }
+    if(isAllocated(sharpenFbo)) { sharpenFbo->begin(); ofClear(0, 0, 0, 255); sharpenFbo->end(); }
+    if(isAllocated(compositeFbo) && compositeFbo != sharpenFbo) { compositeFbo->begin(); ofClear(0, 0, 0, 255); compositeFbo->end(); }
     for (int i = 0; i < frameBufferLength; i++) {
-         if (pastFramesAllocated && pastFramesAllocated[i] && pastFrames[i].isAllocated()) {
-            pastFrames[i].begin(); ofClear(0, 0, 0, 255); pastFrames[i].end();
+         if (isAllocated(pastFrames[i])) {
+            pastFrames[i]->begin(); ofClear(0, 0, 0, 255); pastFrames[i]->end();
         }
     }
 }
@@ -383,14 +1267,14 @@ bool VideoFeedbackManager::selectVideoDevice(const std::string& deviceName) {
     ofLogError("VideoFeedbackManager") << "Video device not found: " << deviceName; return false;
 }
 
-void VideoFeedbackManager::setupCamera(int width, int height) {
-    this->width = width; this->height = height;
-    ofLogNotice("VideoFeedbackManager") << "Setting up camera with dimensions: " << width << "x" << height;
+void VideoFeedbackManager::probeCamera(int width, int height) {
+    // Worker thread: only device queries, nothing the render thread reads until attachCamera()
+    ofLogNotice("VideoFeedbackManager") << "Probing camera for dimensions: " << width << "x" << height;
     #ifdef TARGET_LINUX
     setenv("OF_VIDEO_CAPTURE_BACKEND", "v4l2", 1);
     setenv("GST_DEBUG", "0", 1);
     std::string devicePath = "/dev/video0";
-    if (paramManager) { devicePath = paramManager->getVideoDevicePath(); }
+    if (paramManager) { devicePath = paramManager->getVideoDevicePath(); } // Read-only; settings are loaded before startup tasks run
     ofLogNotice("VideoFeedbackManager") << "Using device path: " << devicePath;
     auto devices_v4l2 = V4L2Helper::listDevices(); 
     ofLogNotice("VideoFeedbackManager") << "Found " << devices_v4l2.size() << " video devices (V4L2):";
@@ -420,7 +1304,6 @@ void VideoFeedbackManager::setupCamera(int width, int height) {
     }
     #endif
     videoDevices = camera.listDevices(); 
-    camera.setDesiredFrameRate(30);
     int deviceId = 0; if (paramManager) { deviceId = paramManager->getVideoDeviceID(); }
     
     bool validDevice = false;
@@ -428,34 +1311,52 @@ void VideoFeedbackManager::setupCamera(int width, int height) {
         for(const auto& dev : videoDevices) { if(dev.id == deviceId) { validDevice = true; break; } }
         if (!validDevice) { 
             deviceId = videoDevices[0].id; 
-            if(paramManager) paramManager->setVideoDeviceID(deviceId); 
         }
     } else {
         deviceId = -1; // No devices found
-         if(paramManager) paramManager->setVideoDeviceID(deviceId);
     }
+    probedDeviceId = deviceId;
+    probedWidth = width;
+    probedHeight = height;
+}
 
-    if (deviceId != -1) {
-        camera.setDeviceID(deviceId);
-        ofLogNotice("VideoFeedbackManager") << "Setting camera device ID to: " << deviceId;
-        camera.setUseTexture(true);
-        cameraInitialized = camera.setup(width, height); 
-    } else {
-         cameraInitialized = false;
+bool VideoFeedbackManager::openCamera() {
+    // Worker thread: opening the grabber is the slow part. Without a texture it needs no GL;
+    // attachCamera() turns the texture back on and update() allocates it on the render thread.
+    cameraOpened = false;
+    if (probedDeviceId == -1) {
+        return false;
     }
+    camera.setDeviceID(probedDeviceId);
+    camera.setDesiredFrameRate(30);
+    ofLogNotice("VideoFeedbackManager") << "Setting camera device ID to: " << probedDeviceId;
+    camera.setUseTexture(false);
+    cameraOpened = camera.setup(probedWidth, probedHeight);
+    if (!cameraOpened) {
+        camera.setUseTexture(true); // attachCamera() is skipped, and a later selectVideoDevice() needs it
+    }
+    return cameraOpened;
+}
+
+void VideoFeedbackManager::attachCamera() {
+    if (paramManager) { paramManager->setVideoDeviceID(probedDeviceId); }
+    camera.setUseTexture(true);
+    cameraInitialized = cameraOpened;
 
     if (!cameraInitialized) {
-        ofLogWarning("VideoFeedbackManager") << "Camera initialization failed. Creating fallback pattern.";
-        ofImage fallbackImg; fallbackImg.allocate(width, height, OF_IMAGE_COLOR);
-        int squareSize = 40; ofPixels& pixels = fallbackImg.getPixels();
-        for (int y = 0; y < height; y++) { for (int x = 0; x < width; x++) { bool isEvenRow = ((y / squareSize) % 2) == 0; bool isEvenCol = ((x / squareSize) % 2) == 0; if (isEvenRow == isEvenCol) { pixels.setColor(x, y, ofColor(80, 10, 100)); } else { pixels.setColor(x, y, ofColor(10, 80, 100)); } if ((x > width/2 - 2 && x < width/2 + 2) || (y > height/2 - 2 && y < height/2 + 2)) { pixels.setColor(x, y, ofColor(255, 0, 0)); } } }
-        fallbackImg.update();
-        if(aspectRatioFbo.isAllocated()) { aspectRatioFbo.begin(); ofClear(0, 0, 0, 255); fallbackImg.draw(0, 0, aspectRatioFbo.getWidth(), aspectRatioFbo.getHeight()); aspectRatioFbo.end(); }
+        ofLogWarning("VideoFeedbackManager") << "Camera initialization failed. Using fallback pattern.";
+        if(isAllocated(aspectRatioFbo)) { aspectRatioFbo->begin(); ofClear(0, 0, 0, 255); fallbackImage.draw(0, 0, aspectRatioFbo->getWidth(), aspectRatioFbo->getHeight()); aspectRatioFbo->end(); }
     } else {
         if (paramManager) { paramManager->setVideoWidth(camera.getWidth()); paramManager->setVideoHeight(camera.getHeight()); }
+        if (memory) {
+            // Grabber texture and pixels, RGB
+            size_t bytes = MemoryTracker::getTextureBytes(camera.getWidth(), camera.getHeight(), GL_RGB);
+            memory->track("input.camera", "input", MemoryTracker::GPU, bytes);
+            memory->track("input.cameraPixels", "input", MemoryTracker::CPU, bytes);
+        }
         // Store the index corresponding to the successfully initialized device ID
         for(int i=0; i<videoDevices.size(); ++i) {
-            if(videoDevices[i].id == deviceId) {
+            if(videoDevices[i].id == probedDeviceId) {
                 currentVideoDeviceIndex = i;
                 break;
             }
@@ -463,34 +1364,66 @@ void VideoFeedbackManager::setupCamera(int width, int height) {
     }
 }
 
+void VideoFeedbackManager::createFallbackPattern(int width, int height) {
+    fallbackImage.allocate(width, height, OF_IMAGE_COLOR);
+    int squareSize = 40; ofPixels& pixels = fallbackImage.getPixels();
+    for (int y = 0; y < height; y++) { for (int x = 0; x < width; x++) { bool isEvenRow = ((y / squareSize) % 2) == 0; bool isEvenCol = ((x / squareSize) % 2) == 0; if (isEvenRow == isEvenCol) { pixels.setColor(x, y, ofColor(80, 10, 100)); } else { pixels.setColor(x, y, ofColor(10, 80, 100)); } if ((x > width/2 - 2 && x < width/2 + 2) || (y > height/2 - 2 && y < height/2 + 2)) { pixels.setColor(x, y, ofColor(255, 0, 0)); } } }
+    fallbackImage.update();
+    if (memory) {
+        size_t bytes = MemoryTracker::getTextureBytes(width, height, GL_RGB);
+        memory->track("video.fallback", "video", MemoryTracker::GPU, bytes);
+        memory->track("video.fallbackPixels", "video", MemoryTracker::CPU, bytes);
+    }
+}
+
+void VideoFeedbackManager::present(const ofTexture& output) {
+    // The upscaler is the present pass itself: no extra target, same full-screen draw
+    upscaleActive = upscaler == UPSCALE_LANCZOS && shaderManager && shaderManager->getUpscaleShader().isLoaded() &&
+                    (output.getWidth() < ofGetWidth() || output.getHeight() < ofGetHeight());
+    if (upscaleActive) {
+        ofShader& upscaleShader = shaderManager->getUpscaleShader();
+        upscaleShader.begin();
+        upscaleShader.setUniform2f("sourceSize", output.getWidth(), output.getHeight());
+        upscaleShader.setUniform1f("sharpness", upscaleSharpness);
+        output.draw(0, 0, ofGetWidth(), ofGetHeight());
+        upscaleShader.end();
+    } else {
+        output.draw(0, 0, ofGetWidth(), ofGetHeight());
+    }
+}
+
+void VideoFeedbackManager::drawFallback() {
+    fallbackImage.draw(0, 0, ofGetWidth(), ofGetHeight());
+}
+
 // Removed updateCamera() method. Camera updates are handled in ofApp. // Re-adding updateCamera
 void VideoFeedbackManager::updateCamera() {
     if (cameraInitialized) {
         try {
             camera.update();
             if (camera.isFrameNew()) {
-                if(aspectRatioFbo.isAllocated()) {
-                    aspectRatioFbo.begin();
+                if(isAllocated(aspectRatioFbo)) {
+                    aspectRatioFbo->begin();
                     ofClear(0, 0, 0, 255);
                     int camWidth = camera.getWidth(); int camHeight = camera.getHeight();
                     if (camWidth > 0 && camHeight > 0) {
                         if (hdmiAspectRatioEnabled) { 
                              float targetAspect = 16.0f / 9.0f;
-                             float fboAspect = (float)aspectRatioFbo.getWidth() / aspectRatioFbo.getHeight();
+                             float fboAspect = (float)aspectRatioFbo->getWidth() / aspectRatioFbo->getHeight();
                              float drawWidth, drawHeight, xOffset, yOffset;
                              if (fboAspect > targetAspect) { 
-                                 drawHeight = aspectRatioFbo.getHeight(); drawWidth = drawHeight * targetAspect;
-                                 xOffset = (aspectRatioFbo.getWidth() - drawWidth) / 2.0f; yOffset = 0;
+                                 drawHeight = aspectRatioFbo->getHeight(); drawWidth = drawHeight * targetAspect;
+                                 xOffset = (aspectRatioFbo->getWidth() - drawWidth) / 2.0f; yOffset = 0;
                              } else { 
-                                 drawWidth = aspectRatioFbo.getWidth(); drawHeight = drawWidth / targetAspect;
-                                 xOffset = 0; yOffset = (aspectRatioFbo.getHeight() - drawHeight) / 2.0f;
+                                 drawWidth = aspectRatioFbo->getWidth(); drawHeight = drawWidth / targetAspect;
+                                 xOffset = 0; yOffset = (aspectRatioFbo->getHeight() - drawHeight) / 2.0f;
                              }
                              camera.draw(xOffset, yOffset, drawWidth, drawHeight);
                         } else {
-                            camera.draw(0, 0, aspectRatioFbo.getWidth(), aspectRatioFbo.getHeight());
+                            camera.draw(0, 0, aspectRatioFbo->getWidth(), aspectRatioFbo->getHeight());
                         }
                     }
-                    aspectRatioFbo.end();
+                    aspectRatioFbo->end();
                 }
             }
         } catch (std::exception& e) {
@@ -515,22 +1448,44 @@ void VideoFeedbackManager::setFrameBufferLength(int length) {
         ofLogWarning("VideoFeedbackManager") << "Invalid frame buffer length requested: " << length;
         return;
     }
-    if (pastFrames) delete[] pastFrames;
-    if (pastFramesAllocated) delete[] pastFramesAllocated;
+    if (memory && memory->getPolicy() == MemoryTracker::POLICY_DEGRADE) {
+        size_t available = memory->getAvailable(MemoryTracker::GPU, "video.pastFrame.");
+        size_t frameBytes = MemoryTracker::getFboBytes(fboSettings);
+        if (available != SIZE_MAX && frameBytes > 0 && (size_t)length * frameBytes > available) {
+            int affordable = std::max(2, (int)(available / frameBytes));
+            ofLogWarning("VideoFeedbackManager") << "GPU budget: delay buffer limited to " << affordable
+                                                 << " of the requested " << length << " frames";
+            length = affordable;
+        }
+    }
+    resizeFrameRing(length);
+    for (int i = 0; i < std::min(5, frameBufferLength); i++) {
+        allocatePastFrameIfNeeded(i);
+    }
+}
 
+void VideoFeedbackManager::resizeFrameRing(int length) {
+    // Slots past the new length go back to the pool; the rest are kept and cleared
+    for (int i = length; i < (int)pastFrames.size(); i++) {
+        if (pastFrames[i]) {
+            getRenderTargetPool().release(pastFrames[i]);
+            if (memory) memory->release("video.pastFrame." + ofToString(i));
+        }
+    }
+    pastFrames.resize(length);
+    frameTimes.assign(length, 0); // Cleared frames have no age
     frameBufferLength = length;
-    pastFrames = new ofFbo[frameBufferLength];
-    pastFramesAllocated = new bool[frameBufferLength];
-    for (int i = 0; i < frameBufferLength; i++) pastFramesAllocated[i] = false;
+    resetCpuHistory();
+    for (auto& frame : pastFrames) {
+        if (isAllocated(frame)) { frame->begin(); ofClear(0, 0, 0, 255); frame->end(); }
+    }
     
     // Re-allocate essential FBOs if dimensions might have changed implicitly
     // allocateFbos(width, height); // Consider if needed
     
-    for (int i = 0; i < std::min(5, frameBufferLength); i++) {
-        allocatePastFrameIfNeeded(i);
-    }
     currentFrameIndex = 0; 
     frameCount = 0;
+    restartHistoryWarmup();
     ofLogNotice("VideoFeedbackManager") << "Frame buffer length set to: " << frameBufferLength;
 }
 
@@ -539,8 +1494,10 @@ bool VideoFeedbackManager::isHdmiAspectRatioEnabled() const { return hdmiAspectR
 void VideoFeedbackManager::setHdmiAspectRatioEnabled(bool enabled) { hdmiAspectRatioEnabled = enabled; }
 
 const ofTexture& VideoFeedbackManager::getOutputTexture() const {
-    if (sharpenFbo.isAllocated()) {
-        return sharpenFbo.getTexture();
+    if (backend == BACKEND_CPU && cpuOutputTexture.isAllocated()) {
+        return cpuOutputTexture;
+    } else if (isAllocated(compositeFbo)) {
+        return compositeFbo->getTexture();
     } else {
         // Return a reference to an empty texture or handle error
         static ofTexture dummy; 
@@ -575,6 +1532,19 @@ void VideoFeedbackManager::saveToXml(ofxXmlSettings& xml) const {
     // Save framebuffer settings (Device settings removed from here, saved in ParamManager)
     xml.setValue("frameBufferLength", frameBufferLength);
     xml.setValue("hdmiAspectRatioEnabled", hdmiAspectRatioEnabled ? 1 : 0);
+    xml.setValue("historyWarmup", getHistoryWarmupName(historyWarmup));
+    xml.setValue("warmupSlotsPerFrame", warmupSlotsPerFrame);
+    xml.setValue("hdr", getHdrModeName(hdrMode));
+    xml.setValue("hdrHistory", hdrHistory ? 1 : 0);
+    xml.setValue("feedbackMipmaps", feedbackMipmaps ? 1 : 0);
+    xml.setValue("loopScale", loopScale);
+    xml.setValue("mixerQuality", getMixerQualityName(mixerQuality));
+    xml.setValue("upscaler", getUpscalerName(upscaler));
+    xml.setValue("upscaleSharpness", upscaleSharpness);
+    xml.setValue("backend", getBackendName(backend));
+    xml.setValue("cpuThreads", cpuThreads);
+    xml.setValue("profilePasses", renderGraph.isFinishingPasses() ? 1 : 0);
+    saveEchoTapsToXml(xml);
     
     xml.popTag(); // pop videoFeedback
 }
@@ -595,6 +1565,21 @@ void VideoFeedbackManager::loadFromXml(ofxXmlSettings& xml) {
         bool aspectEnabled = xml.getValue("hdmiAspectRatioEnabled", 0) != 0;
         setHdmiAspectRatioEnabled(aspectEnabled);
         ofLogNotice("VideoFeedbackManager") << "HDMI aspect ratio " << (aspectEnabled ? "enabled" : "disabled");
+
+        warmupSlotsPerFrame = std::max(1, xml.getValue("warmupSlotsPerFrame", warmupSlotsPerFrame));
+        setHistoryWarmup(findHistoryWarmup(xml.getValue("historyWarmup", getHistoryWarmupName(historyWarmup))));
+        loadEchoTapsFromXml(xml);
+        // Together, so a load reallocates the targets at most once
+        configureTargets(findHdrMode(xml.getValue("hdr", getHdrModeName(hdrMode))),
+                         xml.getValue("hdrHistory", hdrHistory ? 1 : 0) != 0,
+                         xml.getValue("loopScale", loopScale));
+        setMixerQuality(findMixerQuality(xml.getValue("mixerQuality", getMixerQualityName(mixerQuality))));
+        setUpscaler(findUpscaler(xml.getValue("upscaler", getUpscalerName(upscaler))));
+        setUpscaleSharpness(xml.getValue("upscaleSharpness", upscaleSharpness));
+        setFeedbackMipmapsEnabled(xml.getValue("feedbackMipmaps", feedbackMipmaps ? 1 : 0) != 0);
+        setCpuThreads(xml.getValue("cpuThreads", cpuThreads));
+        renderGraph.setFinishPasses(xml.getValue("profilePasses", renderGraph.isFinishingPasses() ? 1 : 0) != 0);
+        setBackend(findBackend(xml.getValue("backend", getBackendName(backend))));
         
         xml.popTag(); // pop videoFeedback
     } else {
@@ -3,6 +3,11 @@
 #include "ofMain.h"
 #include "ParameterManager.h"
 #include "ShaderManager.h"
+#include "MemoryTracker.h"
+#include "RenderTargetPool.h"
+#include "TextureHelper.h"
+#include "CpuFeedbackRenderer.h"
+#include "RenderGraph.h"
 
 /**
  * @class VideoFeedbackManager
@@ -13,11 +18,65 @@
  */
 class VideoFeedbackManager {
 public:
+    // How the delay-ring slots not yet touched by the pipeline get allocated
+    enum HistoryWarmup {
+        WARMUP_EAGER = 0, // A few slots every frame until the ring is full
+        WARMUP_LAZY,      // Only when the pipeline first uses a slot
+        WARMUP_BUDGETED   // A few slots on frames with time to spare, leaving budget headroom
+    };
+
+    // Float formats for the processing FBOs, so long feedback chains with small gains don't band
+    enum HdrMode {
+        HDR_OFF = 0,   // GL_RGBA8 everywhere
+        HDR_HALF,      // GL_RGBA16F
+        HDR_PACKED     // GL_R11F_G11F_B10F, half the memory of RGBA16F, no alpha
+    };
+
+    // Where the mixer and sharpen passes run
+    enum Backend {
+        BACKEND_GPU = 0, // The shaders
+        BACKEND_CPU      // CpuFeedbackRenderer, for when the GL driver can't run them
+    };
+
+    // How many pixels the GPU mixer shades per frame
+    enum MixerQuality {
+        MIXER_FULL = 0,     // All of them
+        MIXER_CHECKERBOARD  // Half, alternating; the rest come from the last frame
+    };
+
+    // How draw() scales the output up to the window
+    enum Upscaler {
+        UPSCALE_BILINEAR = 0, // Plain texture filtering
+        UPSCALE_LANCZOS       // Lanczos-2 with deringing and adaptive sharpening, in the same draw
+    };
+
+    // Extra reads from the delay ring, each with its own transform, added to the feedback signal
+    struct EchoTap {
+        bool enabled = false;
+        float delayFrames = 10.0f; // Whole frames; one texture fetch per tap
+        float gain = 0.5f;
+        float zoom = 1.0f;
+        float rotate = 0.0f;       // Radians
+        float xOffset = 0.0f;
+        float yOffset = 0.0f;
+        float hueShift = 0.0f;     // Turns, 0..1
+    };
+    // Samplers left on GLES2 (8 units) after tex0, fb, fbOlder and temporalFilter
+    static constexpr int MAX_ECHO_TAPS = 4;
+
     VideoFeedbackManager(ParameterManager* paramManager, ShaderManager* shaderManager);
     ~VideoFeedbackManager(); // Explicitly declare the destructor
     
     // Core methods
     void setup(int width, int height); // Setup FBOs and initial state
+    void setMemoryTracker(MemoryTracker* memory) { this->memory = memory; } // Before setup()
+    void setRenderTargetPool(RenderTargetPool* pool) { this->pool = pool; } // Before setup(); otherwise a private pool
+    
+    // Camera startup in three steps so the slow ones can run off the render thread
+    void probeCamera(int width, int height); // Worker: V4L2 formats and device list
+    bool openCamera();                       // Worker: open the grabber without a texture; false if it didn't open
+    void attachCamera();                     // Render thread: enable the texture and publish the result
+    void drawFallback();                     // Test pattern while inputs are starting
     // void update(const ofTexture& inputTexture); // Removed - Use processInputTexture instead
     void draw(); // Draw the final output
     
@@ -62,41 +121,146 @@ public:
     bool isCameraInitialized() const { return cameraInitialized; }
 
     // Lazy allocation for frame buffers (Keep this internal detail)
-    void allocatePastFrameIfNeeded(int index) {
-        if (index >= 0 && index < frameBufferLength && !pastFramesAllocated[index]) {
-            pastFrames[index].allocate(fboSettings);
-            pastFrames[index].begin();
-            ofClear(0, 0, 0, 255);
-            pastFrames[index].end();
-            pastFramesAllocated[index] = true;
-        }
-    }
+    void allocatePastFrameIfNeeded(int index);
+
+    EchoTap& getEchoTap(int index) { return echoTaps[std::max(0, std::min(index, MAX_ECHO_TAPS - 1))]; }
+    const EchoTap& getEchoTap(int index) const { return echoTaps[std::max(0, std::min(index, MAX_ECHO_TAPS - 1))]; }
+    int getActiveEchoTaps() const;
+
+    // HDR processing; changing either reallocates the FBOs. Falls back to 8-bit without float render targets
+    HdrMode getHdrMode() const { return hdrMode; }
+    void setHdrMode(HdrMode mode);
+    bool isHdrHistoryEnabled() const { return hdrHistory; }
+    void setHdrHistoryEnabled(bool enabled); // History slots in the float format too (2x or 1x memory)
+    GLint getPipelineFormat() const { return pipelineSettings.internalformat; } // What was actually allocated
+    static std::string getHdrModeName(HdrMode mode);
+    static HdrMode findHdrMode(const std::string& name); // HDR_OFF if unknown
+
+    // Mipmapped copy of the feedback tap, so zooming out filters instead of aliasing
+    bool isFeedbackMipmapsEnabled() const { return feedbackMipmaps; }
+    void setFeedbackMipmapsEnabled(bool enabled);
+    bool isFeedbackMipmapActive() const { return feedbackMipmapActive; } // Used on the last frame
+
+    // Split resolution: the feedback loop (mixer, sharpen, history) runs at a fraction of the output
+    // size and a full-size composite puts the live input back on top; changing it reallocates the FBOs
+    float getLoopScale() const { return loopScale; }
+    void setLoopScale(float scale); // 0.25 to 1; 1 = everything at output resolution
+    bool isSplitResolution() const { return loopScale < 1.0f; }
+
+    // Quality tier for fill-rate-limited GPUs; the CPU backend always shades every pixel
+    MixerQuality getMixerQuality() const { return mixerQuality; }
+    void setMixerQuality(MixerQuality quality);
+    bool isCheckerboardActive() const { return checkerboardActive; } // Used on the last frame
+    static std::string getMixerQualityName(MixerQuality quality);
+    static MixerQuality findMixerQuality(const std::string& name); // MIXER_FULL if unknown
+
+    // Only applies while the output is smaller than the window, e.g. in performance mode
+    Upscaler getUpscaler() const { return upscaler; }
+    void setUpscaler(Upscaler upscaler) { this->upscaler = upscaler; }
+    float getUpscaleSharpness() const { return upscaleSharpness; }
+    void setUpscaleSharpness(float sharpness) { upscaleSharpness = ofClamp(sharpness, 0.0f, 1.0f); }
+    bool isUpscaleActive() const { return upscaleActive; } // Used on the last draw()
+    static std::string getUpscalerName(Upscaler upscaler);
+    static Upscaler findUpscaler(const std::string& name); // UPSCALE_BILINEAR if unknown
+
+    // Switching starts the new backend with an empty delay ring
+    Backend getBackend() const { return backend; }
+    void setBackend(Backend backend);
+    void setCpuThreads(int threads); // 0 = one per core; takes effect when the renderer is next created
+    float getCpuRenderMs() const { return cpuRenderMs; } // Last CPU frame, mixer and sharpen
+    void validateCpuRenderer(); // Render the next GPU frame on the CPU too and log the difference
+    static std::string getBackendName(Backend backend);
+    static Backend findBackend(const std::string& name); // BACKEND_GPU if unknown
+
+    // Render-to-texture bandwidth of each available format at the current size, logged
+    void benchmarkFormats(int passes = 60);
+
+    // Background allocation of the rest of the delay ring, once per frame after startup
+    void warmUpHistory();
+    void setFrameWorkMicros(uint64_t micros) { frameWorkMicros = micros; } // Last frame's update() + draw(), without the limiter's wait
+    int getReadyHistorySlots() const; // Allocated delay-ring slots
+    HistoryWarmup getHistoryWarmup() const { return historyWarmup; }
+    void setHistoryWarmup(HistoryWarmup warmup);
+    static std::string getHistoryWarmupName(HistoryWarmup warmup);
+    static HistoryWarmup findHistoryWarmup(const std::string& name); // WARMUP_BUDGETED if unknown
     
     // XML settings (Keep for buffer length, aspect ratio, etc.)
     void saveToXml(ofxXmlSettings& xml) const; 
     void loadFromXml(ofxXmlSettings& xml);
     
-    // Add back getter for aspectRatioFbo
-    ofFbo& getAspectRatioFbo() { return aspectRatioFbo; }
+    // Add back getter for aspectRatioFbo (valid after setup())
+    ofFbo& getAspectRatioFbo() { return *aspectRatioFbo; }
     
+    // Size of the feedback loop's targets, after performance scaling, the loop scale and the memory budget
+    int getProcessingWidth() const { return pipelineSettings.width; }
+    int getProcessingHeight() const { return pipelineSettings.height; }
+    // Size of the output, and of the input as the composite sees it
+    int getOutputWidth() const { return outputSettings.width; }
+    int getOutputHeight() const { return outputSettings.height; }
+
+    // Passes that ran last frame and their cost; setFinishPasses() on it for GPU-inclusive timings
+    RenderGraph& getRenderGraph() { return renderGraph; }
+    const RenderGraph& getRenderGraph() const { return renderGraph; }
+
     // Accessors for internal FBOs (might still be useful for debugging or advanced effects)
-    ofFbo& getMainFbo() { return mainFbo; } 
-    ofFbo& getSharpenFbo() { return sharpenFbo; }
-    ofFbo& getDryFrameBuffer() { return dryFrameBuffer; }
     ofFbo& getPastFrame(int index) {
-        if (index >= 0 && index < frameBufferLength) {
-            return pastFrames[index];
+        if (index >= 0 && index < frameBufferLength && pastFrames[index]) {
+            return *pastFrames[index];
         }
-        return dryFrameBuffer; // Fallback to avoid crashes
+        static ofFbo empty; // Fallback to avoid crashes
+        return empty;
     }
         
 private:
     // Constants
     static const int DEFAULT_FRAME_BUFFER_LENGTH = 60;
     
+    // A read from the delay ring: two adjacent slots and how far to blend from the first to the second
+    struct DelayTap {
+        int index = 0;
+        int olderIndex = 0;
+        float fraction = 0.0f;
+    };
+
+    // A GPU frame's sources, read back for validateCpuRenderer()
+    struct CpuValidation {
+        ofPixels input;
+        ofPixels fb;
+        ofPixels fbOlder;
+        ofPixels temporalFilter;
+        ofPixels echoTaps[MAX_ECHO_TAPS];
+    };
+
     // Helper methods
+    DelayTap getDelayTap() const; // From the effective delayAmount, or the frame timestamps in milliseconds mode
+    void setEchoTapUniforms(ofShader& mixerShader, const ofTexture& idleTexture); // Units 4.. and the per-tap arrays
+    int getEchoTapSlot(int tap) const; // Delay-ring slot the tap reads this frame
+    void processCpuPipeline(const ofTexture& inputTexture, const DelayTap& delayTap);
+    CpuFeedbackRenderer& getCpuRenderer(); // Created on first use, so the GPU backend starts no threads
+    CpuFeedbackRenderer::Uniforms makeCpuUniforms(const DelayTap& delayTap) const; // Same values the shaders get
+    void readInputToPixels(const ofTexture& inputTexture, ofPixels& pixels); // Stretched to the pipeline size, via a pooled FBO
+    std::unique_ptr<CpuValidation> captureCpuValidation(const ofTexture& inputTexture, const DelayTap& delayTap);
+    void finishCpuValidation(const CpuValidation& validation, const DelayTap& delayTap); // After the sharpen pass
+    void resetCpuHistory(); // Empty ring of the current length; frees it on the GPU backend
+    void present(const ofTexture& output); // To the window, through the upscaler when it's bigger
+    void loadEchoTapsFromXml(ofxXmlSettings& xml);
+    void saveEchoTapsToXml(ofxXmlSettings& xml) const;
     void listVideoDevices(); // Add back declaration
-    void setupCamera(int width, int height); // Add back declaration
+    void createFallbackPattern(int width, int height);
+    void fitToMemoryBudget(ofFboSettings& settings, const ofFboSettings& inputSettings, GLint hdrFormat); // POLICY_DEGRADE: fewer delay frames, then lower resolution
+    size_t estimateFixedGpuBytes(const ofFboSettings& loopSettings, const ofFboSettings& inputSettings, GLint hdrFormat) const; // Every target but the delay ring
+    GLint resolveHdrFormat(); // Render thread; GL_RGBA8 when HDR is off or unsupported
+    void configureTargets(HdrMode mode, bool history, float scale); // Reallocates once if any of them changed
+    bool needsFeedbackMipmaps(const float* params) const; // Enabled, supported and zooming out
+    void prepareMipmappedTap(const DelayTap& tap); // Copy (and blend) the tap, then build its mip chain
+    void releaseFeedbackMipFbo();
+    void resizeFrameRing(int length); // Reallocate the delay ring, no budget check
+    RenderTargetPool& getRenderTargetPool();
+    std::shared_ptr<ofFbo> acquireClearedFbo(const ofFboSettings& settings);
+    void releaseRenderTargets(); // Everything back to the pool before reallocating
+    void restartHistoryWarmup(); // After the ring was resized or reallocated
+    bool hasSpareFrameTime() const;
+    static bool isAllocated(const std::shared_ptr<ofFbo>& fbo) { return fbo && fbo->isAllocated(); }
     // void incrementFrameIndex(); // Moved to public
     // void processMainPipeline(const ofTexture& inputTexture); // Moved to public
     void checkGLError(const std::string& operation);
@@ -118,25 +282,77 @@ private:
     // Reference to managers
     ParameterManager* paramManager;
     ShaderManager* shaderManager;
+    MemoryTracker* memory = nullptr;
+    RenderTargetPool* pool = nullptr;
+    std::unique_ptr<RenderTargetPool> ownedPool; // When the app didn't provide one
     
     // Resolution
     int width = 640;
     int height = 480;
     bool hdmiAspectRatioEnabled = false;
     
-    // Framebuffers
-    ofFbo mainFbo;              // Main processing buffer
-    ofFbo sharpenFbo;           // Buffer for sharpen effect
-    ofFbo dryFrameBuffer;       // Buffer for dry mode
-    ofFbo aspectRatioFbo;       // Buffer for aspect ratio correction
+    // Framebuffers, from the render target pool
+    RenderGraph renderGraph;                // Mixer and sharpen targets, per frame
+    std::shared_ptr<ofFbo> sharpenFbo;      // Last frame's loop output: retained by the graph, or the history slot it went into
+    std::shared_ptr<ofFbo> compositeFbo;    // Last frame's full-size output in split resolution, else sharpenFbo
+    std::shared_ptr<ofFbo> aspectRatioFbo;  // Buffer for aspect ratio correction
     
     // FBO settings storage for reuse
-    ofFboSettings fboSettings;  // Store settings for reuse in lazy allocation
+    ofFboSettings fboSettings;  // Store settings for reuse in lazy allocation (history slots)
+    ofFboSettings pipelineSettings; // Mixer and sharpen targets, in the HDR format when enabled
+    ofFboSettings outputSettings;   // The composite and the camera input, before the loop scale
+    float loopScale = 1.0f;
+
+    HdrMode hdrMode = HDR_OFF;
+    bool hdrHistory = false;
+    std::map<int, GLint> hdrFormatCache; // HdrMode -> probed format, GL doesn't change under us
+
+    // One mipmapped target regardless of ring length; history slots never carry mip levels
+    bool feedbackMipmaps = false;
+    int feedbackMipmapSupport = -1; // -1 = not probed yet
+    bool feedbackMipmapActive = false;
+    std::shared_ptr<ofFbo> feedbackMipFbo;
+
+    // Checkerboard tier: the phase flips every frame; last frame's mixer output is retained by the graph
+    MixerQuality mixerQuality = MIXER_FULL;
+    bool checkerboardActive = false;
+    float checkerboardPhase = 0.0f;
+    std::shared_ptr<ofFbo> checkerboardHistory;
+
+    Upscaler upscaler = UPSCALE_LANCZOS;
+    float upscaleSharpness = 0.5f;
+    bool upscaleActive = false;
+
+    // CPU backend: its own delay ring in system memory, output uploaded for draw()
+    Backend backend = BACKEND_GPU;
+    int cpuThreads = 0;
+    std::unique_ptr<CpuFeedbackRenderer> cpuRenderer;
+    std::vector<ofPixels> cpuFrames; // Empty until stored; reads as black
+    ofPixels cpuDryFrame;
+    ofPixels cpuInput;
+    ofPixels cpuMixed;
+    ofPixels cpuOutput;
+    ofTexture cpuOutputTexture; // Not pooled: it's flagged to draw flipped like an FBO texture
+    float cpuRenderMs = 0.0f;
+    bool cpuValidationPending = false;
     
     // Circular buffer for delay effect
     int frameBufferLength = DEFAULT_FRAME_BUFFER_LENGTH;
-    ofFbo* pastFrames = nullptr;
-    bool* pastFramesAllocated = nullptr; // Track which frames are allocated
+    std::vector<std::shared_ptr<ofFbo>> pastFrames; // Null until first used
+    std::vector<uint64_t> frameTimes;               // Micros when each slot was last stored, 0 = never
+    EchoTap echoTaps[MAX_ECHO_TAPS];
+
+    // History warm-up: slots are visited once per restart, starting at the next one to be written
+    HistoryWarmup historyWarmup = WARMUP_BUDGETED;
+#if defined(TARGET_LINUX) && (defined(__arm__) || defined(__aarch64__))
+    int warmupSlotsPerFrame = 1;
+#else
+    int warmupSlotsPerFrame = 2;
+#endif
+    int warmupStart = 0;
+    int warmupVisited = 0;
+    bool warmupLogged = true; // Nothing to report before the first restart
+    uint64_t frameWorkMicros = 0;
     
     // Thread synchronization
     std::mutex fboMutex;
@@ -151,4 +367,11 @@ private:
     bool cameraInitialized = false;
     std::vector<ofVideoDevice> videoDevices;
     int currentVideoDeviceIndex = -1;
+    ofImage fallbackImage;
+
+    // Results of probeCamera()/openCamera(), published by attachCamera()
+    int probedDeviceId = -1;
+    int probedWidth = 640;
+    int probedHeight = 480;
+    bool cameraOpened = false;
 };
@@ -26,9 +26,36 @@ void ofApp::setup() {
     ofBackground(0);
     ofHideCursor();
 
+    startup = std::make_unique<StartupGraph>();
+    memory = std::make_unique<MemoryTracker>();
+    renderTargets = std::make_unique<RenderTargetPool>(memory.get());
+
+    // Parse settings.xml once; every manager reads its section from this document
+    settings = std::make_unique<SettingsStore>(ofToDataPath("settings.xml"));
+    bool resetNeeded = !settings->load();
+    if (!resetNeeded) {
+        ofxXmlSettings& doc = settings->getDocument();
+        if (doc.pushTag("paramManager")) {
+            if (doc.tagExists("paramManager")) {
+                resetNeeded = true;
+                ofLogWarning("ofApp") << "Nested paramManager tags detected, resetting settings file";
+            }
+            doc.popTag();
+        }
+    } else {
+        ofLogWarning("ofApp") << "Missing or unreadable settings.xml, resetting file";
+    }
+    if (resetNeeded) {
+        resetSettingsFile();
+    }
+    ofxXmlSettings& xml = settings->getDocument();
+
     // Initialize parameter manager first
-    paramManager = std::make_unique<ParameterManager>();
-    paramManager->setup(); // This now loads settings including mappings
+    startup->runNow("parameters", [&] {
+        paramManager = std::make_unique<ParameterManager>();
+        paramManager->setup();
+        paramManager->loadFromXml(xml);
+    });
 
     // Set performance mode based on platform
     if (platformIsRaspberryPi) {
@@ -40,64 +67,36 @@ void ofApp::setup() {
         // Don't set framerate here anymore
     }
 
-    // Check if settings file exists and validate structure (Keep this?)
-    ofFile settingsFile(ofToDataPath("settings.xml"));
-    bool resetNeeded = false;
-    if (settingsFile.exists()) {
-        ofxXmlSettings testXml;
-        if (testXml.loadFile(ofToDataPath("settings.xml"))) {
-            if (testXml.pushTag("paramManager")) {
-                if (testXml.tagExists("paramManager")) {
-                    resetNeeded = true;
-                    ofLogWarning("ofApp") << "Nested paramManager tags detected, resetting settings file";
-                }
-                testXml.popTag();
-            }
-        } else {
-            resetNeeded = true;
-            ofLogWarning("ofApp") << "Could not parse settings.xml, resetting file";
-        }
-    }
-    if (resetNeeded || !settingsFile.exists()) {
-        resetSettingsFile();
-        paramManager->loadSettings(); // Reload after reset
-    }
-
     // Load app-level settings first
-    ofxXmlSettings xml;
-    if (xml.loadFile(ofToDataPath("settings.xml"))) {
-        if (xml.tagExists("app")) {
-            xml.pushTag("app");
-            debugEnabled = xml.getValue("debugEnabled", false);
-            configWidth = xml.getValue("width", 1024);
-            configHeight = xml.getValue("height", 768);
-            // Framerate is now loaded via ParameterManager
-
-            // Load video input settings
-            std::string sourceStr = xml.getValue("videoInputSource", "CAMERA");
-            if (sourceStr == "NDI") {
-                currentInputSource = NDI;
-            } else if (sourceStr == "VIDEO_FILE") {
-                currentInputSource = VIDEO_FILE;
-            } else {
-                currentInputSource = CAMERA; // Default
-            }
-            videoFilePath = xml.getValue("videoFilePath", videoFilePath);
-            currentNdiSourceIndex = xml.getValue("ndiSourceIndex", 0); // Load NDI source index, default to 0
-            loadedNdiSourceName = xml.getValue("ndiSourceName", ""); // Load preferred NDI source name (assign to declared variable)
-            ofLogNotice("ofApp::setup") << "Initial video input source: " << sourceStr;
-            ofLogNotice("ofApp::setup") << "Video file path: " << videoFilePath;
-            ofLogNotice("ofApp::setup") << "Loaded NDI source index preference: " << currentNdiSourceIndex;
-            ofLogNotice("ofApp::setup") << "Loaded NDI source name preference: " << loadedNdiSourceName;
-
-
-            xml.popTag(); // pop app
+    if (xml.tagExists("app")) {
+        xml.pushTag("app");
+        debugEnabled = xml.getValue("debugEnabled", false);
+        configWidth = xml.getValue("width", 1024);
+        configHeight = xml.getValue("height", 768);
+        // Framerate is now loaded via ParameterManager
+
+        // Load video input settings
+        std::string sourceStr = xml.getValue("videoInputSource", "CAMERA");
+        if (sourceStr == "NDI") {
+            currentInputSource = NDI;
+        } else if (sourceStr == "VIDEO_FILE") {
+            currentInputSource = VIDEO_FILE;
         } else {
-             ofLogWarning("ofApp::setup") << "No <app> tag found in settings.xml, using default app settings.";
+            currentInputSource = CAMERA; // Default
         }
+        videoFilePath = xml.getValue("videoFilePath", videoFilePath);
+        currentNdiSourceIndex = xml.getValue("ndiSourceIndex", 0); // Load NDI source index, default to 0
+        loadedNdiSourceName = xml.getValue("ndiSourceName", ""); // Load preferred NDI source name (assign to declared variable)
+        memory->loadFromXml(xml); // Budgets must be known before the FBOs are allocated
+        renderTargets->loadFromXml(xml);
+        ofLogNotice("ofApp::setup") << "Initial video input source: " << sourceStr;
+        ofLogNotice("ofApp::setup") << "Video file path: " << videoFilePath;
+        ofLogNotice("ofApp::setup") << "Loaded NDI source index preference: " << currentNdiSourceIndex;
+        ofLogNotice("ofApp::setup") << "Loaded NDI source name preference: " << loadedNdiSourceName;
+
+        xml.popTag(); // pop app
     } else {
-         ofLogWarning("ofApp::setup") << "Could not load settings.xml, using default app settings.";
-         // Framerate default handled by ParameterManager or below
+         ofLogWarning("ofApp::setup") << "No <app> tag found in settings.xml, using default app settings.";
     }
 
     // --- Apply Final Framerate ---
@@ -126,111 +125,72 @@ void ofApp::setup() {
     ofHideCursor();
     ofDisableArbTex();
 
-    // Initialize shader manager
+    // Devices start on workers while the first frames show the fallback pattern; GL work
+    // (shaders, enabling the input textures) runs on the render thread from update()
     shaderManager = std::make_unique<ShaderManager>();
-    shaderManager->setup();
-
-    // Initialize video feedback manager (FBOs etc.)
-    videoManager = std::make_unique<VideoFeedbackManager>(paramManager.get(), shaderManager.get());
-    videoManager->setup(configWidth, configHeight);
-
-    // --- Setup Input Sources ---
-
-    // 1. Camera Setup (Now handled mostly within VideoFeedbackManager)
-    // cameraInitialized = videoManager->isCameraInitialized(); // Get status from videoManager
-
-    // 2. NDI Setup
-    // 2. NDI Setup
+    startup->runNow("fbos", [&] {
+        videoManager = std::make_unique<VideoFeedbackManager>(paramManager.get(), shaderManager.get());
+        videoManager->setMemoryTracker(memory.get());
+        videoManager->setRenderTargetPool(renderTargets.get());
+        videoManager->setup(configWidth, configHeight);
+
+        ndiTexture = renderTargets->acquireTexture(configWidth, configHeight, GL_RGBA);
+        memory->track("input.ndi", "input", MemoryTracker::GPU, MemoryTracker::getTextureBytes(configWidth, configHeight, GL_RGBA));
+        // Allocate the texture that holds the currently selected input for debug preview
+        currentInputTexture = renderTargets->acquireTexture(videoManager->getOutputWidth(), videoManager->getOutputHeight(), GL_RGBA);
+        memory->track("input.preview", "input", MemoryTracker::GPU,
+                      MemoryTracker::getTextureBytes(currentInputTexture->getWidth(), currentInputTexture->getHeight(), GL_RGBA));
+        ofLogNotice("ofApp::setup") << "Allocated currentInputTexture: " << currentInputTexture->getWidth() << "x" << currentInputTexture->getHeight();
+    });
+
+    startup->runNow("managers", [&] {
+        // MIDI devices are enumerated by the manager's own watcher thread
+        midiManager = std::make_unique<MidiManager>(paramManager.get());
+        midiManager->setup();
+
+        // Audio devices are listed by "audio.list" and opened by the "audio" task below
+        audioManager = std::make_unique<AudioReactivityManager>(paramManager.get());
+        audioManager->setup(paramManager.get(), performanceMode);
+
+        // Load remaining manager settings from the same document
+        loadManagerSettings(xml);
+
+        // Saves run on the settings worker; the writer gathers state on the render thread
+        settings->setWriter([this](ofxXmlSettings& doc) { writeSettings(doc); });
+        settings->start();
+    });
+
+    startup->add("shaders", StartupGraph::RENDER, [this] { shaderManager->setup(); });
+    startup->add("camera.probe", StartupGraph::WORKER, [this] { videoManager->probeCamera(configWidth, configHeight); });
+    startup->addChecked("camera.open", StartupGraph::WORKER, [this] { return videoManager->openCamera(); }, {"camera.probe"});
+    startup->add("camera", StartupGraph::RENDER, [this] { videoManager->attachCamera(); }, {"camera.open"});
     if (currentInputSource == NDI) {
-        int nSources = ndiReceiver.GetSenderCount(); // Populate internal list
-        ofLogNotice("ofApp::setup") << "Found " << nSources << " NDI sources.";
-        bool connected = false;
-
-        // Try connecting by preferred name first
-        if (!loadedNdiSourceName.empty() && nSources > 0) {
-            ofLogNotice("ofApp::setup") << "Attempting connection by preferred name: " << loadedNdiSourceName;
-            char currentNameBuffer[256];
-            for (int i = 0; i < nSources; ++i) {
-                ndiReceiver.GetSenderName(currentNameBuffer, sizeof(currentNameBuffer), i);
-                if (loadedNdiSourceName == std::string(currentNameBuffer)) {
-                    ofLogNotice("ofApp::setup") << "Found matching source at index " << i;
-                    if (ndiReceiver.CreateReceiver(i)) {
-                        ofLogNotice("ofApp::setup") << "Successfully connected to NDI source by name: " << loadedNdiSourceName << " (Index: " << i << ")";
-                        currentNdiSourceIndex = i; // Update index based on name match
-                        connected = true;
-                    } else {
-                        ofLogWarning("ofApp::setup") << "Failed to create NDI receiver for source: " << loadedNdiSourceName << " (Index: " << i << ")";
-                    }
-                    break; // Stop searching once found
-                }
-            }
-            if (!connected) {
-                 ofLogWarning("ofApp::setup") << "Preferred NDI source name '" << loadedNdiSourceName << "' not found.";
-            }
+        startup->add("ndi", StartupGraph::WORKER, [this, loadedNdiSourceName] { connectNdiSource(loadedNdiSourceName); });
+    }
+    startup->addChecked("video.load", StartupGraph::WORKER, [this] {
+        ofLogNotice("ofApp::setup") << "Setting up video player with file: " << videoFilePath;
+        videoPlayer.setUseTexture(false); // Texture is enabled on the render thread by "video"
+        bool loaded = videoPlayer.load(videoFilePath);
+        videoPlayer.setLoopState(OF_LOOP_NORMAL);
+        if (!loaded) {
+            videoPlayer.setUseTexture(true); // "video" is skipped; a file loaded later needs its texture
         }
-
-        // If not connected by name, try connecting by preferred index
-        if (!connected) {
-            ofLogNotice("ofApp::setup") << "Attempting connection by preferred index: " << currentNdiSourceIndex;
-            if (currentNdiSourceIndex >= 0 && currentNdiSourceIndex < nSources) {
-                 if (ndiReceiver.CreateReceiver(currentNdiSourceIndex)) {
-                     ofLogNotice("ofApp::setup") << "Successfully connected to NDI source by index: " << currentNdiSourceIndex << " (" << ndiReceiver.GetSenderName() << ")";
-                     connected = true;
-                 } else {
-                     ofLogWarning("ofApp::setup") << "Failed to create NDI receiver for source index " << currentNdiSourceIndex << ". Check if source is available.";
-                 }
-            } else {
-                 ofLogWarning("ofApp::setup") << "Preferred NDI source index " << currentNdiSourceIndex << " is out of range (0-" << nSources-1 << ").";
-            }
+        return loaded;
+    });
+    startup->add("video", StartupGraph::RENDER, [this] {
+        videoPlayer.setUseTexture(true);
+        if (videoPlayer.isLoaded()) {
+            size_t bytes = MemoryTracker::getTextureBytes(videoPlayer.getWidth(), videoPlayer.getHeight(), GL_RGB);
+            memory->track("input.videoFile", "input", MemoryTracker::GPU, bytes);
+            memory->track("input.videoFilePixels", "input", MemoryTracker::CPU, bytes);
         }
-
-        // If still not connected, log a warning
-        if (!connected) {
-             ofLogWarning("ofApp::setup") << "Could not connect to preferred NDI source by name or index.";
+        if (currentInputSource == VIDEO_FILE) {
+            videoPlayer.play();
         }
-    }
-    // Allocate texture regardless of initial connection success
-    ndiTexture.allocate(configWidth, configHeight, GL_RGBA);
-
-    // 3. Video Player Setup
-    ofLogNotice("ofApp::setup") << "Setting up video player with file: " << videoFilePath;
-    videoPlayer.load(videoFilePath);
-    videoPlayer.setLoopState(OF_LOOP_NORMAL);
-    if (currentInputSource == VIDEO_FILE) {
-        videoPlayer.play();
-    }
-
-    // Allocate the texture that holds the currently selected input for debug preview
-    currentInputTexture.allocate(videoManager->getMainFbo().getWidth(), videoManager->getMainFbo().getHeight(), GL_RGBA);
-    ofLogNotice("ofApp::setup") << "Allocated currentInputTexture: " << currentInputTexture.getWidth() << "x" << currentInputTexture.getHeight();
-
-    // Initialize MIDI manager
-    midiManager = std::make_unique<MidiManager>(paramManager.get());
-    midiManager->setup();
-
-    // Initialize Audio Reactivity manager
-    audioManager = std::make_unique<AudioReactivityManager>(paramManager.get());
-    // Pass paramManager and performanceMode to setup as required by the updated signature
-    audioManager->setup(paramManager.get(), performanceMode);
-
-    // Load remaining manager settings (VideoFeedbackManager) from XML
-    if (xml.loadFile(ofToDataPath("settings.xml"))) {
-         if (xml.pushTag("paramManager")) {
-             // Load VideoFeedbackManager settings if tag exists
-             if (xml.tagExists("videoFeedback")) {
-                 videoManager->loadFromXml(xml);
-             }
-             // Load AudioReactivityManager settings if tag exists
-             if (xml.tagExists("audioReactivity")) {
-                 audioManager->loadFromXml(xml);
-             }
-             // Load MidiManager settings if tag exists
-             if (xml.tagExists("midi")) {
-                 midiManager->loadSettings(xml);
-             }
-             xml.popTag(); // Pop paramManager
-         }
-    }
+    }, {"video.load"});
+    startup->add("audio.list", StartupGraph::WORKER, [this] { audioManager->listAudioDevices(); });
+    startup->add("audio", StartupGraph::RENDER, [this] { audioManager->startInput(); }, {"audio.list"});
+    startup->start();
 
     // Initialize performance monitoring
     for (int i = 0; i < 60; i++) {
@@ -246,7 +206,8 @@ void ofApp::setup() {
 // Removed ofApp::setupDefaultAudioMappings() - Logic moved to AudioReactivityManager::addDefaultMappings()
 
 void ofApp::resetSettingsFile() {
-    ofxXmlSettings xml;
+    ofxXmlSettings& xml = settings->getDocument();
+    xml.clear();
 
     xml.addTag("app");
     xml.pushTag("app");
@@ -265,24 +226,335 @@ void ofApp::resetSettingsFile() {
     xml.addTag("paramManager");
     // ParameterManager::saveToXml will populate this on next save
 
-    try {
-        bool saved = xml.saveFile(ofToDataPath("settings.xml"));
-        ofLogNotice("ofApp") << "Settings file reset " << (saved ? "successfully" : "unsuccessfully");
-    } catch (const std::exception& e) {
-        ofLogError("ofApp") << "Exception resetting settings: " << e.what();
+    settings->saveNow(); // Managers don't exist yet, so this writes the defaults as they are
+    ofLogNotice("ofApp") << "Settings file reset";
+}
+
+void ofApp::connectNdiSource(const std::string& preferredName) {
+    int nSources = ndiReceiver.GetSenderCount(); // Populate internal list
+    ofLogNotice("ofApp") << "Found " << nSources << " NDI sources.";
+    bool connected = false;
+
+    // Try connecting by preferred name first
+    if (!preferredName.empty() && nSources > 0) {
+        ofLogNotice("ofApp") << "Attempting connection by preferred name: " << preferredName;
+        char currentNameBuffer[256];
+        for (int i = 0; i < nSources; ++i) {
+            ndiReceiver.GetSenderName(currentNameBuffer, sizeof(currentNameBuffer), i);
+            if (preferredName == std::string(currentNameBuffer)) {
+                ofLogNotice("ofApp") << "Found matching source at index " << i;
+                if (ndiReceiver.CreateReceiver(i)) {
+                    ofLogNotice("ofApp") << "Successfully connected to NDI source by name: " << preferredName << " (Index: " << i << ")";
+                    currentNdiSourceIndex = i; // Update index based on name match
+                    connected = true;
+                } else {
+                    ofLogWarning("ofApp") << "Failed to create NDI receiver for source: " << preferredName << " (Index: " << i << ")";
+                }
+                break; // Stop searching once found
+            }
+        }
+        if (!connected) {
+             ofLogWarning("ofApp") << "Preferred NDI source name '" << preferredName << "' not found.";
+        }
+    }
+
+    // If not connected by name, try connecting by preferred index
+    if (!connected) {
+        ofLogNotice("ofApp") << "Attempting connection by preferred index: " << currentNdiSourceIndex;
+        if (currentNdiSourceIndex >= 0 && currentNdiSourceIndex < nSources) {
+             if (ndiReceiver.CreateReceiver(currentNdiSourceIndex)) {
+                 ofLogNotice("ofApp") << "Successfully connected to NDI source by index: " << currentNdiSourceIndex << " (" << ndiReceiver.GetSenderName() << ")";
+                 connected = true;
+             } else {
+                 ofLogWarning("ofApp") << "Failed to create NDI receiver for source index " << currentNdiSourceIndex << ". Check if source is available.";
+             }
+        } else {
+             ofLogWarning("ofApp") << "Preferred NDI source index " << currentNdiSourceIndex << " is out of range (0-" << nSources-1 << ").";
+        }
+    }
+
+    // If still not connected, log a warning
+    if (!connected) {
+         ofLogWarning("ofApp") << "Could not connect to preferred NDI source by name or index.";
+    }
+}
+
+bool ofApp::isInputReady() const {
+    if (!startup->isDone("shaders")) {
+        return false;
+    }
+    switch (currentInputSource) {
+        // A source whose startup failed counts once something opens it later
+        case CAMERA: return startup->isSettled("camera") && videoManager->isCameraInitialized();
+        case NDI: return startup->isDone("ndi");
+        case VIDEO_FILE: return startup->isSettled("video") && videoPlayer.isLoaded();
+    }
+    return true;
+}
+
+void ofApp::updateMemoryAccounting() {
+    float now = ofGetElapsedTimef();
+    if (now - lastMemoryUpdateTime < 1.0f) {
+        return;
+    }
+    lastMemoryUpdateTime = now;
+    memory->track("audio.buffers", "audio", MemoryTracker::CPU, audioManager->getMemoryBytes());
+    memory->track("midi.state", "midi", MemoryTracker::CPU, midiManager->getMemoryBytes());
+
+    if (!memoryReportLogged && startup->isFinished()) {
+        memoryReportLogged = true;
+        memory->logReport(); // Everything allocated at startup is accounted for by now
+        renderTargets->logStats();
+    }
+}
+
+bool ofApp::handleDelayOsc(const ofxOscMessage& m) {
+    if (m.getAddress() == "/delay/timeMs" && m.getNumArgs() >= 1) {
+        paramManager->setDelayTimeMs(m.getArgAsFloat(0)); // 0 switches back to delayAmount frames
+        return true;
     }
+
+    // /tap/<0-3>/<enabled|delay|gain|zoom|rotate|x|y|hue> <value>
+    std::vector<std::string> parts = ofSplitString(m.getAddress(), "/", true);
+    if (parts.size() != 3 || parts[0] != "tap" || m.getNumArgs() < 1) {
+        return false;
+    }
+    int index = ofToInt(parts[1]);
+    if (index < 0 || index >= VideoFeedbackManager::MAX_ECHO_TAPS) {
+        return false;
+    }
+    VideoFeedbackManager::EchoTap& tap = videoManager->getEchoTap(index);
+    float value = m.getArgType(0) == OFXOSC_TYPE_INT32 ? (float)m.getArgAsInt(0) : m.getArgAsFloat(0);
+    const std::string& field = parts[2];
+    if (field == "enabled") tap.enabled = value != 0.0f;
+    else if (field == "delay") tap.delayFrames = std::max(0.0f, value);
+    else if (field == "gain") tap.gain = value;
+    else if (field == "zoom") tap.zoom = value;
+    else if (field == "rotate") tap.rotate = value;
+    else if (field == "x") tap.xOffset = value;
+    else if (field == "y") tap.yOffset = value;
+    else if (field == "hue") tap.hueShift = value;
+    else return false;
+    return true;
+}
+
+bool ofApp::handleVideoOsc(const ofxOscMessage& m) {
+    const std::string& address = m.getAddress();
+    if (address == "/video/hdr" && m.getNumArgs() >= 1) {
+        // "off", "rgba16f", "r11g11b10f", or 0/1/2
+        VideoFeedbackManager::HdrMode mode = m.getArgType(0) == OFXOSC_TYPE_STRING
+            ? VideoFeedbackManager::findHdrMode(m.getArgAsString(0))
+            : (VideoFeedbackManager::HdrMode)ofClamp(m.getArgAsInt(0), 0, 2);
+        videoManager->setHdrMode(mode);
+    } else if (address == "/video/hdrHistory" && m.getNumArgs() >= 1) {
+        videoManager->setHdrHistoryEnabled(m.getArgAsInt(0) != 0);
+    } else if (address == "/video/mipmaps" && m.getNumArgs() >= 1) {
+        videoManager->setFeedbackMipmapsEnabled(m.getArgAsInt(0) != 0);
+    } else if (address == "/video/backend" && m.getNumArgs() >= 1) {
+        // "gpu", "cpu", or 0/1
+        VideoFeedbackManager::Backend backend = m.getArgType(0) == OFXOSC_TYPE_STRING
+            ? VideoFeedbackManager::findBackend(m.getArgAsString(0))
+            : (m.getArgAsInt(0) != 0 ? VideoFeedbackManager::BACKEND_CPU : VideoFeedbackManager::BACKEND_GPU);
+        videoManager->setBackend(backend);
+    } else if (address == "/video/mixerQuality" && m.getNumArgs() >= 1) {
+        // "full", "checkerboard", or 0/1
+        VideoFeedbackManager::MixerQuality quality = m.getArgType(0) == OFXOSC_TYPE_STRING
+            ? VideoFeedbackManager::findMixerQuality(m.getArgAsString(0))
+            : (m.getArgAsInt(0) != 0 ? VideoFeedbackManager::MIXER_CHECKERBOARD : VideoFeedbackManager::MIXER_FULL);
+        videoManager->setMixerQuality(quality);
+    } else if (address == "/video/upscaler" && m.getNumArgs() >= 1) {
+        // "bilinear", "lanczos", or 0/1
+        VideoFeedbackManager::Upscaler upscaler = m.getArgType(0) == OFXOSC_TYPE_STRING
+            ? VideoFeedbackManager::findUpscaler(m.getArgAsString(0))
+            : (m.getArgAsInt(0) != 0 ? VideoFeedbackManager::UPSCALE_LANCZOS : VideoFeedbackManager::UPSCALE_BILINEAR);
+        videoManager->setUpscaler(upscaler);
+    } else if (address == "/video/upscaleSharpness" && m.getNumArgs() >= 1) {
+        videoManager->setUpscaleSharpness(m.getArgAsFloat(0));
+    } else if (address == "/video/cpuThreads" && m.getNumArgs() >= 1) {
+        videoManager->setCpuThreads(m.getArgAsInt(0));
+    } else if (address == "/video/loopScale" && m.getNumArgs() >= 1) {
+        videoManager->setLoopScale(m.getArgAsFloat(0));
+    } else if (address == "/video/profilePasses" && m.getNumArgs() >= 1) {
+        videoManager->getRenderGraph().setFinishPasses(m.getArgAsInt(0) != 0);
+    } else if (address == "/video/validate") {
+        videoManager->validateCpuRenderer();
+    } else if (address == "/video/benchmark") {
+        videoManager->benchmarkFormats(m.getNumArgs() >= 1 ? m.getArgAsInt(0) : 60);
+    } else {
+        return false;
+    }
+    return true;
 }
 
+bool ofApp::handleMemoryOsc(const ofxOscMessage& m) {
+    // /memory/query replies to the sender with /memory/total and one /memory/subsystem per subsystem;
+    // /memory/budget <gpuMB> [cpuMB] and /memory/policy <warn|refuse|degrade> apply to later allocations
+    const std::string& address = m.getAddress();
+    if (address.compare(0, 8, "/memory/") != 0) {
+        return false;
+    }
+
+    if (address == "/memory/query") {
+        ofxOscSender reply;
+        reply.setup(m.getRemoteHost(), m.getRemotePort());
+
+        ofxOscMessage total;
+        total.setAddress("/memory/total");
+        total.addFloatArg(MemoryTracker::toMegabytes(memory->getTotal(MemoryTracker::GPU)));
+        total.addFloatArg(MemoryTracker::toMegabytes(memory->getBudget(MemoryTracker::GPU)));
+        total.addFloatArg(MemoryTracker::toMegabytes(memory->getTotal(MemoryTracker::CPU)));
+        total.addFloatArg(MemoryTracker::toMegabytes(memory->getBudget(MemoryTracker::CPU)));
+        reply.sendMessage(total, false);
+
+        for (const auto& subsystem : memory->getSubsystemTotals()) {
+            ofxOscMessage line;
+            line.setAddress("/memory/subsystem");
+            line.addStringArg(subsystem.name);
+            line.addFloatArg(MemoryTracker::toMegabytes(subsystem.bytes[MemoryTracker::GPU]));
+            line.addFloatArg(MemoryTracker::toMegabytes(subsystem.bytes[MemoryTracker::CPU]));
+            reply.sendMessage(line, false);
+        }
+    } else if (address == "/memory/budget" && m.getNumArgs() >= 1) {
+        auto megabytes = [&m](int index) {
+            ofxOscArgType type = m.getArgType(index);
+            return (type == OFXOSC_TYPE_INT32 || type == OFXOSC_TYPE_INT64) ? (float)m.getArgAsInt(index) : m.getArgAsFloat(index);
+        };
+        memory->setBudget(MemoryTracker::GPU, (size_t)(std::max(0.0f, megabytes(0)) * 1024 * 1024));
+        if (m.getNumArgs() > 1) {
+            memory->setBudget(MemoryTracker::CPU, (size_t)(std::max(0.0f, megabytes(1)) * 1024 * 1024));
+        }
+        settings->requestSave();
+    } else if (address == "/memory/policy" && m.getNumArgs() >= 1 && m.getArgType(0) == OFXOSC_TYPE_STRING) {
+        memory->setPolicy(MemoryTracker::findPolicy(m.getArgAsString(0)));
+        settings->requestSave();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ofApp::writePresetsIfChanged() {
+    PresetBank& presets = paramManager->getPresetBank();
+    if (presets.takeDirty()) {
+        settings->writeAsync(presets.getPath(), presets.serialize());
+    }
+}
+
+bool ofApp::handlePresetOsc(const ofxOscMessage& m) {
+    // /preset/recall <slot> [seconds], /preset/store <slot>, /preset/morphTime <seconds>
+    const std::string& address = m.getAddress();
+    if (address.compare(0, 8, "/preset/") != 0 || m.getNumArgs() < 1) {
+        return false;
+    }
+    auto number = [&m](int index) {
+        ofxOscArgType type = m.getArgType(index);
+        return (type == OFXOSC_TYPE_INT32 || type == OFXOSC_TYPE_INT64) ? (float)m.getArgAsInt(index) : m.getArgAsFloat(index);
+    };
+
+    if (address == "/preset/recall") {
+        int slot = (int)number(0);
+        if (m.getNumArgs() > 1) {
+            paramManager->recallPreset(slot, number(1));
+        } else {
+            paramManager->recallPreset(slot);
+        }
+    } else if (address == "/preset/store") {
+        paramManager->storePreset((int)number(0));
+    } else if (address == "/preset/morphTime") {
+        paramManager->setPresetMorphTime(number(0));
+    } else if (address == "/preset/clearPattern" && (int)number(0) == 1) {
+        paramManager->clearAllLocks(); // Needs the 1, so a stray message can't wipe a recording
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void ofApp::loadManagerSettings(ofxXmlSettings& xml) {
+    if (xml.pushTag("paramManager")) {
+        // Load VideoFeedbackManager settings if tag exists
+        if (xml.tagExists("videoFeedback")) {
+            videoManager->loadFromXml(xml);
+        }
+        // Load AudioReactivityManager settings if tag exists
+        if (xml.tagExists("audioReactivity")) {
+            audioManager->loadFromXml(xml);
+        }
+        // Load MidiManager settings if tag exists
+        if (xml.tagExists("midi")) {
+            midiManager->loadSettings(xml);
+        }
+        xml.popTag(); // Pop paramManager
+    }
+}
+
+void ofApp::writeSettings(ofxXmlSettings& xml) {
+    if (!xml.tagExists("app")) {
+        xml.addTag("app"); // Ensure app tag exists if file was missing
+    }
+
+    xml.pushTag("app");
+    xml.setValue("version", "1.0.0"); // Update version or keep existing
+    xml.setValue("lastSaved", ofGetTimestampString());
+    xml.setValue("debugEnabled", debugEnabled ? 1 : 0);
+    xml.setValue("width", ofGetWidth());
+    xml.setValue("height", ofGetHeight());
+    // xml.setValue("frameRate", (int)ofGetTargetFrameRate()); // Removed - Handled by ParameterManager save
+
+    // Save current input source
+    std::string sourceStr = "CAMERA";
+    if (currentInputSource == NDI) sourceStr = "NDI";
+    else if (currentInputSource == VIDEO_FILE) sourceStr = "VIDEO_FILE";
+    xml.setValue("videoInputSource", sourceStr);
+    xml.setValue("videoFilePath", videoFilePath);
+    xml.setValue("ndiSourceIndex", currentNdiSourceIndex); // Save NDI source index
+    // Save current NDI source name if connected
+    std::string currentNdiName = "";
+    if (ndiReceiver.ReceiverConnected()) {
+        currentNdiName = ndiReceiver.GetSenderName();
+    }
+    xml.setValue("ndiSourceName", currentNdiName);
+    memory->saveToXml(xml);
+    renderTargets->saveToXml(xml);
+
+    xml.popTag(); // pop app
+
+    // Save manager settings
+    paramManager->saveToXml(xml);
+    std::string patternPath, patternBytes;
+    if (paramManager->snapshotPatternBank(patternPath, patternBytes)) {
+        settings->writeAsync(patternPath, std::move(patternBytes)); // Unmapped bank: written on the settings worker
+    }
+    if (xml.pushTag("paramManager")) { // Push into the tag created/found by paramManager
+        audioManager->saveToXml(xml);
+        videoManager->saveToXml(xml);
+        midiManager->saveSettings(xml);
+        xml.popTag();
+    }
+}
+
+
+
 //--------------------------------------------------------------
 void ofApp::update() {
     float startTime = ofGetElapsedTimef();
+    frameWorkStartMicros = ofGetElapsedTimeMicros();
+
+    startup->update();  // Runs the next render-thread startup task, if any
+    updateMemoryAccounting();
+    settings->update(); // Starts a requested save once it has settled
+    writePresetsIfChanged();
 
     paramManager->update();
     midiManager->update();
     audioManager->update(); // Update audio manager
+    paramManager->evaluate(); // One parameter snapshot for this frame's rendering
 
     // --- Update Input Source and Process Video ---
-    if (currentInputSource == CAMERA) {
+    bool inputReady = isInputReady(); // Until then draw() shows the fallback pattern
+    if (!inputReady) {
+        // Input still starting, or it didn't open
+    } else if (currentInputSource == CAMERA) {
         videoManager->updateCamera(); // Updates internal camera and draws to aspectRatioFbo
         // Check if the camera inside videoManager is ready and its FBO has content
         if (videoManager->isCameraInitialized() && videoManager->getAspectRatioFbo().isAllocated()) { // Use public getter
@@ -294,20 +566,22 @@ void ofApp::update() {
                 ofPixels pixels;
                 videoManager->getAspectRatioFbo().readToPixels(pixels);
                 if (pixels.isAllocated()) {
-                    currentInputTexture.loadData(pixels);
+                    currentInputTexture->loadData(pixels);
+                    paramManager->getModulation().analyzeLuma(pixels); // Image sources for next frame's modulation
                 }
             }
         }
     } else if (currentInputSource == NDI) {
-        if (ndiReceiver.ReceiveImage(ndiTexture)) { // Check for new NDI frame
-             if (ndiTexture.isAllocated()) {
-                 videoManager->processMainPipeline(ndiTexture); // Use renamed public method
+        if (ndiReceiver.ReceiveImage(*ndiTexture)) { // Check for new NDI frame
+             if (ndiTexture->isAllocated()) {
+                 videoManager->processMainPipeline(*ndiTexture); // Use renamed public method
 
                  // Update debug preview texture
                  ofPixels ndiPixels;
-                 ndiTexture.readToPixels(ndiPixels);
+                 ndiTexture->readToPixels(ndiPixels);
                  if(ndiPixels.isAllocated()) {
-                    currentInputTexture.loadData(ndiPixels);
+                    currentInputTexture->loadData(ndiPixels);
+                    paramManager->getModulation().analyzeLuma(ndiPixels);
                  }
              }
         }
@@ -318,21 +592,26 @@ void ofApp::update() {
              videoManager->processMainPipeline(vidTex); // Use renamed public method
 
              // Update debug preview texture
-             currentInputTexture.loadData(videoPlayer.getPixels());
+             currentInputTexture->loadData(videoPlayer.getPixels());
+             paramManager->getModulation().analyzeLuma(videoPlayer.getPixels());
          }
     }
 
     // Increment video manager's frame index for feedback loop timing
     videoManager->incrementFrameIndex();
+    if (startup->isFinished()) {
+        videoManager->warmUpHistory(); // Delay slots ahead of the pipeline, so delay changes don't allocate
+    }
 
     // --- OSC Update ---
     while (oscReceiver.hasWaitingMessages()) {
         ofxOscMessage m;
         oscReceiver.getNextMessage(m);
         string incomingAddr = m.getAddress();
-        bool handled = false;
+        bool handled = handlePresetOsc(m) || handleMemoryOsc(m) || handleDelayOsc(m) || handleVideoOsc(m);
 
         for (const auto& paramId : paramManager->getAllParameterIds()) {
+            if (handled) break;
             std::string configuredAddr = paramManager->getOscAddress(paramId);
             if (!configuredAddr.empty() && configuredAddr == incomingAddr) {
                 if (m.getNumArgs() == 1) {
@@ -365,11 +644,12 @@ void ofApp::update() {
                             else if (paramId == "zLfoRate") paramManager->setZLfoRate(value);
                             else if (paramId == "rotateLfoAmp") paramManager->setRotateLfoAmp(value);
                             else if (paramId == "rotateLfoRate") paramManager->setRotateLfoRate(value);
+                            else if (paramId == "delayAmount") paramManager->setDelayAmount(value); // Fractional frames
                             else { ofLogWarning("ofApp::update") << "OSC: No float setter found for matched address: " << incomingAddr << " (paramId: " << paramId << ")"; }
                             handled = true;
                         } else if (m.getArgType(0) == OFXOSC_TYPE_INT32 || m.getArgType(0) == OFXOSC_TYPE_INT64) {
                             int value = m.getArgAsInt(0);
-                            if (paramId == "delayAmount") paramManager->setDelayAmount(value);
+                            if (paramId == "delayAmount") paramManager->setDelayAmount(static_cast<float>(value));
                             else { ofLogWarning("ofApp::update") << "OSC: No int setter found for matched address: " << incomingAddr << " (paramId: " << paramId << ")"; }
                              handled = true;
                         } else if (m.getArgType(0) == OFXOSC_TYPE_TRUE || m.getArgType(0) == OFXOSC_TYPE_FALSE) {
@@ -436,7 +716,7 @@ void ofApp::draw() {
 
     if (safeDrawMode) {
         try {
-            videoManager->draw();
+            if (isInputReady()) videoManager->draw(); else videoManager->drawFallback();
         } catch (const std::exception& e) {
             ofLogError("ofApp") << "Exception in videoManager->draw(): " << e.what();
             ofBackground(0); ofSetColor(255, 0, 0);
@@ -448,11 +728,16 @@ void ofApp::draw() {
         }
         drawDebugInfo();
     } else {
-        videoManager->draw();
+        if (isInputReady()) {
+            videoManager->draw();
+        } else {
+            videoManager->drawFallback();
+        }
         if (debugEnabled) {
             drawDebugInfo();
         }
     }
+    videoManager->setFrameWorkMicros(ofGetElapsedTimeMicros() - frameWorkStartMicros); // Budget for warmUpHistory()
 }
 
 void ofApp::drawDebugInfo() {
@@ -520,7 +805,7 @@ void ofApp::drawDebugInfo() {
     ofPopStyle();
 
     // --- Draw NDI Preview (in debug mode) ---
-    if (debugEnabled && currentInputSource == NDI && ndiTexture.isAllocated()) {
+    if (debugEnabled && currentInputSource == NDI && ndiTexture && ndiTexture->isAllocated()) {
         ofPushMatrix(); ofPushStyle();
         int ndiPreviewWidth = 160; int ndiPreviewHeight = 120;
         int ndiPreviewX = ofGetWidth() - ndiPreviewWidth - 20;
@@ -529,7 +814,7 @@ void ofApp::drawDebugInfo() {
         ofDrawRectangle(ndiPreviewX - 10, ndiPreviewY - 25, ndiPreviewWidth + 20, ndiPreviewHeight + 35);
         ofSetColor(255);
         ofDrawBitmapString("NDI Input:", ndiPreviewX, ndiPreviewY - 10);
-        ndiTexture.draw(ndiPreviewX, ndiPreviewY, ndiPreviewWidth, ndiPreviewHeight);
+        ndiTexture->draw(ndiPreviewX, ndiPreviewY, ndiPreviewWidth, ndiPreviewHeight);
         ofPopStyle(); ofPopMatrix();
     }
 
@@ -543,9 +828,9 @@ void ofApp::drawDebugInfo() {
     ofSetColor(255);
     ofDrawBitmapString("Input Preview:", previewX, previewY - 10);
     ofTranslate(previewX, previewY);
-    if (currentInputTexture.isAllocated()) {
+    if (currentInputTexture && currentInputTexture->isAllocated()) {
          ofSetColor(255);
-         currentInputTexture.draw(0, 0, previewWidth, previewHeight);
+         currentInputTexture->draw(0, 0, previewWidth, previewHeight);
          std::string sourceLabel = "Input: ";
          if (currentInputSource == CAMERA) sourceLabel += "Camera";
          else if (currentInputSource == NDI) sourceLabel += "NDI";
@@ -560,6 +845,9 @@ void ofApp::drawDebugInfo() {
 
 //--------------------------------------------------------------
 void ofApp::exit() {
+    // Let startup tasks that are still running finish before tearing down what they use
+    startup->stop();
+
     // Clean shutdown of audio
     audioManager->exit();
 
@@ -567,53 +855,10 @@ void ofApp::exit() {
     ndiReceiver.ReleaseReceiver();
     // No need to release finder if we didn't explicitly create it persistently
 
-    // Save settings before exiting
-    ofxXmlSettings xml;
-    if (xml.loadFile(ofToDataPath("settings.xml"))) {
-         // Preserve existing non-app settings if possible
-    } else {
-        xml.addTag("app"); // Ensure app tag exists if file was missing
-    }
-
-    xml.pushTag("app");
-    xml.setValue("version", "1.0.0"); // Update version or keep existing
-    xml.setValue("lastSaved", ofGetTimestampString());
-    xml.setValue("debugEnabled", debugEnabled ? 1 : 0);
-    xml.setValue("width", ofGetWidth());
-    xml.setValue("height", ofGetHeight());
-    // xml.setValue("frameRate", (int)ofGetTargetFrameRate()); // Removed - Handled by ParameterManager save
-
-    // Save current input source
-    std::string sourceStr = "CAMERA";
-    if (currentInputSource == NDI) sourceStr = "NDI";
-    else if (currentInputSource == VIDEO_FILE) sourceStr = "VIDEO_FILE";
-    xml.setValue("videoInputSource", sourceStr);
-    xml.setValue("videoFilePath", videoFilePath);
-    xml.setValue("ndiSourceIndex", currentNdiSourceIndex); // Save NDI source index
-    // Save current NDI source name if connected
-    std::string currentNdiName = "";
-    if (ndiReceiver.ReceiverConnected()) {
-        currentNdiName = ndiReceiver.GetSenderName();
-    }
-    xml.setValue("ndiSourceName", currentNdiName);
-
-    xml.popTag(); // pop app
-
-    // Save manager settings
-    paramManager->saveToXml(xml);
-    if (xml.pushTag("paramManager")) { // Push into the tag created/found by paramManager
-        audioManager->saveToXml(xml);
-        videoManager->saveToXml(xml);
-        midiManager->saveSettings(xml);
-        xml.popTag();
-    }
-
-    try {
-        bool saved = xml.saveFile(ofToDataPath("settings.xml"));
-        ofLogNotice("ofApp") << "Settings saved " << (saved ? "successfully" : "unsuccessfully") << " to settings.xml";
-    } catch (const std::exception& e) {
-        ofLogError("ofApp") << "Exception saving settings: " << e.what();
-    }
+    // Save settings before exiting; waits for the write to reach disk
+    writePresetsIfChanged();
+    settings->saveNow();
+    settings->stop();
 }
 
 //--------------------------------------------------------------
@@ -623,8 +868,10 @@ void ofApp::keyPressed(int key) {
 
     // Process key controls
     // Use videoManager methods for device control
-    int currentDeviceIndex = videoManager->getCurrentVideoDeviceIndex();
-    auto deviceList = videoManager->getVideoDeviceList(); // Get names
+    // Input devices belong to the startup tasks until they finish
+    bool devicesReady = startup->isFinished();
+    int currentDeviceIndex = devicesReady ? videoManager->getCurrentVideoDeviceIndex() : -1;
+    auto deviceList = devicesReady ? videoManager->getVideoDeviceList() : std::vector<std::string>(); // Get names
     int newDeviceIndex = -1; // Declare outside
 
     switch (key) {
@@ -635,6 +882,7 @@ void ofApp::keyPressed(int key) {
 
          // Video device controls (using videoManager now) / NDI Source Switching
          case '<': // ASCII value 60
+              if (!devicesReady) break;
               if (currentInputSource == NDI && !shiftPressed) {
                   // NDI Source Switching (Previous)
                   int nSources = ndiReceiver.GetSenderCount();
@@ -668,6 +916,7 @@ void ofApp::keyPressed(int key) {
              break;
 
          case '>': // ASCII value 62
+              if (!devicesReady) break;
               if (currentInputSource == NDI && !shiftPressed) {
                   // NDI Source Switching (Next)
                    int nSources = ndiReceiver.GetSenderCount();
@@ -703,6 +952,7 @@ void ofApp::keyPressed(int key) {
         // Input Source Cycling (Example: using 'I' key)
         // case 'i': // Keep lowercase 'i' separate from parameter control - This conflicts with LFO control
         case 'I': // Use uppercase 'I' only
+             if (!devicesReady) break;
              if (currentInputSource == CAMERA) {
                  currentInputSource = NDI;
                  if (videoPlayer.isPlaying()) videoPlayer.stop();
@@ -863,7 +1113,7 @@ void ofApp::keyPressed(int key) {
             break;
         case ']':
             {
-                int delay = paramManager->getDelayAmount() - 1;
+                float delay = paramManager->getDelayAmount() - 1;
                 if (delay < 0) {
                     delay = videoManager->getFrameBufferLength() - delay;
                 }
@@ -935,21 +1185,19 @@ void ofApp::keyPressed(int key) {
              // Save settings
              case 'S':
                  if (shiftPressed) {
-                     ofxXmlSettings xml;
-                     paramManager->saveToXml(xml);
-                     audioManager->saveToXml(xml);
-                     xml.saveFile(ofToDataPath("settings.xml"));
-                     ofLogNotice("ofApp") << "Settings saved to settings.xml";
+                     settings->requestSave(); // Written in the background
+                     ofLogNotice("ofApp") << "Saving settings to settings.xml";
                  }
                  break;
 
              // Load settings
              case 'L':
                  if (shiftPressed) {
-                     ofxXmlSettings xml;
-                     if (xml.loadFile(ofToDataPath("settings.xml"))) {
+                     if (settings->load()) {
+                         ofxXmlSettings& xml = settings->getDocument();
                          paramManager->loadFromXml(xml);
-                         audioManager->loadFromXml(xml);
+                         loadManagerSettings(xml);
+                         midiManager->rebuildMappings(); // Swap in the reloaded mappings
                          ofLogNotice("ofApp") << "Settings loaded from settings.xml";
                      }
                  }
@@ -1050,6 +1298,31 @@ void ofApp::drawPerformanceInfo(int x, int y, int lineHeight) {
     ofSetColor(255, 255, 0, 100);
     float y30fps = y + graphHeight - ofMap(30.0f, 0, 60.0f, 0, graphHeight, true);
     ofDrawLine(x, y30fps, x + graphWidth, y30fps);
+    y += graphHeight + lineHeight;
+
+    // Memory accounting against the configured budgets
+    auto memoryLine = [this](const std::string& label, MemoryTracker::Kind kind) {
+        size_t budget = memory->getBudget(kind);
+        std::string line = label + ofToString(MemoryTracker::toMegabytes(memory->getTotal(kind)), 1) + " MB";
+        if (budget > 0) {
+            line += " / " + ofToString(MemoryTracker::toMegabytes(budget), 0) + " MB";
+        }
+        return line;
+    };
+    ofSetColor(255, 255, 0);
+    ofDrawBitmapString(memoryLine("GPU mem: ", MemoryTracker::GPU), x, y);
+    y += lineHeight;
+    ofDrawBitmapString(memoryLine("CPU mem: ", MemoryTracker::CPU), x, y);
+    y += lineHeight;
+    for (const auto& subsystem : memory->getSubsystemTotals()) {
+        ofDrawBitmapString("  " + subsystem.name + ": " + ofToString(MemoryTracker::toMegabytes(subsystem.bytes[MemoryTracker::GPU]), 1) +
+                           " / " + ofToString(MemoryTracker::toMegabytes(subsystem.bytes[MemoryTracker::CPU]), 1) + " MB", x, y);
+        y += lineHeight;
+    }
+    const RenderTargetPool::Stats& pool = renderTargets->getStats();
+    ofDrawBitmapString("Render targets: " + ofToString(pool.live) + " live, " + ofToString(pool.idle) + " idle, " +
+                       ofToString(renderTargets->getHitRate() * 100.0f, 0) + "% reused", x, y);
+    y += lineHeight;
 }
 
 void ofApp::drawVideoInfo(int x, int y, int lineHeight) {
@@ -1067,7 +1340,10 @@ void ofApp::drawVideoInfo(int x, int y, int lineHeight) {
     y += lineHeight;
 
     // Display Camera device info if Camera is the source
-    if (currentInputSource == CAMERA) {
+    if (!isInputReady()) {
+        ofDrawBitmapString(startup->isFinished() ? "Input: not available" : "Input: starting...", x, y);
+        y += lineHeight;
+    } else if (currentInputSource == CAMERA) {
         std::string deviceName = videoManager->getCurrentVideoDeviceName(); // Use videoManager method
         if (!videoManager->isCameraInitialized()) { // Use videoManager method
             deviceName += " (Error)";
@@ -1113,10 +1389,57 @@ void ofApp::drawVideoInfo(int x, int y, int lineHeight) {
     }
 
     // Display info managed by VideoFeedbackManager
-    ofDrawBitmapString("Feedback buffer: " + ofToString(videoManager->getFrameBufferLength()) + " frames", x, y);
+    ofDrawBitmapString("Feedback buffer: " + ofToString(videoManager->getFrameBufferLength()) + " frames (" +
+                       ofToString(videoManager->getReadyHistorySlots()) + " ready, " +
+                       VideoFeedbackManager::getHistoryWarmupName(videoManager->getHistoryWarmup()) + ")", x, y);
     y += lineHeight;
 
-    ofDrawBitmapString("Delay: " + ofToString(paramManager->getDelayAmount()) + " frames", x, y);
+    if (paramManager->getDelayTimeMs() > 0.0f) {
+        ofDrawBitmapString("Delay: " + ofToString(paramManager->getDelayTimeMs(), 0) + " ms", x, y);
+    } else {
+        ofDrawBitmapString("Delay: " + ofToString(paramManager->getDelayAmount(), 2) + " frames", x, y);
+    }
+    y += lineHeight;
+    ofDrawBitmapString("Processing format: " + TextureHelper::getFormatName(videoManager->getPipelineFormat()) +
+                       (videoManager->isHdrHistoryEnabled() ? " (history too)" : ""), x, y);
+    y += lineHeight;
+    if (videoManager->isSplitResolution()) {
+        ofDrawBitmapString("Feedback loop: " + ofToString(videoManager->getProcessingWidth()) + "x" +
+                           ofToString(videoManager->getProcessingHeight()) + " of " + ofToString(videoManager->getOutputWidth()) +
+                           "x" + ofToString(videoManager->getOutputHeight()), x, y);
+        y += lineHeight;
+    }
+    if (videoManager->getBackend() == VideoFeedbackManager::BACKEND_CPU) {
+        ofDrawBitmapString("Backend: CPU (" + std::string(CpuFeedbackRenderer::getSimdName()) + ", " +
+                           ofToString(videoManager->getCpuRenderMs(), 1) + " ms)", x, y);
+        y += lineHeight;
+    } else {
+        const RenderGraph& graph = videoManager->getRenderGraph();
+        std::string passes;
+        for (const RenderGraph::PassTiming& timing : graph.getTimings()) {
+            passes += " " + timing.name + " " + (timing.state == RenderGraph::PASS_RAN ? ofToString(timing.ms, 2) :
+                                                 RenderGraph::getPassStateName(timing.state));
+        }
+        ofDrawBitmapString("Passes:" + passes + " (" + ofToString(graph.getTransientTargetCount()) + " targets" +
+                           (graph.isFinishingPasses() ? ", finished" : "") + ")", x, y);
+        y += lineHeight;
+    }
+    if (videoManager->isUpscaleActive()) {
+        ofDrawBitmapString("Upscale: " + VideoFeedbackManager::getUpscalerName(videoManager->getUpscaler()) + ", sharpness " +
+                           ofToString(videoManager->getUpscaleSharpness(), 2), x, y);
+        y += lineHeight;
+    }
+    if (videoManager->getMixerQuality() != VideoFeedbackManager::MIXER_FULL) {
+        ofDrawBitmapString("Mixer quality: " + VideoFeedbackManager::getMixerQualityName(videoManager->getMixerQuality()) +
+                           (videoManager->isCheckerboardActive() ? "" : " (inactive)"), x, y);
+        y += lineHeight;
+    }
+    if (videoManager->isFeedbackMipmapsEnabled()) {
+        ofDrawBitmapString(std::string("Feedback mipmaps: ") + (videoManager->isFeedbackMipmapActive() ? "active" : "idle (no zoom out)"), x, y);
+        y += lineHeight;
+    }
+    ofDrawBitmapString("Echo taps: " + ofToString(videoManager->getActiveEchoTaps()) + " of " +
+                       ofToString((int)VideoFeedbackManager::MAX_ECHO_TAPS), x, y);
     y += lineHeight;
 
     ofDrawBitmapString("HDMI Aspect: " + ofToString(videoManager->isHdmiAspectRatioEnabled()), x, y);
@@ -1307,6 +1630,20 @@ void ofApp::drawMidiInfo(int x, int y, int lineHeight) {
         }
     }
 
+    // Display transport (MIDI clock or internal tempo)
+    y += lineHeight; // Extra space
+    const Transport& transport = paramManager->getTransport();
+    uint64_t now = ofGetElapsedTimeMicros();
+    std::string clockLine = "Clock: " + ofToString(transport.getBpm(now), 1) + " BPM ";
+    if (transport.isClockActive(now)) {
+        clockLine += transport.isRunning() ? "(external, running)" : "(external, stopped)";
+    } else {
+        clockLine += "(internal)";
+    }
+    clockLine += " Beat: " + ofToString(transport.getBeatPosition(now), 2);
+    ofDrawBitmapString(clockLine, x, y);
+    y += lineHeight;
+
     // Display Last 4 MIDI Messages
     y += lineHeight; // Extra space
     ofDrawBitmapString("Last 4 MIDI Messages:", x, y);
@@ -1324,16 +1661,26 @@ void ofApp::drawMidiInfo(int x, int y, int lineHeight) {
             msgStr += "Ch: " + ofToString(msg.channel) + " ";
             msgStr += "St: " + ofToString(msg.status) + " "; // Status (e.g., 176 for CC)
             if (msg.status == MIDI_CONTROL_CHANGE) {
-                msgStr += "CC: " + ofToString(msg.control) + " ";
-                msgStr += "Val: " + ofToString(msg.value);
+                msgStr += "CC: " + ofToString(msg.data1) + " ";
+                msgStr += "Val: " + ofToString(msg.data2);
             } else if (msg.status == MIDI_NOTE_ON || msg.status == MIDI_NOTE_OFF) {
-                msgStr += "Note: " + ofToString(msg.pitch) + " ";
-                msgStr += "Vel: " + ofToString(msg.velocity);
+                msgStr += "Note: " + ofToString(msg.data1) + " ";
+                msgStr += "Vel: " + ofToString(msg.data2);
             } else {
-                 msgStr += "Data: " + ofToString(msg.bytes[0]) + "," + ofToString(msg.bytes[1]) + "," + ofToString(msg.bytes[2]);
+                 msgStr += "Data: " + ofToString(msg.data1) + "," + ofToString(msg.data2);
             }
             ofDrawBitmapString(msgStr, x, y);
             y += lineHeight;
         }
     }
+    size_t dropped = midiManager->getDroppedMessageCount();
+    if (dropped > 0) {
+        ofDrawBitmapString("  Dropped (queue full): " + ofToString(dropped), x, y);
+        y += lineHeight;
+    }
+    MidiFeedback& feedback = midiManager->getFeedback();
+    if (feedback.isActive()) {
+        ofDrawBitmapString("  Feedback sent: " + ofToString(feedback.getSentCount()), x, y);
+        y += lineHeight;
+    }
 }
\ No newline at end of file
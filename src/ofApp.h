@@ -11,6 +11,10 @@
 #include "ShaderManager.h"
 #include "MidiManager.h"
 #include "AudioReactivityManager.h" // Added the new header
+#include "SettingsStore.h"
+#include "StartupGraph.h"
+#include "MemoryTracker.h"
+#include "RenderTargetPool.h"
 
 /**
  * @class ofApp
@@ -56,8 +60,28 @@ private:
     
     // void setupDefaultAudioMappings(); // Removed - Logic moved to AudioReactivityManager
     void resetSettingsFile();
+    void loadManagerSettings(ofxXmlSettings& xml); // Sections inside <paramManager>
+    void writeSettings(ofxXmlSettings& xml);       // SettingsStore writer, render thread
+    void writePresetsIfChanged();                  // Background write of presets.bin after a store
+    bool handlePresetOsc(const ofxOscMessage& m);  // /preset/... messages
+    void connectNdiSource(const std::string& preferredName); // Startup worker: discover and connect
+    bool isInputReady() const;                     // Shaders and the current input have started
+    void updateMemoryAccounting();                 // CPU buffers of the audio and MIDI managers, once a second
+    bool handleMemoryOsc(const ofxOscMessage& m);  // /memory/... messages
+    bool handleDelayOsc(const ofxOscMessage& m);   // /delay/timeMs and /tap/<n>/...
+    bool handleVideoOsc(const ofxOscMessage& m);   // /video/hdr, /video/hdrHistory, /video/mipmaps, /video/loopScale, /video/mixerQuality, /video/upscaler, /video/benchmark
     
+    // Startup tasks, kept for the input-ready checks and the timeline
+    std::unique_ptr<StartupGraph> startup;
+
+    // Allocation accounting and budgets, shared with the managers
+    std::unique_ptr<MemoryTracker> memory;
+    std::unique_ptr<RenderTargetPool> renderTargets; // Shared by the pipeline and the input textures
+    float lastMemoryUpdateTime = -1.0f;
+    bool memoryReportLogged = false;
+
     // Application managers
+    std::unique_ptr<SettingsStore> settings;
     std::unique_ptr<ParameterManager> paramManager;
     std::unique_ptr<ShaderManager> shaderManager;
     std::unique_ptr<VideoFeedbackManager> videoManager;
@@ -68,12 +92,12 @@ private:
     ofxNDIreceiver ndiReceiver; // Using user-suggested type name (lowercase 'r')
     // ofxNdiFinder ndiFinder; // Reverted - Finder might not be needed if receiver handles it
     // std::vector<ofxNdiSource> ndiSources; // Reverted
-    ofTexture ndiTexture; // Texture to hold the received NDI frame (used as input)
+    std::shared_ptr<ofTexture> ndiTexture; // Texture to hold the received NDI frame (used as input)
     int currentNdiSourceIndex = 0; // Reverted - Index of the currently selected NDI source (start at 0)
     // Removed discoveredNdiSources vector - list managed internally by receiver
 
     // Texture to hold the currently selected input before processing
-    ofTexture currentInputTexture; 
+    std::shared_ptr<ofTexture> currentInputTexture; 
 
     // OSC Control
     ofxOscReceiver oscReceiver;
@@ -97,6 +121,7 @@ private:
     // Performance monitoring
     std::deque<float> frameTimeHistory;
     float lastFrameTime;
+    uint64_t frameWorkStartMicros = 0; // update() start; update() + draw() is the frame's work without the limiter
     float averageFrameTime;
     int frameCounter;
 };
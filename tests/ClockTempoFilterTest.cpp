@@ -0,0 +1,73 @@
+// Tempo estimate checks for ClockTempoFilter. No openFrameworks needed:
+//   c++ -std=c++17 -Isrc tests/ClockTempoFilterTest.cpp -o ClockTempoFilterTest && ./ClockTempoFilterTest
+
+#include "ClockTempoFilter.h"
+#include <cmath>
+#include <cstdio>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+static double intervalForBpm(double bpm) {
+    return 60000000.0 / (bpm * 24); // Microseconds per MIDI clock
+}
+
+static bool near(double interval, double bpm) {
+    return std::abs(interval - intervalForBpm(bpm)) < intervalForBpm(bpm) * 0.01;
+}
+
+static void feed(ClockTempoFilter& filter, double bpm, int clocks) {
+    for (int i = 0; i < clocks; i++) {
+        filter.addInterval(intervalForBpm(bpm));
+    }
+}
+
+static void testSteadyTempo() {
+    ClockTempoFilter filter(intervalForBpm(120));
+    feed(filter, 90, 48);
+    expect(near(filter.getInterval(), 90), "settles on a steady tempo");
+}
+
+static void testJitterIsRejected() {
+    ClockTempoFilter filter(intervalForBpm(120));
+    feed(filter, 120, 48);
+    filter.addInterval(intervalForBpm(120) * 0.1); // Doubled message
+    filter.addInterval(intervalForBpm(120) * 0.9);
+    filter.addInterval(intervalForBpm(120) * 6.0); // Port stall
+    feed(filter, 120, 1);
+    expect(near(filter.getInterval(), 120), "single outliers don't move the estimate");
+}
+
+static void testTempoJumpUp() {
+    ClockTempoFilter filter(intervalForBpm(120));
+    feed(filter, 60, 48);
+    expect(near(filter.getInterval(), 60), "starts at 60 BPM");
+    feed(filter, 250, ClockTempoFilter::TEMPO_CHANGE_INTERVALS - 1);
+    expect(near(filter.getInterval(), 60), "a short burst is still treated as jitter");
+    feed(filter, 250, ClockTempoFilter::WINDOW);
+    expect(near(filter.getInterval(), 250), "follows a jump from 60 to 250 BPM");
+}
+
+static void testTempoJumpDown() {
+    ClockTempoFilter filter(intervalForBpm(120));
+    feed(filter, 250, 48);
+    feed(filter, 50, ClockTempoFilter::TEMPO_CHANGE_INTERVALS + ClockTempoFilter::WINDOW);
+    expect(near(filter.getInterval(), 50), "follows a jump from 250 to 50 BPM");
+}
+
+int main() {
+    testSteadyTempo();
+    testJitterIsRejected();
+    testTempoJumpUp();
+    testTempoJumpDown();
+    if (failures == 0) {
+        std::printf("ClockTempoFilterTest: all passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,84 @@
+// Soft takeover checks for MidiPickup. No openFrameworks needed:
+//   c++ -std=c++17 -Isrc tests/MidiPickupTest.cpp -o MidiPickupTest && ./MidiPickupTest
+
+#include "MidiPickup.h"
+#include <cstdio>
+
+static int failures = 0;
+
+static void expect(bool condition, const char* what) {
+    if (!condition) {
+        std::printf("FAIL: %s\n", what);
+        failures++;
+    }
+}
+
+// What MidiManager does with one control change, without glide
+static bool controlChange(MidiPickup& pickup, float incoming, float& parameter) {
+    const float range = 2.0f;      // Default mapping, -1 to 1
+    const float threshold = 0.04f; // MidiManager::CONTROL_THRESHOLD
+    if (!pickup.check(incoming, parameter, range, threshold)) {
+        return false;
+    }
+    parameter = incoming;
+    pickup.noteWritten(incoming);
+    return true;
+}
+
+static void testEngagesNearCurrentValue() {
+    MidiPickup pickup;
+    float parameter = 0.0f;
+    expect(!controlChange(pickup, 0.8f, parameter), "far control is ignored");
+    expect(parameter == 0.0f, "ignored control leaves the value");
+    expect(controlChange(pickup, 0.02f, parameter), "control at the value engages");
+    expect(controlChange(pickup, 0.5f, parameter), "engaged control follows");
+    expect(parameter == 0.5f, "engaged control sets the value");
+}
+
+static void testEngagesOnCrossing() {
+    MidiPickup pickup;
+    float parameter = 0.0f;
+    expect(!controlChange(pickup, -0.5f, parameter), "below the value is ignored");
+    expect(controlChange(pickup, 0.5f, parameter), "crossing the value engages");
+}
+
+static void testExternalChangeRequiresPickupAgain() {
+    MidiPickup pickup;
+    float parameter = 0.0f;
+    controlChange(pickup, 0.0f, parameter);
+    controlChange(pickup, 0.6f, parameter);
+    expect(pickup.engaged, "engaged after following the control");
+
+    parameter = -0.7f; // Preset recall, reset, OSC or keyboard
+    expect(!controlChange(pickup, 0.62f, parameter), "next control after an external change must not jump");
+    expect(parameter == -0.7f, "external value is kept");
+    expect(!controlChange(pickup, 0.3f, parameter), "still ignored on the same side");
+    expect(controlChange(pickup, -0.72f, parameter), "picks up again at the new value");
+    expect(controlChange(pickup, 0.1f, parameter), "then follows again");
+}
+
+static void testGlideStepsAreOwnWrites() {
+    MidiPickup pickup;
+    float parameter = 0.0f;
+    controlChange(pickup, 0.0f, parameter);
+
+    // A glide moves the value in steps, each noted as MIDI's own
+    float target = 0.5f;
+    expect(pickup.check(target, parameter, 2.0f, 0.04f), "engaged control starts a glide");
+    for (int i = 0; i < 3; i++) {
+        parameter += (target - parameter) * 0.5f;
+        pickup.noteWritten(parameter);
+    }
+    expect(pickup.check(0.55f, parameter, 2.0f, 0.04f), "glide steps don't release the pickup");
+}
+
+int main() {
+    testEngagesNearCurrentValue();
+    testEngagesOnCrossing();
+    testExternalChangeRequiresPickupAgain();
+    testGlideStepsAreOwnWrites();
+    if (failures == 0) {
+        std::printf("MidiPickupTest: all passed\n");
+    }
+    return failures == 0 ? 0 : 1;
+}